@@ -18,6 +18,7 @@ option(ENABLE_COMPRESSED_DEBUG_INFO     "Compress debug info to reduce binary si
 option(ENABLE_CLANG_TIDY                "Enable clang-tidy if present" OFF)
 option(ENABLE_GDB_SCRIPT_SECTION        "Add .debug_gdb_scripts section" OFF)
 option(DISABLE_CXX11_ABI                "Whether to disable cxx11 abi" OFF)
+option(ENABLE_COMPACT_VALUE             "Share string payloads between copies of a Value" OFF)
 
 get_cmake_property(variable_list VARIABLES)
 foreach(_varname ${variable_list})
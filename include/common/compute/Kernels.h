@@ -0,0 +1,89 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+
+namespace nebula {
+class ClientRuntime;
+
+namespace compute {
+
+// Multi-threaded kernels to post-process a DataSet on the client side.
+//
+// Work is split into one partition per thread, either by row ranges or by the
+// hash of the keys, so the threads don't share any mutable state. Small inputs
+// run on the calling thread. dedup, groupBy and hashJoin compare the values by
+// hashEqual, so the numbers are equal only if they're the same, e.g. 1 and
+// 1.0 but not 0.1 + 0.2 and 0.3 as by operator==.
+
+struct KernelOptions {
+  // 0 means std::thread::hardware_concurrency(), or the workers of runtime_
+  // and the calling thread if it has any
+  std::size_t threads_{0};
+  // Don't start another thread for less rows than this
+  std::size_t minRowsPerThread_{4096};
+  // Run on the workers of the runtime instead of starting threads, see
+  // ClientRuntime::runWorkers. Not owned, nullptr for none.
+  ClientRuntime* runtime_{nullptr};
+};
+
+struct SortKey {
+  std::size_t column;
+  bool ascending{true};
+};
+
+// Sort the rows by the given keys, or by the whole row (as Row::operator<)
+// when keys is empty. Rows with equal keys keep no particular order.
+void sort(DataSet* ds, const std::vector<SortKey>& keys = {}, const KernelOptions& opts = {});
+
+// Remove the duplicated rows, the first one of them is kept and the order of
+// rows is preserved. Return the number of rows removed.
+std::size_t dedup(DataSet* ds, const KernelOptions& opts = {});
+
+enum class AggFunc {
+  // Number of rows in the group
+  COUNT_ALL,
+  // Number of non-null values
+  COUNT,
+  SUM,
+  MIN,
+  MAX,
+  AVG,
+};
+
+struct Aggregate {
+  AggFunc func;
+  // Ignored by COUNT_ALL
+  std::size_t column{0};
+  // Name of the output column
+  std::string name;
+};
+
+// Group the rows by the key columns and aggregate each group. The output has
+// the key columns followed by one column per aggregate, in no particular row
+// order. Null and empty values are ignored by all aggregates but COUNT_ALL,
+// the aggregate of a group without any value is null (0 for the COUNTs).
+DataSet groupBy(const DataSet& ds,
+                const std::vector<std::size_t>& keys,
+                const std::vector<Aggregate>& aggs,
+                const KernelOptions& opts = {});
+
+// Inner equi-join, the right side is used to build the hash table. The output
+// has all columns of left followed by all columns of right, and keeps the
+// order of left. Rows with a null or empty key never match.
+DataSet hashJoin(const DataSet& left,
+                 const DataSet& right,
+                 const std::vector<std::size_t>& leftKeys,
+                 const std::vector<std::size_t>& rightKeys,
+                 const KernelOptions& opts = {});
+
+}  // namespace compute
+}  // namespace nebula
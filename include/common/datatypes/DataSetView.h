@@ -0,0 +1,309 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/Date.h"
+#include "common/datatypes/List.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+
+// Maps a C++ type to the Value accessors of the matching Value type
+template <typename T>
+struct ValueTraits;
+
+#define NEBULA_VALUE_TRAITS(TYPE, IS, GET)        \
+  template <>                                     \
+  struct ValueTraits<TYPE> {                      \
+    static bool is(const Value& v) {              \
+      return v.IS();                              \
+    }                                             \
+    static const TYPE& get(const Value& v) {      \
+      return v.GET();                             \
+    }                                             \
+  };
+
+NEBULA_VALUE_TRAITS(bool, isBool, getBool)
+NEBULA_VALUE_TRAITS(int64_t, isInt, getInt)
+NEBULA_VALUE_TRAITS(double, isFloat, getFloat)
+NEBULA_VALUE_TRAITS(std::string, isStr, getStr)
+NEBULA_VALUE_TRAITS(Date, isDate, getDate)
+NEBULA_VALUE_TRAITS(Time, isTime, getTime)
+NEBULA_VALUE_TRAITS(DateTime, isDateTime, getDateTime)
+NEBULA_VALUE_TRAITS(Vertex, isVertex, getVertex)
+NEBULA_VALUE_TRAITS(Edge, isEdge, getEdge)
+NEBULA_VALUE_TRAITS(Path, isPath, getPath)
+NEBULA_VALUE_TRAITS(List, isList, getList)
+NEBULA_VALUE_TRAITS(Map, isMap, getMap)
+NEBULA_VALUE_TRAITS(Set, isSet, getSet)
+NEBULA_VALUE_TRAITS(DataSet, isDataSet, getDataSet)
+NEBULA_VALUE_TRAITS(Geography, isGeography, getGeography)
+NEBULA_VALUE_TRAITS(Duration, isDuration, getDuration)
+
+#undef NEBULA_VALUE_TRAITS
+
+template <>
+struct ValueTraits<Value> {
+  static bool is(const Value&) {
+    return true;
+  }
+  static const Value& get(const Value& v) {
+    return v;
+  }
+};
+
+// A non-owning view of one column of a DataSet, the values are accessed in
+// place. It's only valid as long as the rows it's built on are alive and not
+// resized.
+template <typename T>
+class ColumnView {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator(const Row* row, std::size_t index) : row_(row), index_(index) {}
+
+    reference operator*() const {
+      return ValueTraits<T>::get(row_->values[index_]);
+    }
+
+    pointer operator->() const {
+      return &ValueTraits<T>::get(row_->values[index_]);
+    }
+
+    const_iterator& operator++() {
+      ++row_;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto tmp = *this;
+      ++row_;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& rhs) const {
+      return row_ == rhs.row_;
+    }
+
+    bool operator!=(const const_iterator& rhs) const {
+      return row_ != rhs.row_;
+    }
+
+   private:
+    const Row* row_;
+    std::size_t index_;
+  };
+
+  ColumnView() = default;
+  ColumnView(const std::vector<Row>* rows, std::size_t index) : rows_(rows), index_(index) {}
+
+  // False if the column doesn't exist
+  bool valid() const {
+    return rows_ != nullptr;
+  }
+
+  std::size_t size() const {
+    return rows_ == nullptr ? 0 : rows_->size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  const Value& value(std::size_t i) const {
+    return (*rows_)[i].values[index_];
+  }
+
+  bool isNull(std::size_t i) const {
+    return value(i).isNull();
+  }
+
+  // Whether the i-th value holds a T
+  bool is(std::size_t i) const {
+    return ValueTraits<T>::is(value(i));
+  }
+
+  // Unchecked access, the caller should make sure the value holds a T
+  const T& operator[](std::size_t i) const {
+    return ValueTraits<T>::get(value(i));
+  }
+
+  // nullptr if the i-th value doesn't hold a T, e.g. it's null
+  const T* get(std::size_t i) const {
+    const auto& v = value(i);
+    return ValueTraits<T>::is(v) ? &ValueTraits<T>::get(v) : nullptr;
+  }
+
+  // Whether all values hold a T
+  bool allOf() const {
+    for (std::size_t i = 0; i < size(); ++i) {
+      if (!is(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Type checked bulk extraction, fails without touching out when any value
+  // doesn't hold a T
+  bool extract(std::vector<T>* out) const {
+    if (!allOf()) {
+      return false;
+    }
+    out->reserve(out->size() + size());
+    for (std::size_t i = 0; i < size(); ++i) {
+      out->emplace_back((*this)[i]);
+    }
+    return true;
+  }
+
+  // Same as above, but into a caller provided buffer of n elements, n must be
+  // the size of the column
+  bool extract(T* out, std::size_t n) const {
+    if (n != size() || !allOf()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = (*this)[i];
+    }
+    return true;
+  }
+
+  // Iterating requires every value to hold a T, check with allOf() first
+  const_iterator begin() const {
+    return const_iterator(rows_ == nullptr ? nullptr : rows_->data(), index_);
+  }
+
+  const_iterator end() const {
+    return const_iterator(rows_ == nullptr ? nullptr : rows_->data() + rows_->size(), index_);
+  }
+
+ private:
+  const std::vector<Row>* rows_{nullptr};
+  std::size_t index_{0};
+};
+
+class DataSetView;
+
+// A non-owning view of one row, columns can be looked up by name through the
+// index of the DataSetView it comes from.
+class RowView {
+ public:
+  RowView(const Row* row, const DataSetView* view) : row_(row), view_(view) {}
+
+  std::size_t size() const {
+    return row_->size();
+  }
+
+  const Value& operator[](std::size_t i) const {
+    return row_->values[i];
+  }
+
+  // Value::kEmpty if there is no such column
+  const Value& operator[](const std::string& colName) const;
+
+  // nullptr if there is no such column or the value doesn't hold a T
+  template <typename T>
+  const T* get(const std::string& colName) const {
+    const auto& v = (*this)[colName];
+    return ValueTraits<T>::is(v) ? &ValueTraits<T>::get(v) : nullptr;
+  }
+
+  const Row& row() const {
+    return *row_;
+  }
+
+ private:
+  const Row* row_;
+  const DataSetView* view_;
+};
+
+// Non-owning accessors of a DataSet. The name to index map of the columns is
+// built once on construction, so looking up columns doesn't scan colNames and
+// nothing is copied. The DataSet must outlive the view and its columns must
+// not be changed meanwhile.
+class DataSetView {
+ public:
+  explicit DataSetView(const DataSet& ds) : ds_(&ds) {
+    index_.reserve(ds.colNames.size());
+    for (std::size_t i = 0; i < ds.colNames.size(); ++i) {
+      // Keep the first one of duplicated names, as colValues does
+      index_.emplace(ds.colNames[i], i);
+    }
+  }
+
+  const DataSet& dataSet() const {
+    return *ds_;
+  }
+
+  std::size_t rowSize() const {
+    return ds_->rowSize();
+  }
+
+  std::size_t colSize() const {
+    return ds_->colSize();
+  }
+
+  // -1 if there is no such column
+  int64_t colIndex(const std::string& colName) const {
+    auto it = index_.find(colName);
+    return it == index_.end() ? -1 : static_cast<int64_t>(it->second);
+  }
+
+  bool hasColumn(const std::string& colName) const {
+    return index_.find(colName) != index_.end();
+  }
+
+  // An invalid view if there is no such column
+  template <typename T = Value>
+  ColumnView<T> column(const std::string& colName) const {
+    auto it = index_.find(colName);
+    if (it == index_.end()) {
+      return ColumnView<T>();
+    }
+    return ColumnView<T>(&ds_->rows, it->second);
+  }
+
+  template <typename T = Value>
+  ColumnView<T> column(std::size_t index) const {
+    if (index >= ds_->colSize()) {
+      return ColumnView<T>();
+    }
+    return ColumnView<T>(&ds_->rows, index);
+  }
+
+  RowView row(std::size_t i) const {
+    return RowView(&ds_->rows[i], this);
+  }
+
+ private:
+  const DataSet* ds_;
+  std::unordered_map<std::string, std::size_t> index_;
+};
+
+inline const Value& RowView::operator[](const std::string& colName) const {
+  auto index = view_->colIndex(colName);
+  if (index < 0 || static_cast<std::size_t>(index) >= row_->size()) {
+    return Value::kEmpty;
+  }
+  return row_->values[index];
+}
+
+}  // namespace nebula
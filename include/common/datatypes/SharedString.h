@@ -0,0 +1,121 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace nebula {
+
+// A pointer sized, reference counted string payload used by the compact Value
+// layout (NEBULA_COMPACT_VALUE). Copying only bumps the reference count, the
+// buffer is duplicated lazily when a shared payload is about to be mutated.
+//
+// Once a mutable reference has been handed out the payload is marked
+// unshareable, so later copies always deep copy and can't observe writes made
+// through that reference (the same rule the old COW std::string followed).
+class SharedString final {
+ public:
+  SharedString() = default;
+
+  explicit SharedString(std::string&& str) : rep_(new Rep(std::move(str))) {}
+
+  explicit SharedString(const std::string& str) : rep_(new Rep(str)) {}
+
+  SharedString(const SharedString& rhs) : rep_(rhs.share()) {}
+
+  SharedString(SharedString&& rhs) noexcept : rep_(rhs.rep_) {
+    rhs.rep_ = nullptr;
+  }
+
+  SharedString& operator=(const SharedString& rhs) {
+    if (this != &rhs) {
+      release();
+      rep_ = rhs.share();
+    }
+    return *this;
+  }
+
+  SharedString& operator=(SharedString&& rhs) noexcept {
+    if (this != &rhs) {
+      release();
+      rep_ = rhs.rep_;
+      rhs.rep_ = nullptr;
+    }
+    return *this;
+  }
+
+  ~SharedString() {
+    release();
+  }
+
+  const std::string& operator*() const {
+    return rep_->str;
+  }
+
+  const std::string* operator->() const {
+    return &rep_->str;
+  }
+
+  // Detach from other owners and return a writable reference
+  std::string& mutableRef() {
+    if (rep_->refs.load(std::memory_order_acquire) != 1) {
+      auto* copy = new Rep(rep_->str);
+      release();
+      rep_ = copy;
+    }
+    rep_->shareable = false;
+    return rep_->str;
+  }
+
+  // Move the string out if we are the only owner, otherwise copy it
+  std::string take() {
+    std::string str = rep_->refs.load(std::memory_order_acquire) == 1 ? std::move(rep_->str)
+                                                                       : rep_->str;
+    release();
+    return str;
+  }
+
+  bool unique() const {
+    return rep_ != nullptr && rep_->refs.load(std::memory_order_acquire) == 1;
+  }
+
+ private:
+  struct Rep {
+    explicit Rep(std::string&& s) : str(std::move(s)) {}
+    explicit Rep(const std::string& s) : str(s) {}
+
+    std::atomic<uint32_t> refs{1};
+    bool shareable{true};
+    std::string str;
+  };
+
+  Rep* share() const {
+    if (rep_ == nullptr) {
+      return nullptr;
+    }
+    if (!rep_->shareable) {
+      return new Rep(rep_->str);
+    }
+    rep_->refs.fetch_add(1, std::memory_order_relaxed);
+    return rep_;
+  }
+
+  void release() {
+    if (rep_ != nullptr && rep_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete rep_;
+    }
+    rep_ = nullptr;
+  }
+
+  Rep* rep_{nullptr};
+};
+
+static_assert(sizeof(SharedString) == sizeof(void*), "SharedString should be pointer sized");
+
+}  // namespace nebula
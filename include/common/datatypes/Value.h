@@ -10,6 +10,9 @@
 #include "common/datatypes/Date.h"
 #include "common/datatypes/Duration.h"
 #include "common/thrift/ThriftTypes.h"
+#ifdef NEBULA_COMPACT_VALUE
+#include "common/datatypes/SharedString.h"
+#endif
 
 namespace apache {
 namespace thrift {
@@ -350,6 +353,13 @@ struct Value {
   Value equal(const Value& v) const;
 
  private:
+#ifdef NEBULA_COMPACT_VALUE
+  // Copies of a string value share one buffer until either side mutates it
+  using StrPayload = SharedString;
+#else
+  using StrPayload = std::unique_ptr<std::string>;
+#endif
+
   Type type_;
 
   union Storage {
@@ -357,7 +367,7 @@ struct Value {
     bool bVal;
     int64_t iVal;
     double fVal;
-    std::unique_ptr<std::string> sVal;
+    StrPayload sVal;
     Date dVal;
     Time tVal;
     DateTime dtVal;
@@ -396,7 +406,8 @@ struct Value {
   void setS(const std::string& v);
   void setS(std::string&& v);
   void setS(const char* v);
-  void setS(std::unique_ptr<std::string> v);
+  void setS(const StrPayload& v);
+  void setS(StrPayload&& v);
   // Date value
   void setD(const Date& v);
   void setD(Date&& v);
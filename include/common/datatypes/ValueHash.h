@@ -0,0 +1,66 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/datatypes/List.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+
+using Row = List;
+
+// Hashing of Value for large hash tables, std::hash<Value> is implemented by
+// hashValue. 1 and 1.0 hash the same, but the hash doesn't agree with
+// operator==, which takes the numbers within kEpsilon of each other as equal,
+// as no hash can. Hash tables keyed by Value compare the keys by hashEqual.
+
+static constexpr uint64_t kHashSeed = 0x9e3779b97f4a7c15ULL;
+
+// The finalizer of MurmurHash3, every input bit affects every output bit
+inline uint64_t hashMix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Order dependent, hashCombine(a, b) != hashCombine(b, a)
+inline uint64_t hashCombine(uint64_t seed, uint64_t h) {
+  return seed ^ (h + kHashSeed + (seed << 6) + (seed >> 2));
+}
+
+uint64_t hashValue(const Value& v);
+
+// The equality of hashValue: as operator==, but an INT and a FLOAT are equal
+// only if they're the same number, as are two FLOATs, NaN equals NaN. The
+// values in lists and data sets are compared the same way, the other nested
+// values by operator==.
+bool hashEqual(const Value& lhs, const Value& rhs);
+
+bool hashEqualRows(const Row& lhs, const Row& rhs);
+
+// Hash of all values of the row
+uint64_t hashRow(const Row& row);
+
+// Hash of the given columns of the row
+uint64_t hashRow(const Row& row, const std::vector<std::size_t>& columns);
+
+// Batch versions of hashRow, hashes[i] is the hash of rows[i]. Hashing the
+// given columns is done one column at a time, so all rows take the same
+// branch for a column of one type.
+void hashRows(const Row* rows, std::size_t n, uint64_t* hashes);
+void hashRows(const Row* rows,
+              std::size_t n,
+              const std::vector<std::size_t>& columns,
+              uint64_t* hashes);
+
+}  // namespace nebula
@@ -0,0 +1,33 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/datatypes/List.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+
+// Order preserving binary keys of Value: for two values a and b of supported
+// types, a < b implies memcmp(key(a), key(b)) < 0. So a sort or a join can
+// compare the keys bytewise instead of dispatching on the types.
+//
+// Each value starts with a tag byte which follows the order of the types,
+// INT and FLOAT share one tag and are compared as double like operator< does.
+// The keys are prefix free, so keys of several values can be concatenated to
+// build the key of a row. Vertex, edge, path, map, set, data set, geography
+// and duration aren't supported.
+
+// Append the key of v to key, false if the type isn't supported. The key of
+// a descending value is the bitwise inverse of the ascending one.
+bool appendSortKey(const Value& v, std::string* key, bool descending = false);
+
+// Append the key of all values, the result follows the order of Row::operator<
+bool appendSortKey(const std::vector<Value>& values, std::string* key, bool descending = false);
+
+}  // namespace nebula
@@ -0,0 +1,136 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+#include "common/graph/Response.h"
+
+namespace folly {
+class IOBuf;
+}  // namespace folly
+
+namespace nebula {
+
+// An execution response which keeps the serialized reply of graphd.
+//
+// The small header fields (error code, latency, space name, error message and
+// comment) are decoded on construction, the data set and the plan description
+// are only skipped over and decoded when they're first accessed. When only a
+// few columns are needed, data(columns) decodes those and skips the others on
+// the wire.
+//
+// It's not thread safe, the accessors may decode and cache on first use.
+class LazyExecutionResponse {
+ public:
+  LazyExecutionResponse() = default;
+  // The serialized reply of GraphService.execute and the protocol it's encoded with
+  LazyExecutionResponse(std::unique_ptr<folly::IOBuf> buf, uint16_t protocolId);
+  // A response which failed before reaching graphd
+  LazyExecutionResponse(ErrorCode errorCode, const std::string &errorMsg);
+
+  LazyExecutionResponse(const LazyExecutionResponse &) = delete;
+  LazyExecutionResponse &operator=(const LazyExecutionResponse &) = delete;
+  LazyExecutionResponse(LazyExecutionResponse &&) noexcept;
+  LazyExecutionResponse &operator=(LazyExecutionResponse &&) noexcept;
+
+  ~LazyExecutionResponse();
+
+  ErrorCode errorCode() const {
+    return errorCode_;
+  }
+
+  int64_t latencyInUs() const {
+    return latencyInUs_;
+  }
+
+  const std::string *spaceName() const {
+    return spaceName_.get();
+  }
+
+  const std::string *errorMsg() const {
+    return errorMsg_.get();
+  }
+
+  const std::string *comment() const {
+    return comment_.get();
+  }
+
+  bool hasData() const {
+    return hasData_;
+  }
+
+  bool hasPlanDesc() const {
+    return hasPlanDesc_;
+  }
+
+  // Column names of the data set, the rows are left undecoded
+  const std::vector<std::string> &colNames();
+
+  // The whole data set, nullptr if the response carries none
+  const DataSet *data();
+
+  // Only the given columns in the given order, unknown names are ignored and a
+  // name given twice yields two columns. The result doesn't depend on whether
+  // data() was called before. Values of the other columns are skipped without
+  // being decoded.
+  DataSet data(const std::vector<std::string> &columns);
+
+  // The plan description, nullptr if the response carries none
+  const PlanDescription *planDesc();
+
+  // Decode everything left into a plain ExecutionResponse
+  ExecutionResponse toExecutionResponse() &&;
+
+ private:
+  void decodeHeader();
+
+  template <class Protocol>
+  void readHeader(Protocol *proto);
+
+  template <class Protocol>
+  void readDataSet(Protocol *proto, DataSet *ds);
+
+  template <class Protocol>
+  void readColNames(Protocol *proto, std::vector<std::string> *colNames);
+
+  template <class Protocol>
+  void readColumns(Protocol *proto, const std::vector<std::string> &columns, DataSet *ds);
+
+  template <class Protocol>
+  void readPlanDesc(Protocol *proto, PlanDescription *planDesc);
+
+  // Run reader on a protocol positioned at offset of the retained buffer
+  template <class Reader>
+  void readAt(std::size_t offset, Reader &&reader);
+
+  void setDecodeError(const std::string &what);
+
+  std::unique_ptr<folly::IOBuf> buf_;
+  uint16_t protocolId_{0};
+
+  ErrorCode errorCode_{ErrorCode::SUCCEEDED};
+  int64_t latencyInUs_{0};
+  std::unique_ptr<std::string> spaceName_;
+  std::unique_ptr<std::string> errorMsg_;
+  std::unique_ptr<std::string> comment_;
+
+  // Where the data set and the plan description start in buf_
+  bool hasData_{false};
+  std::size_t dataOffset_{0};
+  bool hasPlanDesc_{false};
+  std::size_t planDescOffset_{0};
+
+  std::unique_ptr<std::vector<std::string>> colNames_;
+  std::unique_ptr<DataSet> data_;
+  std::unique_ptr<PlanDescription> planDesc_;
+};
+
+}  // namespace nebula
@@ -0,0 +1,84 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace folly {
+class CPUThreadPoolExecutor;
+class EventBase;
+class IOThreadPoolExecutor;
+}  // namespace folly
+
+namespace nebula {
+
+// The threads of the clients: the event loops of their connections, and the
+// workers of the requests they split to run in parallel, e.g. a scan of a
+// whole space. A runtime passed to the meta, storage and graph clients, by
+// MConfig, SConfig and Config, is shared by them, so the threads of the
+// process are those of its runtimes. A client not given one makes its own.
+// The clients using a runtime must be destroyed before it.
+
+struct RuntimeConfig {
+  // Threads of the event loops, 0 for one per core
+  int32_t ioThreads_{0};
+  // Threads of the workers, 0 to start threads for each request instead.
+  // The thread calling a request always works on it too, so it's never
+  // blocked by the workers of other requests.
+  int32_t cpuThreads_{0};
+  // The threads are named by the prefix and their index, e.g. "nebula-io-0"
+  std::string ioThreadName_{"nebula-io-"};
+  std::string cpuThreadName_{"nebula-cpu-"};
+  // Pin the threads to these CPUs in turn, not pinned if empty. It's only
+  // supported on Linux.
+  std::vector<int32_t> ioCpus_;
+  std::vector<int32_t> cpuCpus_;
+};
+
+class ClientRuntime {
+ public:
+  explicit ClientRuntime(const RuntimeConfig& config = RuntimeConfig{});
+
+  // Join the threads after the work queued is done
+  ~ClientRuntime();
+
+  ClientRuntime(const ClientRuntime&) = delete;
+  ClientRuntime& operator=(const ClientRuntime&) = delete;
+
+  const RuntimeConfig& config() const {
+    return config_;
+  }
+
+  const std::shared_ptr<folly::IOThreadPoolExecutor>& ioExecutor() const {
+    return ioExecutor_;
+  }
+
+  // nullptr if cpuThreads_ is 0
+  const std::shared_ptr<folly::CPUThreadPoolExecutor>& cpuExecutor() const {
+    return cpuExecutor_;
+  }
+
+  // The event loop of the next IO thread, in turn
+  folly::EventBase* eventBase() const;
+
+  // Run worker on the calling thread and on concurrency - 1 workers, and
+  // return when those which started are done. worker is to return once
+  // there is nothing left to do, the workers starting after that don't run
+  // it at all.
+  void runWorkers(std::size_t concurrency, const std::function<void()>& worker);
+
+ private:
+  RuntimeConfig config_;
+  std::shared_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::shared_ptr<folly::CPUThreadPoolExecutor> cpuExecutor_;
+};
+
+}  // namespace nebula
@@ -6,8 +6,11 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "common/runtime/ClientRuntime.h"
+
 namespace nebula {
 
 struct Config {
@@ -17,6 +20,8 @@ struct Config {
   std::uint32_t minConnectionPoolSize_{0};
   std::string CAPath_;
   bool enableSSL_{false};
+  // The event loops of the connections, nullptr for a thread of each
+  std::shared_ptr<ClientRuntime> runtime_;
 };
 
 }  // namespace nebula
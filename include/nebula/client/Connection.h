@@ -10,9 +10,12 @@
 #include <string>
 
 #include "common/datatypes/Value.h"
+#include "common/graph/LazyExecutionResponse.h"
 #include "common/graph/Response.h"
+#include "common/runtime/ClientRuntime.h"
 
 namespace folly {
+class EventBase;
 class ScopedEventBaseThread;
 }
 
@@ -30,7 +33,10 @@ class Connection {
   using ExecuteCallback = std::function<void(ExecutionResponse &&)>;
   using ExecuteJsonCallback = std::function<void(std::string &&)>;
 
+  // Run on a thread of its own
   Connection();
+  // Run on an event loop of runtime, or on a thread of its own if nullptr
+  explicit Connection(std::shared_ptr<ClientRuntime> runtime);
   // disable copy
   Connection(const Connection &) = delete;
   Connection &operator=(const Connection &c) = delete;
@@ -41,6 +47,10 @@ class Connection {
 
     clientLoopThread_ = c.clientLoopThread_;
     c.clientLoopThread_ = nullptr;
+
+    evb_ = c.evb_;
+    c.evb_ = nullptr;
+    runtime_ = std::move(c.runtime_);
   }
 
   Connection &operator=(Connection &&c);
@@ -59,6 +69,9 @@ class Connection {
 
   void asyncExecute(int64_t sessionId, const std::string &stmt, ExecuteCallback cb);
 
+  // Keep the reply serialized and decode the data set only when it's accessed
+  LazyExecutionResponse executeLazy(int64_t sessionId, const std::string &stmt);
+
   ExecutionResponse executeWithParameter(int64_t sessionId,
                                          const std::string &stmt,
                                          const std::unordered_map<std::string, Value> &parameters);
@@ -94,6 +107,9 @@ class Connection {
  private:
   graph::cpp2::GraphServiceAsyncClient *client_{nullptr};
   folly::ScopedEventBaseThread *clientLoopThread_{nullptr};
+  // The event loop of clientLoopThread_ or of runtime_
+  folly::EventBase *evb_{nullptr};
+  std::shared_ptr<ClientRuntime> runtime_;
 };
 
 }  // namespace nebula
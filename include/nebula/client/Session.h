@@ -64,6 +64,8 @@ class Session {
 
   void asyncExecute(const std::string &stmt, ExecuteCallback cb);
 
+  LazyExecutionResponse executeLazy(const std::string &stmt);
+
   ExecutionResponse executeWithParameter(const std::string &stmt,
                                          const std::unordered_map<std::string, Value> &parameters);
 
@@ -30,6 +30,8 @@ struct SessionPoolConfig {
   std::uint32_t maxSize_{10};  // max size of the session pool. should be adjusted according to the
                                // max threads will be using.
   std::uint32_t minSize_{1};   // min size of  the session pool
+  // The event loops of the connections, nullptr for a thread of each
+  std::shared_ptr<ClientRuntime> runtime_;
 };
 
 class SessionPool {
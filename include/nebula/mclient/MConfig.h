@@ -6,8 +6,11 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "common/runtime/ClientRuntime.h"
+
 namespace nebula {
 
 struct MConfig {
@@ -17,6 +20,8 @@ struct MConfig {
   int32_t clientTimeoutInMs_{60 * 1000};
   bool enableSSL_{false};
   std::string CAPath_;
+  // The threads of the client, nullptr for its own
+  std::shared_ptr<ClientRuntime> runtime_;
 };
 
 }  // namespace nebula
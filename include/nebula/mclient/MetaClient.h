@@ -5,8 +5,11 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -52,14 +55,51 @@ class IdName;
 class EdgeItem;
 class ListEdgesReq;
 class ListEdgesResp;
+class TagItem;
+class IndexItem;
 
 }  // namespace cpp2
 }  // namespace meta
 
 using SpaceIdName = std::pair<GraphSpaceID, std::string>;
+
+// What's needed to locate the vids of a space
+struct SpaceInfo {
+  int32_t partNum_{0};
+  // INT64 or FIXED_STRING vids
+  bool intVid_{false};
+  // The length of the FIXED_STRING vids
+  int32_t vidLength_{0};
+};
+
+// What's needed to look up an index of a space
+struct IndexInfo {
+  IndexID id_{0};
+  // Of an edge or of a tag
+  bool isEdge_{false};
+  // The EdgeType or the TagID of the schema indexed
+  int32_t schemaId_{0};
+  std::string schemaName_;
+  // The indexed properties, in the order of the index
+  std::vector<std::string> fields_;
+};
+
+// A tag or an edge of a space, with the properties of its latest schema in
+// their order
+struct SchemaInfo {
+  // The TagID or the EdgeType
+  int32_t id_{0};
+  std::string name_;
+  std::vector<std::string> props_;
+};
+
 using SpaceNameIdMap = std::unordered_map<std::string, GraphSpaceID>;
 using SpaceEdgeNameTypeMap =
     std::unordered_map<std::pair<GraphSpaceID, std::string>, EdgeType, pair_hash>;
+using SpaceTagNameIdMap =
+    std::unordered_map<std::pair<GraphSpaceID, std::string>, TagID, pair_hash>;
+using SpaceIndexNameInfoMap =
+    std::unordered_map<std::pair<GraphSpaceID, std::string>, IndexInfo, pair_hash>;
 
 class MetaClient {
  public:
@@ -73,18 +113,48 @@ class MetaClient {
   std::pair<bool, EdgeType> getEdgeTypeByNameFromCache(GraphSpaceID spaceId,
                                                        const std::string &name);
 
+  std::pair<bool, TagID> getTagIdByNameFromCache(GraphSpaceID spaceId, const std::string &name);
+
   std::pair<bool, std::vector<PartitionID>> getPartsFromCache(GraphSpaceID spaceId);
 
+  std::pair<bool, SpaceInfo> getSpaceInfoFromCache(GraphSpaceID spaceId);
+
+  // The edges or the tags of the space, as they were when the client was
+  // made
+  std::pair<bool, std::vector<SchemaInfo>> getEdgeSchemasFromCache(GraphSpaceID spaceId);
+
+  std::pair<bool, std::vector<SchemaInfo>> getTagSchemasFromCache(GraphSpaceID spaceId);
+
+  // The tag index or the edge index of the name
+  std::pair<bool, IndexInfo> getIndexFromCache(GraphSpaceID spaceId, const std::string &name);
+
   std::pair<bool, HostAddr> getPartLeaderFromCache(GraphSpaceID spaceId, PartitionID partId);
 
+  // Set the leader of a part, e.g. by the hint of E_LEADER_CHANGED
+  void updateLeader(GraphSpaceID spaceId, PartitionID partId, const HostAddr &leader);
+
+  // Reload the leaders of all parts from meta, the parts not listed with a
+  // leader keep theirs. The callers during a refresh wait for it and share
+  // its result.
+  bool refreshLeaders();
+
  private:
   bool loadData();
 
+  // The edges and tags of the space with their latest schemas
+  std::pair<bool, std::vector<meta::cpp2::EdgeItem>> listEdgeSchemas(GraphSpaceID spaceId);
+
+  std::pair<bool, std::vector<meta::cpp2::TagItem>> listTagSchemas(GraphSpaceID spaceId);
+
   std::pair<bool, std::vector<SpaceIdName>> listSpaces();
 
-  std::pair<bool, std::vector<meta::cpp2::HostItem>> listHosts(meta::cpp2::ListHostType tp);
+  std::pair<bool, SpaceInfo> getSpace(const std::string &name);
 
-  std::pair<bool, std::vector<meta::cpp2::EdgeItem>> listEdgeSchemas(GraphSpaceID spaceId);
+  // The tag indexes or the edge indexes of the space
+  std::pair<bool, std::vector<meta::cpp2::IndexItem>> listIndexes(GraphSpaceID spaceId,
+                                                                  bool isEdge);
+
+  std::pair<bool, std::vector<meta::cpp2::HostItem>> listHosts(meta::cpp2::ListHostType tp);
 
   void loadLeader(const std::vector<nebula::meta::cpp2::HostItem> &hostItems,
                   const SpaceNameIdMap &spaceIndexByName);
@@ -107,8 +177,23 @@ class MetaClient {
   MConfig mConfig_;
   SpaceNameIdMap spaceIndexByName_;
   SpaceEdgeNameTypeMap spaceEdgeIndexByName_;
-  std::unordered_map<std::pair<GraphSpaceID, PartitionID>, HostAddr, pair_hash> spacePartLeaderMap_;
+  SpaceTagNameIdMap spaceTagIndexByName_;
+  std::unordered_map<GraphSpaceID, SpaceInfo> spaceInfos_;
+  std::unordered_map<GraphSpaceID, std::vector<SchemaInfo>> spaceEdgeSchemas_;
+  std::unordered_map<GraphSpaceID, std::vector<SchemaInfo>> spaceTagSchemas_;
+  SpaceIndexNameInfoMap spaceIndexInfoByName_;
+  // All parts of each space, 1 to SpaceInfo::partNum_
   std::unordered_map<GraphSpaceID, std::vector<PartitionID>> spacePartsMap_;
+  // Guard the leaders, which may be refreshed while scanning
+  std::shared_mutex lock_;
+  std::unordered_map<std::pair<GraphSpaceID, PartitionID>, HostAddr, pair_hash> spacePartLeaderMap_;
+  // Only one refresh of the leaders is in progress
+  std::mutex refreshLock_;
+  std::condition_variable refreshed_;
+  bool refreshing_{false};
+  int64_t refreshes_{0};
+  bool refreshSucceeded_{false};
+  std::shared_ptr<ClientRuntime> runtime_;
   std::shared_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
   std::shared_ptr<thrift::ThriftClientManager<meta::cpp2::MetaServiceAsyncClient>> clientsMan_;
 };
@@ -0,0 +1,218 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/datatypes/HostAddr.h"
+#include "common/datatypes/Value.h"
+#include "common/thrift/ThriftTypes.h"
+#include "nebula/mclient/MetaClient.h"
+#include "nebula/sclient/PartitionRouter.h"
+#include "nebula/sclient/StorageClient.h"
+
+namespace nebula {
+
+namespace storage {
+namespace cpp2 {
+
+class ExecResponse;
+
+}  // namespace cpp2
+}  // namespace storage
+
+struct BulkWriterConfig {
+  // The rows of a tag or an edge to the same leader are sent once there are
+  // this many of them
+  int32_t batchRows_{512};
+  // Send the rows buffered for longer than this even if there are fewer
+  int32_t flushIntervalMs_{100};
+  // Max number of requests of the writer in flight to one storage host, 0
+  // for no limit of its own. They wait in the queue of the host in the
+  // client too, see SConfig::maxInflightPerHost_, this keeps the writer
+  // from taking all of its slots from the reads.
+  int32_t maxInflightPerHost_{4};
+  // Max number of rows buffered, waiting or in flight, adding blocks beyond
+  // that until some are written
+  int64_t maxPendingRows_{1 << 20};
+  // Max number of times the rows of a part are sent again after the leader
+  // changed or the request failed, the leader cache is updated first
+  int32_t retryTimes_{3};
+  // Skip the vertices and edges which already exist
+  bool ifNotExists_{false};
+  bool ignoreExistedIndex_{false};
+};
+
+// An edge is two rows, its out-edge and its in-edge
+struct BulkWriterStats {
+  int64_t rows_{0};
+  int64_t failedRows_{0};
+  int64_t requests_{0};
+  int64_t retries_{0};
+  // Rows written per second since the writer was made
+  double rowsPerSecond_{0};
+};
+
+// Write vertices and edges straight to the storage leaders, bypassing graphd.
+// The rows are buffered by tag or edge and by the leader of their parts, and
+// sent in batches of BulkWriterConfig::batchRows_ or every flushIntervalMs_,
+// with several requests in flight to each host. It's safe to add from
+// several threads. The rows of the same key may be written out of order.
+//
+//   auto writer = BulkWriter::make(&client, space, {{"player", {"name"}}}, {});
+//   writer->addVertex("player", "101", {"Tim"});
+//   writer->finish();
+class BulkWriter {
+ public:
+  // Write the vertices of tags and the edges of edges to the space, each with
+  // the properties in the order of the values to add. nullptr if the space,
+  // any tag or any edge is not found.
+  static std::unique_ptr<BulkWriter> make(StorageClient* client,
+                                          const std::string& spaceName,
+                                          const TagProps& tags,
+                                          const EdgeProps& edges,
+                                          const BulkWriterConfig& config = BulkWriterConfig{});
+
+  BulkWriter(const BulkWriter&) = delete;
+  BulkWriter& operator=(const BulkWriter&) = delete;
+
+  // Same as finish()
+  ~BulkWriter();
+
+  // Block while maxPendingRows_ rows are pending, false if the tag is not of
+  // the writer, the vid is not of the vid type of the space or the writer is
+  // finished
+  bool addVertex(const std::string& tag, const Value& vid, std::vector<Value> props);
+
+  // Both the out-edge and the in-edge are added, or neither is, the same as
+  // addVertex otherwise
+  bool addEdge(const std::string& edge,
+               const Value& src,
+               const Value& dst,
+               std::vector<Value> props,
+               EdgeRanking rank = 0);
+
+  // Send all rows added and wait until they are written or failed, false if
+  // any row failed since the writer was made. Rows should not be added in
+  // the meantime, or it may not return before they are written too.
+  bool flush();
+
+  // Flush and stop, nothing can be added after that
+  bool finish();
+
+  BulkWriterStats stats() const;
+
+ private:
+  // A tag or an edge to write
+  struct Target {
+    std::string name_;
+    bool isEdge_{false};
+    // TagID or EdgeType
+    int32_t id_{0};
+    std::vector<std::string> propNames_;
+  };
+
+  // The rows of a target to the same leader
+  struct Batch;
+
+  using BatchKey = std::pair<std::size_t, HostAddr>;
+
+  BulkWriter(StorageClient* client,
+             GraphSpaceID spaceId,
+             PartitionRouter router,
+             std::vector<Target> targets,
+             const BulkWriterConfig& config);
+
+  // Wait while maxPendingRows_ rows are pending, false if the writer is
+  // finished. The guard is locked on return.
+  bool admit(std::unique_lock<std::mutex>* guard);
+
+  // Buffer a row of target in part with lock_ held, the row is a NewVertex or
+  // a NewEdge. The batches which can be sent then are moved to batches.
+  template <typename Row>
+  void add(std::size_t target,
+           PartitionID partId,
+           Row&& row,
+           std::vector<std::shared_ptr<Batch>>* batches);
+
+  // The open batch of target to leader, made if not yet
+  Batch* batchOf(std::size_t target, const HostAddr& leader);
+
+  // The rows of target whose parts have no leader
+  Batch* orphansOf(std::size_t target);
+
+  // Move the rows of partId from batch to the open batch of its leader, or
+  // to the orphans if it has no leader, return the key of the batch moved to
+  BatchKey reroute(Batch* batch, PartitionID partId);
+
+  // Queue the open batch of key to be sent
+  void seal(const BatchKey& key);
+
+  // Take the queued batches of host which can be sent now
+  void take(const HostAddr& host, std::vector<std::shared_ptr<Batch>>* batches);
+
+  void send(std::vector<std::shared_ptr<Batch>> batches);
+
+  void onResponse(const std::shared_ptr<Batch>& batch,
+                  bool succeeded,
+                  const storage::cpp2::ExecResponse& resp);
+
+  // Count a part failed, its rows failed if it's out of retries
+  bool retry(PartitionID partId);
+
+  // Count the rows written or failed, some more can be added then
+  void done(int64_t rows, bool succeeded);
+
+  // Flush the batches older than flushIntervalMs_ and send the orphans again
+  // after updating the leaders, at each interval
+  void flushLoop();
+
+  // Load the leaders from the cache, after refreshing it if refresh. The
+  // parts given a leader by a response in the meantime are kept.
+  void loadLeaders(bool refresh);
+
+  StorageClient* client_;
+  GraphSpaceID spaceId_;
+  PartitionRouter router_;
+  std::vector<Target> targets_;
+  std::unordered_map<std::string, std::size_t> tagIndex_;
+  std::unordered_map<std::string, std::size_t> edgeIndex_;
+  BulkWriterConfig config_;
+  std::chrono::steady_clock::time_point start_;
+
+  mutable std::mutex lock_;
+  std::condition_variable notFull_;
+  std::condition_variable idle_;
+  std::condition_variable wakeup_;
+  // The leader of each part, indexed by PartitionID
+  std::vector<HostAddr> leaders_;
+  // Bumped when a response tells the leader of a part
+  std::vector<int64_t> leaderVersions_;
+  // Failures of each part since it was last written
+  std::vector<int32_t> partRetries_;
+  std::unordered_map<BatchKey, std::unique_ptr<Batch>, pair_hash> open_;
+  std::unordered_map<HostAddr, std::deque<std::shared_ptr<Batch>>> sealed_;
+  std::unordered_map<HostAddr, int32_t> inflight_;
+  // The rows of each target whose parts need the leaders to be loaded again
+  std::unordered_map<std::size_t, std::unique_ptr<Batch>> orphans_;
+  int64_t pending_{0};
+  BulkWriterStats stats_;
+  bool stopped_{false};
+  std::thread flusher_;
+};
+
+}  // namespace nebula
@@ -0,0 +1,239 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/datatypes/List.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+
+// An expression evaluated by storage to filter the rows of a scan, encoded
+// in the format of nebula::Expression::encode(). Comparisons, arithmetic and
+// boolean logic are built with the C++ operators, the constants are
+// converted implicitly:
+//
+//   auto filter = Filter::edgeProp("like", "likeness") >= 90 &&
+//                 !Filter::edgeProp("like", "note").isNull();
+//   client.scanEdgeWithPart(space, part, "like", {"likeness"}, limit,
+//                           DEFAULT_START_TIME, DEFAULT_END_TIME, filter.encode());
+class Filter {
+ public:
+  // Must be the same as nebula::Expression::Kind of the server, only the
+  // order matters
+  enum class Kind : uint8_t {
+    kConstant,
+
+    kAdd,
+    kMinus,
+    kMultiply,
+    kDivision,
+    kMod,
+
+    kUnaryPlus,
+    kUnaryNegate,
+    kUnaryNot,
+    kUnaryIncr,
+    kUnaryDecr,
+
+    kRelEQ,
+    kRelNE,
+    kRelLT,
+    kRelLE,
+    kRelGT,
+    kRelGE,
+    kRelREG,
+    kRelIn,
+    kRelNotIn,
+    kContains,
+    kNotContains,
+    kStartsWith,
+    kNotStartsWith,
+    kEndsWith,
+    kNotEndsWith,
+
+    kSubscript,
+    kAttribute,
+    kLabelAttribute,
+    kColumn,
+
+    kLogicalAnd,
+    kLogicalOr,
+    kLogicalXor,
+
+    kTypeCasting,
+
+    kFunctionCall,
+    kAggregate,
+
+    kTagProperty,
+    kLabelTagProperty,
+    kEdgeProperty,
+    kInputProperty,
+    kVarProperty,
+    kDstProperty,
+    kSrcProperty,
+    kEdgeSrc,
+    kEdgeType,
+    kEdgeRank,
+    kEdgeDst,
+    kVertex,
+    kEdge,
+
+    kUUID,
+
+    kVar,
+    kVersionedVar,
+
+    kList,
+    kSet,
+    kMap,
+
+    kLabel,
+
+    kCase,
+
+    kPredicate,
+    kListComprehension,
+    kReduce,
+
+    kPathBuild,
+
+    kTSPrefix,
+    kTSWildcard,
+    kTSRegexp,
+    kTSFuzzy,
+
+    kIsNull,
+    kIsNotNull,
+    kIsEmpty,
+    kIsNotEmpty,
+  };
+
+  Filter(Value value);  // NOLINT
+
+  template <typename T,
+            typename = std::enable_if_t<std::is_constructible<Value, T&&>::value &&
+                                        !std::is_same<std::decay_t<T>, Value>::value &&
+                                        !std::is_same<std::decay_t<T>, Filter>::value>>
+  Filter(T&& value) : Filter(Value(std::forward<T>(value))) {}  // NOLINT
+
+  // A property of the edge scanned, like.likeness
+  static Filter edgeProp(std::string edge, std::string prop);
+
+  // A property of the vertex scanned, player.age
+  static Filter tagProp(std::string tag, std::string prop);
+
+  // A property of the source or the destination vertex of the edges of
+  // getNeighbors, $^.player.age and $$.player.age
+  static Filter srcProp(std::string tag, std::string prop);
+  static Filter dstProp(std::string tag, std::string prop);
+
+  // The key of the edge scanned, like._src and so on
+  static Filter edgeSrc(std::string edge);
+  static Filter edgeType(std::string edge);
+  static Filter edgeRank(std::string edge);
+  static Filter edgeDst(std::string edge);
+
+  Filter isNull() const;
+  Filter isNotNull() const;
+  Filter isEmpty() const;
+  Filter isNotEmpty() const;
+
+  Filter in(List values) const;
+  Filter notIn(List values) const;
+  Filter contains(Filter str) const;
+  Filter startsWith(Filter str) const;
+  Filter endsWith(Filter str) const;
+  // Matched by the regular expression
+  Filter matches(Filter regex) const;
+
+  friend Filter operator==(Filter lhs, Filter rhs) {
+    return binary(Kind::kRelEQ, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator!=(Filter lhs, Filter rhs) {
+    return binary(Kind::kRelNE, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator<(Filter lhs, Filter rhs) {
+    return binary(Kind::kRelLT, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator<=(Filter lhs, Filter rhs) {
+    return binary(Kind::kRelLE, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator>(Filter lhs, Filter rhs) {
+    return binary(Kind::kRelGT, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator>=(Filter lhs, Filter rhs) {
+    return binary(Kind::kRelGE, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator+(Filter lhs, Filter rhs) {
+    return binary(Kind::kAdd, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator-(Filter lhs, Filter rhs) {
+    return binary(Kind::kMinus, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator*(Filter lhs, Filter rhs) {
+    return binary(Kind::kMultiply, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator/(Filter lhs, Filter rhs) {
+    return binary(Kind::kDivision, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator%(Filter lhs, Filter rhs) {
+    return binary(Kind::kMod, std::move(lhs), std::move(rhs));
+  }
+  // Both operands are evaluated by storage, there is no short circuit here
+  friend Filter operator&&(Filter lhs, Filter rhs) {
+    return logical(Kind::kLogicalAnd, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator||(Filter lhs, Filter rhs) {
+    return logical(Kind::kLogicalOr, std::move(lhs), std::move(rhs));
+  }
+  friend Filter operator!(Filter operand) {
+    return unary(Kind::kUnaryNot, std::move(operand));
+  }
+  friend Filter operator-(Filter operand) {
+    return unary(Kind::kUnaryNegate, std::move(operand));
+  }
+
+  Kind kind() const {
+    return kind_;
+  }
+
+  // The filter field of the requests
+  std::string encode() const;
+
+  // Like the where clause of nGQL, for logs
+  std::string toString() const;
+
+ private:
+  Filter(Kind kind, std::string ref, std::string sym, std::string prop);
+
+  static Filter binary(Kind kind, Filter lhs, Filter rhs);
+
+  // Chains of the same operator are flattened into one expression
+  static Filter logical(Kind kind, Filter lhs, Filter rhs);
+
+  static Filter unary(Kind kind, Filter operand);
+
+  void writeTo(std::string* buf) const;
+
+  Kind kind_;
+  // kConstant
+  Value value_;
+  // The properties, ref_.sym_.prop_
+  std::string ref_;
+  std::string sym_;
+  std::string prop_;
+  // The others
+  std::vector<Filter> operands_;
+};
+
+}  // namespace nebula
@@ -0,0 +1,91 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/datatypes/HostAddr.h"
+#include "nebula/sclient/SConfig.h"
+
+namespace nebula {
+
+struct HostLimiterStats {
+  // Requests which waited for a slot
+  int64_t queued_{0};
+  // Requests merged into another one waiting, so not sent by themselves
+  int64_t merged_{0};
+  // Times the limit of a host was cut by the latency or a failure
+  int64_t decreases_{0};
+};
+
+// Limit the requests in flight to each storage host as SConfig
+// maxInflightPerHost_ and targetLatencyMs_ describe, the others wait in a
+// queue of the host and are sent in order as slots are freed. With
+// coalesceRequests_, a request may be merged into one waiting in the queue
+// instead. It's safe to be used from several threads.
+class HostLimiter {
+ public:
+  // A request to a host, waiting for a slot
+  class Pending {
+   public:
+    virtual ~Pending() = default;
+
+    // Send the request, its slot is freed by release() when it's done
+    virtual void send() = 0;
+
+    // Take in other, a later request to the same host, so both are sent as
+    // this one. False if they can't be merged.
+    virtual bool merge(Pending* other) {
+      (void)other;
+      return false;
+    }
+  };
+
+  explicit HostLimiter(const SConfig& sConfig);
+
+  HostLimiter(const HostLimiter&) = delete;
+  HostLimiter& operator=(const HostLimiter&) = delete;
+
+  // Send request now if host has a free slot, otherwise queue it or merge it
+  // into a request in the queue
+  void submit(const HostAddr& host, std::unique_ptr<Pending> request);
+
+  // A request to host is done, after latencyUs without the time queued or
+  // failed. Free its slot and send the next requests in the queue.
+  void release(const HostAddr& host, int64_t latencyUs, bool succeeded);
+
+  // The current limit of host, 0 for no limit
+  int32_t limitOf(const HostAddr& host) const;
+
+  HostLimiterStats stats() const;
+
+ private:
+  struct Host {
+    // Fractional so it grows by 1 after about a round of requests
+    double limit_{0};
+    int32_t inflight_{0};
+    // Responses to wait for before the limit can be cut again, so one slow
+    // round cuts it once
+    int32_t holdDecrease_{0};
+    std::deque<std::unique_ptr<Pending>> queue_;
+  };
+
+  // Take the requests which can be sent now with the lock held
+  void takeReady(Host* host, std::deque<std::unique_ptr<Pending>>* ready);
+
+  int32_t maxInflight_;
+  int64_t targetLatencyUs_;
+  bool coalesce_;
+  mutable std::mutex lock_;
+  std::unordered_map<HostAddr, Host> hosts_;
+  HostLimiterStats stats_;
+};
+
+}  // namespace nebula
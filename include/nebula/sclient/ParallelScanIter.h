@@ -0,0 +1,67 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "common/datatypes/DataSet.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+
+// Mark the pages which mix the rows of several partitions
+constexpr PartitionID kMixedParts = 0;
+
+// Receive one page of a partition, or kMixedParts if the page mixes several
+// partitions. It's called from several threads at the same time. Return false
+// to stop the scan.
+using ScanCallback = std::function<bool(PartitionID, DataSet&&)>;
+
+// Iterate the pages of a whole space scan which runs in the background. At
+// most capacity pages are buffered, the scan is paused when the buffer is
+// full. Destroying the iterator stops the scan.
+class ParallelScanIter {
+ public:
+  // Run the scan with the callback which feeds this iterator, return false if
+  // any partition failed
+  using Runner = std::function<bool(const ScanCallback&)>;
+
+  ParallelScanIter(Runner runner, std::size_t capacity);
+
+  ParallelScanIter(const ParallelScanIter&) = delete;
+  ParallelScanIter& operator=(const ParallelScanIter&) = delete;
+
+  ~ParallelScanIter();
+
+  // Block until the next page arrives, false if the scan is over. It's safe
+  // to be called from several threads.
+  bool next(DataSet* page, PartitionID* partId = nullptr);
+
+  // Whether all partitions have been scanned successfully, only meaningful
+  // after next() returned false
+  bool succeeded();
+
+ private:
+  bool push(PartitionID partId, DataSet&& page);
+
+  std::size_t capacity_;
+  std::mutex lock_;
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+  std::deque<std::pair<PartitionID, DataSet>> pages_;
+  bool finished_{false};
+  bool closed_{false};
+  bool succeeded_{true};
+  std::thread thread_;
+};
+
+}  // namespace nebula
@@ -0,0 +1,69 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+
+#include <cstdint>
+#include <utility>
+
+#include "common/datatypes/Value.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+
+class MetaClient;
+
+// Map the vids of a space to their parts the same way as storage: an int vid
+// or a string vid of 8 bytes is taken as an uint64, other string vids are
+// hashed by MurmurHash2, and the part is that modulo the number of parts
+// plus 1.
+class PartitionRouter {
+ public:
+  PartitionRouter(int32_t numParts, bool intVid);
+
+  // For the space in the cache of metaClient, false if it's not found
+  static std::pair<bool, PartitionRouter> make(MetaClient* metaClient, GraphSpaceID spaceId);
+
+  int32_t numParts() const {
+    return numParts_;
+  }
+
+  bool intVid() const {
+    return intVid_;
+  }
+
+  // 0 if vid is not of the vid type of the space
+  PartitionID partFor(const Value& vid) const;
+
+  // The part of a key of the KV store, which is routed as a string vid
+  // whatever the vid type of the space
+  PartitionID partForKey(folly::StringPiece key) const;
+
+  // parts[i] is the part of vids[i], false if any vid is not of the vid type
+  // of the space, whose part is 0
+  bool partsFor(folly::Range<const Value*> vids, PartitionID* parts) const;
+
+  // The same for int vids without the type check. It's a plain loop
+  // over the array, which is vectorized if the number of parts is a power
+  // of 2.
+  void partsForInts(folly::Range<const int64_t*> vids, PartitionID* parts) const;
+
+  // MurmurHash2 of nebula, of the bytes before the first '\0' as storage
+  static uint64_t hash(folly::StringPiece vid);
+
+ private:
+  PartitionID partOf(uint64_t id) const {
+    return static_cast<PartitionID>((mask_ != 0 ? id & mask_ : id % numParts_) + 1);
+  }
+
+  int32_t numParts_;
+  bool intVid_;
+  // numParts_ - 1 if it's a power of 2 greater than 1, or 0
+  uint64_t mask_{0};
+};
+
+}  // namespace nebula
@@ -0,0 +1,101 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "common/datatypes/HostAddr.h"
+#include "nebula/mclient/MetaClient.h"
+
+namespace nebula {
+
+// Where the time of a storage RPC went, measured by the client
+struct RpcLatency {
+  // The time not accounted for by the others, on the network and in the
+  // channels
+  int64_t networkUs() const {
+    return std::max<int64_t>(totalUs_ - queueUs_ - serializeUs_ - serverUs_, 0);
+  }
+
+  // From the call to the response
+  int64_t totalUs_{0};
+  // Waiting for a slot of the host, see SConfig::maxInflightPerHost_, and
+  // for the IO thread to send the request
+  int64_t queueUs_{0};
+  // Serializing the request and deserializing the response
+  int64_t serializeUs_{0};
+  // In storage, ResponseCommon::latency_in_us
+  int64_t serverUs_{0};
+  // Of the serialized request and response
+  int64_t bytesOut_{0};
+  int64_t bytesIn_{0};
+  // The latency of each stage in storage, ResponseCommon::latency_detail_us
+  std::unordered_map<std::string, int32_t> serverDetailUs_;
+};
+
+// Latencies in microseconds counted in buckets of powers of 2, so a
+// percentile is within twice the real one
+class LatencyHistogram {
+ public:
+  void add(int64_t us);
+
+  void merge(const LatencyHistogram& other);
+
+  int64_t count() const {
+    return count_;
+  }
+
+  int64_t sumUs() const {
+    return sumUs_;
+  }
+
+  int64_t maxUs() const {
+    return maxUs_;
+  }
+
+  double meanUs() const {
+    return count_ == 0 ? 0 : static_cast<double>(sumUs_) / count_;
+  }
+
+  // The upper bound of the bucket of the pth percentile, p in [0, 100], and
+  // at most maxUs()
+  int64_t percentileUs(double p) const;
+
+ private:
+  // Bucket i > 0 counts [2^(i-1), 2^i), bucket 0 counts 0
+  static constexpr std::size_t kBuckets = 64;
+
+  std::array<int64_t, kBuckets> buckets_{};
+  int64_t count_{0};
+  int64_t sumUs_{0};
+  int64_t maxUs_{0};
+};
+
+// The calls of an RPC to a host
+struct RpcStats {
+  void add(const RpcLatency& latency, bool succeeded);
+
+  int64_t calls_{0};
+  // The calls without a response
+  int64_t failures_{0};
+  int64_t bytesOut_{0};
+  int64_t bytesIn_{0};
+  LatencyHistogram totalUs_;
+  LatencyHistogram queueUs_;
+  LatencyHistogram serializeUs_;
+  LatencyHistogram serverUs_;
+  LatencyHistogram networkUs_;
+};
+
+// The stats of each RPC, e.g. "getNeighbors", to each host
+using RpcStatsMap = std::unordered_map<std::pair<std::string, HostAddr>, RpcStats, pair_hash>;
+
+}  // namespace nebula
@@ -6,8 +6,11 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "common/runtime/ClientRuntime.h"
+
 namespace nebula {
 
 struct SConfig {
@@ -17,6 +20,55 @@ struct SConfig {
   int32_t clientTimeoutInMs_{60 * 1000};
   bool enableSSL_{false};
   std::string CAPath_;
+  // The threads of the client, nullptr for its own. It's also the runtime of
+  // the meta client of the storage client unless MConfig has one.
+  std::shared_ptr<ClientRuntime> runtime_;
+  // Max number of partitions scanned at the same time by a whole space scan
+  int32_t scanConcurrency_{16};
+  // Max number of partitions scanned at the same time on one storage host
+  int32_t scanConcurrencyPerHost_{4};
+  // Max number of partitions with the same leader scanned by one request of
+  // a whole space scan. The pages of such a request mix their rows.
+  int32_t scanPartsPerRequest_{1};
+  // Max number of pages a scan iterator fetches ahead of the caller, so
+  // the next page is on the way while the current one is processed. 0 to
+  // fetch each page only when it's asked for.
+  int32_t scanPrefetchDepth_{0};
+  // Max number of times a part is scanned again from its cursor after the
+  // leader changed or the request failed, the leader cache is updated first
+  int32_t scanRetryTimes_{3};
+  // Wait before the first retry of a part, doubled on each following one
+  int32_t scanRetryIntervalMs_{100};
+  // Save the checkpoint of StorageClient::scanWithCheckpoint at this interval
+  int32_t scanCheckpointIntervalMs_{10 * 1000};
+  // Adapt the page size of each scan to take about this long in storage, or
+  // to be about this many bytes, whichever is smaller. 0 for neither, then
+  // the limit passed to the scan is the size of every page. Otherwise that
+  // limit is the largest page size.
+  int32_t scanTargetPageLatencyMs_{0};
+  int64_t scanTargetPageBytes_{0};
+  // The first and the smallest page size of the adaptive scans
+  int64_t scanInitialPageSize_{1024};
+  int64_t scanMinPageSize_{16};
+  // Bytes of all pages in flight of the adaptive scans, which caps the page
+  // size too. 0 for no limit.
+  int64_t scanMemoryBudgetBytes_{0};
+  // Max number of keys in one request of the KV API, the keys to the same
+  // leader are split into requests of this many, which are sent in parallel.
+  // 0 for one request to each leader.
+  int32_t kvBatchSize_{1024};
+  // Max number of requests in flight to one storage host, the others wait in
+  // a queue of the host and are sent in order. 0 for no limit.
+  int32_t maxInflightPerHost_{0};
+  // Adapt the limit of each host between 1 and maxInflightPerHost_ to keep
+  // the latency of its requests under this: add 1 after a round of faster
+  // ones, halve it after a slower one or a failure. 0 for a fixed limit.
+  int32_t targetLatencyMs_{0};
+  // Merge a read request waiting in the queue of a host into an earlier one
+  // waiting there, so they are sent as one: identical requests, or getProps
+  // and KV gets differing only in their keys, up to coalesceMaxRows_ keys.
+  bool coalesceRequests_{true};
+  int32_t coalesceMaxRows_{1024};
 };
 
 }  // namespace nebula
@@ -0,0 +1,54 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/thrift/ThriftTypes.h"
+#include "nebula/sclient/ScanVertexIter.h"
+
+namespace nebula {
+
+// The spec and the progress of a whole space scan, see
+// StorageClient::scanWithCheckpoint
+struct ScanCheckpoint {
+  std::string spaceName_;
+  // The edge to scan, or empty to scan the vertices of tagProps_
+  std::string edgeName_;
+  std::vector<std::string> propNames_;
+  TagProps tagProps_;
+  int64_t limit_{std::numeric_limits<int64_t>::max()};
+  int64_t startTime_{0};
+  int64_t endTime_{std::numeric_limits<int64_t>::max()};
+  std::string filter_;
+  bool onlyLatestVersion_{false};
+  bool enableReadFromFollower_{true};
+
+  // The cursors of the parts which have been scanned partly, the failed
+  // parts keep the cursor they failed at
+  std::unordered_map<PartitionID, std::string> cursors_;
+  // The parts scanned to the end
+  std::set<PartitionID> finished_;
+  // Number of rows passed to the callback
+  int64_t rows_{0};
+
+  // Write to path atomically, the old file is kept if failed
+  bool save(const std::string& path) const;
+
+  static std::pair<bool, ScanCheckpoint> load(const std::string& path);
+
+  std::string toJson() const;
+
+  static std::pair<bool, ScanCheckpoint> fromJson(const std::string& json);
+};
+
+}  // namespace nebula
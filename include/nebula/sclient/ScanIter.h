@@ -0,0 +1,110 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/HostAddr.h"
+#include "common/thrift/ThriftTypes.h"
+#include "nebula/sclient/ScanPageSizer.h"
+
+namespace folly {
+template <class T>
+class Future;
+}  // namespace folly
+
+namespace nebula {
+class StorageClient;
+
+namespace storage {
+namespace cpp2 {
+class ScanEdgeRequest;
+class ScanVertexRequest;
+class ScanCursor;
+class ScanResponse;
+}  // namespace cpp2
+}  // namespace storage
+
+// The iterator of the pages of a scan, Request is ScanEdgeRequest or
+// ScanVertexRequest, which are the only ones it's instantiated for. See
+// ScanEdgeIter and ScanVertexIter.
+template <typename Request>
+struct ScanIter {
+  ScanIter(StorageClient* client, Request* req, bool hasNext = true);
+
+  ~ScanIter();
+
+  bool hasNext();
+
+  DataSet next();
+
+  StorageClient* client_;
+  Request* req_;
+  // The parts of req_ are the ones to be scanned, with their cursors
+  bool hasNext_;
+  // The cursor of the last part which has more data
+  std::string nextCursor_;
+  // Set when any part failed to be scanned
+  bool failed_{false};
+  // The failed parts and the cursors they failed at
+  std::unordered_map<PartitionID, std::string> failedParts_;
+  // Pages fetched ahead of the caller, see SConfig::scanPrefetchDepth_
+  std::size_t prefetchDepth_;
+  std::deque<DataSet> ready_;
+  bool inflight_{false};
+  // Number of times the parts were retried, see SConfig::scanRetryTimes_
+  int64_t retries_{0};
+  std::unordered_map<PartitionID, int32_t> retryTimes_;
+  // Set when some parts are to be retried, then backoff() waits for
+  // retryDelayMs_ and updates the leaders before sending them
+  bool retryPending_{false};
+  int64_t retryDelayMs_{0};
+  // The leaders told by the failed parts, or the whole leader cache if
+  // refreshLeaders_. It's done by the caller thread as it waits for meta,
+  // the responses are handled on the IO threads.
+  std::vector<std::pair<PartitionID, HostAddr>> leaderHints_;
+  bool refreshLeaders_{false};
+  // Chooses the limit of each page, see SConfig::scanTargetPageLatencyMs_
+  ScanPageSizer pageSizer_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+
+ private:
+  // What is scanned, for the logs
+  static const char* kind();
+
+  // Send req to the leaders of its parts
+  std::pair<bool, storage::cpp2::ScanResponse> scan(const Request& req);
+  folly::Future<std::pair<bool, storage::cpp2::ScanResponse>> scanAsync(const Request& req);
+
+  // Send the request of the next page, the page is put into ready_
+  void fetch();
+
+  // Drop the part which failed at cursor
+  void fail(PartitionID partId, const storage::cpp2::ScanCursor& cursor);
+
+  // Sleep for retryDelayMs_ and update the leaders if some parts are to be
+  // retried
+  void backoff();
+
+  // Keep the failed part in parts to be scanned again from cursor, false if
+  // it has been retried too many times
+  bool retry(PartitionID partId,
+             const storage::cpp2::ScanCursor& cursor,
+             std::unordered_map<PartitionID, storage::cpp2::ScanCursor>* parts);
+
+  // Update the cursor by the response and return its page
+  DataSet onResponse(std::pair<bool, storage::cpp2::ScanResponse>&& r);
+};
+
+}  // namespace nebula
@@ -0,0 +1,66 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/datatypes/DataSet.h"
+#include "nebula/sclient/SConfig.h"
+
+namespace nebula {
+
+// The page sizes chosen by the adaptive scans of a client
+struct ScanPageStats {
+  int64_t pages_{0};
+  int64_t rows_{0};
+  // Estimated by estimateScanBytes()
+  int64_t bytes_{0};
+  // The sum of the page sizes asked for, to get the average
+  int64_t totalPageSize_{0};
+  int64_t lastPageSize_{0};
+  int64_t minPageSize_{0};
+  int64_t maxPageSize_{0};
+};
+
+// Rough size of the values of page as they are sent
+int64_t estimateScanBytes(const DataSet& page);
+
+// Choose the limit of the next page of a scan from the latency and the
+// bytes per row of the pages seen so far, to reach the targets of SConfig.
+// The limit grows at most twice a page, and only after a full page.
+class ScanPageSizer {
+ public:
+  // Disabled, the limit passed to the scan is used for every page
+  ScanPageSizer() = default;
+
+  // maxLimit is the limit passed to the scan
+  ScanPageSizer(const SConfig& sConfig, int64_t maxLimit);
+
+  bool enabled() const {
+    return enabled_;
+  }
+
+  int64_t limit() const {
+    return limit_;
+  }
+
+  // Adjust the limit by a page of rows rows and bytes bytes which took
+  // latencyUs in storage, return the new limit
+  int64_t update(int64_t rows, int64_t bytes, int64_t latencyUs);
+
+ private:
+  bool enabled_{false};
+  int64_t limit_{0};
+  int64_t minLimit_{1};
+  int64_t maxLimit_{0};
+  double targetLatencyUs_{0};
+  double targetBytes_{0};
+  // Moving averages of the pages
+  double usPerRow_{0};
+  double bytesPerRow_{0};
+};
+
+}  // namespace nebula
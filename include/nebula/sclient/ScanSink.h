@@ -0,0 +1,68 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+#include "common/thrift/ThriftTypes.h"
+#include "nebula/sclient/ParallelScanIter.h"
+
+namespace nebula {
+
+// Push the pages of a scan to consumer threads, so the scan goes on while
+// the pages are processed. The pages are moved all the way from the
+// response to the consumer. At most maxInflight pages are queued or being
+// consumed, the scan blocks beyond that.
+//
+//   ScanSink sink(consume, 4, 16);
+//   client.scanEdge(space, edge, props, sink.callback());
+//   sink.finish();
+class ScanSink {
+ public:
+  // consumer is called from consumerThreads threads at the same time,
+  // return false to stop the scan
+  ScanSink(ScanCallback consumer, std::size_t consumerThreads, std::size_t maxInflight);
+
+  ScanSink(const ScanSink&) = delete;
+  ScanSink& operator=(const ScanSink&) = delete;
+
+  // Same as finish()
+  ~ScanSink();
+
+  // The callback to pass to the scan, it returns false after the consumer
+  // stopped. The sink must outlive the scan.
+  ScanCallback callback();
+
+  // Wait until all pages are consumed and stop the threads, false if the
+  // consumer stopped the scan
+  bool finish();
+
+ private:
+  bool push(PartitionID partId, DataSet&& page);
+
+  void consume();
+
+  ScanCallback consumer_;
+  std::size_t maxInflight_;
+  std::mutex lock_;
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+  std::deque<std::pair<PartitionID, DataSet>> pages_;
+  // Pages queued or being consumed
+  std::size_t inflight_{0};
+  bool closed_{false};
+  bool stopped_{false};
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace nebula
@@ -0,0 +1,22 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nebula/sclient/ScanIter.h"
+
+namespace nebula {
+
+// The tags and their properties to return by a vertex scan, all properties of
+// a tag are returned if its list is empty
+using TagProps = std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+using ScanVertexIter = ScanIter<storage::cpp2::ScanVertexRequest>;
+
+}  // namespace nebula
@@ -5,22 +5,38 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "ScanEdgeIter.h"
 #include "common/datatypes/HostAddr.h"
+#include "common/datatypes/KeyValue.h"
 #include "common/thrift/ThriftTypes.h"
 #include "nebula/mclient/MetaClient.h"
+#include "nebula/sclient/HostLimiter.h"
+#include "nebula/sclient/ParallelScanIter.h"
+#include "nebula/sclient/PartitionRouter.h"
+#include "nebula/sclient/RpcStats.h"
 #include "nebula/sclient/SConfig.h"
+#include "nebula/sclient/ScanCheckpoint.h"
 #include "nebula/sclient/ScanEdgeIter.h"
+#include "nebula/sclient/ScanPageSizer.h"
+#include "nebula/sclient/ScanVertexIter.h"
+#include "nebula/sclient/StorageResult.h"
 
 namespace folly {
 class IOThreadPoolExecutor;
 template <class T>
+class Future;
+template <class T>
 class Promise;
 }  // namespace folly
 
@@ -45,8 +61,15 @@ namespace storage {
 namespace cpp2 {
 
 class GraphStorageServiceAsyncClient;
+class AddEdgesRequest;
+class AddVerticesRequest;
+class ExecResponse;
+class GetNeighborsRequest;
+class GetPropRequest;
+class LookupIndexRequest;
 class ScanCursor;
 class ScanEdgeRequest;
+class ScanVertexRequest;
 class ScanResponse;
 
 }  // namespace cpp2
@@ -56,8 +79,37 @@ class ScanResponse;
 #define DEFAULT_START_TIME 0
 #define DEFAULT_END_TIME std::numeric_limits<int64_t>::max()
 
+enum class EdgeDirection {
+  kOut,
+  kIn,
+  kBoth,
+};
+
+// Edge names with the properties to get of each, all properties if empty
+using EdgeProps = std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+// The key of an edge to get the properties of
+struct EdgeKey {
+  Value src_;
+  EdgeRanking rank_{0};
+  Value dst_;
+};
+
+// A condition on a column of an index of lookupIndex: the values equal to
+// begin_ if prefix_, otherwise those between begin_ and end_
+struct IndexHint {
+  std::string column_;
+  bool prefix_{true};
+  Value begin_;
+  Value end_;
+  bool includeBegin_{true};
+  bool includeEnd_{false};
+};
+
 class StorageClient {
-  friend struct ScanEdgeIter;
+  template <typename Request>
+  friend struct ScanIter;
+  friend class BulkWriter;
 
  public:
   explicit StorageClient(const std::vector<std::string>& metaAddrs,
@@ -79,21 +131,329 @@ class StorageClient {
                                 bool onlyLatestVersion = false,
                                 bool enableReadFromFollower = true);  // plato needed
 
+  // Scan all partitions of the space concurrently, limited by scanConcurrency_
+  // and scanConcurrencyPerHost_ of SConfig. Pages are passed to cb as they
+  // arrive, from several threads. Block until the scan is over, return false
+  // if any partition failed.
+  bool scanEdge(std::string spaceName,
+                std::string edgeName,
+                std::vector<std::string> propNames,
+                ScanCallback cb,
+                int64_t limit = DEFAULT_LIMIT,
+                int64_t startTime = DEFAULT_START_TIME,
+                int64_t endTime = DEFAULT_END_TIME,
+                std::string filter = "",
+                bool onlyLatestVersion = false,
+                bool enableReadFromFollower = true);
+
+  // Same as above, but the pages are consumed through the returned iterator
+  std::unique_ptr<ParallelScanIter> scanEdge(std::string spaceName,
+                                             std::string edgeName,
+                                             std::vector<std::string> propNames,
+                                             int64_t limit = DEFAULT_LIMIT,
+                                             int64_t startTime = DEFAULT_START_TIME,
+                                             int64_t endTime = DEFAULT_END_TIME,
+                                             std::string filter = "",
+                                             bool onlyLatestVersion = false,
+                                             bool enableReadFromFollower = true);
+
+  ScanVertexIter scanVertexWithPart(std::string spaceName,
+                                    int32_t partID,
+                                    TagProps tagProps,
+                                    int64_t limit = DEFAULT_LIMIT,
+                                    int64_t startTime = DEFAULT_START_TIME,
+                                    int64_t endTime = DEFAULT_END_TIME,
+                                    std::string filter = "",
+                                    bool onlyLatestVersion = false,
+                                    bool enableReadFromFollower = true);
+
+  // Scan the vertices of all partitions, the same as scanEdge
+  bool scanVertex(std::string spaceName,
+                  TagProps tagProps,
+                  ScanCallback cb,
+                  int64_t limit = DEFAULT_LIMIT,
+                  int64_t startTime = DEFAULT_START_TIME,
+                  int64_t endTime = DEFAULT_END_TIME,
+                  std::string filter = "",
+                  bool onlyLatestVersion = false,
+                  bool enableReadFromFollower = true);
+
+  std::unique_ptr<ParallelScanIter> scanVertex(std::string spaceName,
+                                               TagProps tagProps,
+                                               int64_t limit = DEFAULT_LIMIT,
+                                               int64_t startTime = DEFAULT_START_TIME,
+                                               int64_t endTime = DEFAULT_END_TIME,
+                                               std::string filter = "",
+                                               bool onlyLatestVersion = false,
+                                               bool enableReadFromFollower = true);
+
+  // Scan the whole space as checkpoint describes, skipping its finished parts
+  // and resuming the others from their cursors. The progress is recorded in
+  // checkpoint and saved to path every SConfig::scanCheckpointIntervalMs_
+  // and when the scan is over, so a failed or stopped scan can be resumed by
+  // ScanCheckpoint::load(path). Pages passed to cb after the last save may be
+  // passed again when resumed.
+  bool scanWithCheckpoint(ScanCheckpoint* checkpoint, const std::string& path, ScanCallback cb);
+
+  // The neighbors of vids along edges, in the layout of
+  // GetNeighborsResponse.vertices: a row for each vertex with its _vid, a
+  // column for each tag of vertexProps and a column for the edges of each
+  // of edges. The vids are ints or strings as the vid type of the space,
+  // they are grouped by the leaders of their parts, and the requests to the
+  // leaders are sent in parallel. filter is an encoded Filter of the edges,
+  // limit is of the edges of each vertex. All edges are followed if edges
+  // is empty.
+  StorageResult<DataSet> getNeighbors(const std::string& spaceName,
+                                      const std::vector<Value>& vids,
+                                      const EdgeProps& edges,
+                                      EdgeDirection direction = EdgeDirection::kOut,
+                                      const TagProps& vertexProps = {},
+                                      const std::string& filter = "",
+                                      int64_t limit = DEFAULT_LIMIT,
+                                      bool dedup = false);
+
+  // The properties of tagProps of vids, a row for each vid in the order of
+  // vids: its _vid and then a column for each property as "tag.prop". The row
+  // of a vid which has none of the tags or is in a failed part is of empty
+  // values. The vids are grouped by the leaders of their parts and each is
+  // asked once even if repeated, the requests to the leaders are sent in
+  // parallel. filter is an encoded Filter of the vertices.
+  StorageResult<DataSet> getVertexProps(const std::string& spaceName,
+                                        const std::vector<Value>& vids,
+                                        const TagProps& tagProps,
+                                        const std::string& filter = "");
+
+  // The properties of the edges of edgeName, the same as getVertexProps. The
+  // row of each key is of edgeName._src, _type, _rank and _dst, then the
+  // properties of props, or all properties of the edge if props is empty.
+  StorageResult<DataSet> getEdgeProps(const std::string& spaceName,
+                                      const std::string& edgeName,
+                                      const std::vector<EdgeKey>& keys,
+                                      const std::vector<std::string>& props = {},
+                                      const std::string& filter = "");
+
+  // The values of keys in the KV store of the space, which is apart from its
+  // vertices and edges. The keys are routed to the parts as string vids and
+  // grouped by the leaders, the requests are sent in parallel. A part with
+  // any key not found fails with E_PARTIAL_RESULT unless returnPartly, then
+  // only the keys found are in the result.
+  StorageResult<std::unordered_map<std::string, std::string>> kvGet(
+      const std::string& spaceName,
+      const std::vector<std::string>& keys,
+      bool returnPartly = false);
+
+  // Put kvs to the KV store of the space, the same as kvGet. data_ is the
+  // number of the key values of the parts which succeeded.
+  StorageResult<int64_t> kvPut(const std::string& spaceName, std::vector<KeyValue> kvs);
+
+  // Remove keys from the KV store of the space, the same as kvPut
+  StorageResult<int64_t> kvRemove(const std::string& spaceName,
+                                  const std::vector<std::string>& keys);
+
+  // The vertices or the edges found by the index of indexName, a tag index
+  // or an edge index, which meet hints on its columns in the order of the
+  // index, and filter, an encoded Filter. A row for each with the columns
+  // returnCols, which are the _vid of the vertex or the _src, _type, _rank
+  // and _dst of the edge if empty. All partitions are looked up concurrently
+  // as by scanEdge, pages are passed to cb as they arrive and at most limit
+  // rows are passed in all, the lookup stops once cb returns false or limit
+  // rows are passed. Block until the lookup is over, return false if the
+  // index is not found or any partition failed.
+  bool lookupIndex(std::string spaceName,
+                   std::string indexName,
+                   std::vector<IndexHint> hints,
+                   std::vector<std::string> returnCols,
+                   ScanCallback cb,
+                   int64_t limit = DEFAULT_LIMIT,
+                   std::string filter = "");
+
+  // Same as above, but the pages are consumed through the returned iterator
+  std::unique_ptr<ParallelScanIter> lookupIndex(std::string spaceName,
+                                                std::string indexName,
+                                                std::vector<IndexHint> hints,
+                                                std::vector<std::string> returnCols,
+                                                int64_t limit = DEFAULT_LIMIT,
+                                                std::string filter = "");
+
   MetaClient* getMetaClient() {
     return mClient_.get();
   }
 
+  // Number of parts scanned again after the leader changed or the request
+  // failed, by all scans of this client
+  int64_t scanRetries() const {
+    return scanRetries_;
+  }
+
+  // The page sizes chosen by the adaptive scans of this client, see
+  // SConfig::scanTargetPageLatencyMs_
+  ScanPageStats scanPageStats() const {
+    std::lock_guard<std::mutex> guard(statsLock_);
+    return scanPageStats_;
+  }
+
+  // The latencies and the bytes of the RPCs to storage by this client, also
+  // those of BulkWriter
+  RpcStatsMap rpcStats() const {
+    std::lock_guard<std::mutex> guard(statsLock_);
+    return rpcStats_;
+  }
+
+  // The threads of the client, SConfig::runtime_ or its own
+  const std::shared_ptr<ClientRuntime>& runtime() const {
+    return runtime_;
+  }
+
+  // The requests queued and merged by the limits of the hosts, see
+  // SConfig::maxInflightPerHost_
+  HostLimiterStats hostLimiterStats() const {
+    return limiter_.stats();
+  }
+
  private:
+  template <typename Request, typename RemoteFunc, typename Response>
+  class PendingRpc;
+
+  // nullptr if the space or the edge is not found
+  storage::cpp2::ScanEdgeRequest* makeScanEdgeRequest(const std::string& spaceName,
+                                                      const std::string& edgeName,
+                                                      const std::vector<std::string>& propNames,
+                                                      int64_t limit,
+                                                      int64_t startTime,
+                                                      int64_t endTime,
+                                                      const std::string& filter,
+                                                      bool onlyLatestVersion,
+                                                      bool enableReadFromFollower);
+
+  // nullptr if the space or any tag is not found
+  storage::cpp2::ScanVertexRequest* makeScanVertexRequest(const std::string& spaceName,
+                                                          const TagProps& tagProps,
+                                                          int64_t limit,
+                                                          int64_t startTime,
+                                                          int64_t endTime,
+                                                          const std::string& filter,
+                                                          bool onlyLatestVersion,
+                                                          bool enableReadFromFollower);
+
+  // nullptr if the space or the index is not found
+  storage::cpp2::LookupIndexRequest* makeLookupIndexRequest(
+      const std::string& spaceName,
+      const std::string& indexName,
+      const std::vector<IndexHint>& hints,
+      const std::vector<std::string>& returnCols,
+      int64_t limit,
+      const std::string& filter);
+
+  // Look up req in partIds as one page, the parts whose leader changed or
+  // failed to be reached are looked up again as the scans retry them, the
+  // others fail at once
+  std::pair<bool, DataSet> lookupParts(const storage::cpp2::LookupIndexRequest& req,
+                                       std::vector<PartitionID> partIds);
+
+  // Scan the parts by the iterators (ScanEdgeIter, ScanVertexIter or those
+  // of lookupIndex) from factory, at most scanConcurrency_ parts at a time and
+  // scanConcurrencyPerHost_ on one leader
+  // progress(iter, partIds, rows) is called after each page is passed to cb
+  template <typename IterFactory, typename Progress>
+  bool scanParts(GraphSpaceID spaceId,
+                 const std::vector<PartitionID>& parts,
+                 const IterFactory& factory,
+                 const ScanCallback& cb,
+                 const Progress& progress);
+
   std::pair<bool, storage::cpp2::ScanResponse> doScanEdge(
       const storage::cpp2::ScanEdgeRequest& req);
 
+  folly::Future<std::pair<bool, storage::cpp2::ScanResponse>> doScanEdgeAsync(
+      const storage::cpp2::ScanEdgeRequest& req);
+
+  // Count a page of an adaptive scan which asked for pageSize rows
+  void recordScanPage(int64_t pageSize, int64_t rows, int64_t bytes);
+
+  std::pair<bool, storage::cpp2::ScanResponse> doScanVertex(
+      const storage::cpp2::ScanVertexRequest& req);
+
+  folly::Future<std::pair<bool, storage::cpp2::ScanResponse>> doScanVertexAsync(
+      const storage::cpp2::ScanVertexRequest& req);
+
+  // Send the rows of a BulkWriter to their leader by getResponse()
+  folly::Future<std::pair<bool, storage::cpp2::ExecResponse>> doAddEdgesAsync(
+      const HostAddr& leader, const storage::cpp2::AddEdgesRequest& req);
+
+  folly::Future<std::pair<bool, storage::cpp2::ExecResponse>> doAddVerticesAsync(
+      const HostAddr& leader, const storage::cpp2::AddVerticesRequest& req);
+
+  // Send the scan to the leaders of its parts, the responses of several
+  // leaders are merged into one
+  template <typename Request, typename RemoteFunc>
+  folly::Future<std::pair<bool, storage::cpp2::ScanResponse>> doScanAsync(const Request& req,
+                                                                          RemoteFunc&& remoteFunc);
+
+  // Group rows by the parts of the vids in their first column as the parts
+  // of a request, false if any vid is not of the vid type of the space
+  bool groupByPart(GraphSpaceID spaceId,
+                   std::vector<Row> rows,
+                   std::unordered_map<PartitionID, std::vector<Row>>* parts);
+
+  // Send req for rows, each the key of a vertex or an edge, and put the rows
+  // of the responses in the order of rows. keyOf gives the key of a row of
+  // the request or of the responses, a repeated key is asked once.
+  template <typename KeyOf>
+  StorageResult<DataSet> getProps(storage::cpp2::GetPropRequest req,
+                                  std::vector<Row> rows,
+                                  KeyOf&& keyOf);
+
+  // Split req by the leaders of its parts, and into requests of at most
+  // maxRows rows unless it's 0, send the requests in parallel and return the
+  // responses. The parts without a leader, the parts of the requests failed
+  // and the failed parts of the responses are recorded in result, and the
+  // leader cache is updated for them.
+  template <typename Request,
+            typename RemoteFunc,
+            typename T,
+            typename Response = typename std::result_of<RemoteFunc(
+                storage::cpp2::GraphStorageServiceAsyncClient*, const Request&)>::type::value_type>
+  std::vector<Response> fanOut(Request req,
+                               RemoteFunc&& remoteFunc,
+                               StorageResult<T>* result,
+                               std::size_t maxRows = 0);
+
+  // Group keys, or key values by their keys, by their parts as in the KV
+  // store, false if the space is not found
+  template <typename Item>
+  bool groupKeysByPart(GraphSpaceID spaceId,
+                       std::vector<Item> items,
+                       std::unordered_map<PartitionID, std::vector<Item>>* parts);
+
+  // The number of the rows of parts which are not in failedParts
+  template <typename Parts>
+  static int64_t succeededRows(const Parts& parts,
+                               const std::unordered_map<PartitionID, int32_t>& failedParts);
+
+  // Send request by remoteFunc on an IO thread once limiter_ lets it, or
+  // merge it into a request waiting there. The time it took is counted in
+  // the stats of the client and set to latency before pro is fulfilled, if
+  // not nullptr
   template <typename Request, typename RemoteFunc, typename Response>
   void getResponse(std::pair<HostAddr, Request>&& request,
                    RemoteFunc&& remoteFunc,
-                   folly::Promise<std::pair<bool, Response>> pro);
+                   folly::Promise<std::pair<bool, Response>> pro,
+                   RpcLatency* latency = nullptr);
+
+  void recordRpc(const std::string& rpc,
+                 const HostAddr& host,
+                 const RpcLatency& latency,
+                 bool succeeded);
 
   std::unique_ptr<MetaClient> mClient_;
   SConfig sConfig_;
+  std::atomic<int64_t> scanRetries_{0};
+  mutable std::mutex statsLock_;
+  ScanPageStats scanPageStats_;
+  RpcStatsMap rpcStats_;
+  // Released by the responses on the IO threads, so it's destroyed after them
+  HostLimiter limiter_;
+  std::shared_ptr<ClientRuntime> runtime_;
   std::shared_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
   std::shared_ptr<thrift::ThriftClientManager<storage::cpp2::GraphStorageServiceAsyncClient>>
       clientsMan_;
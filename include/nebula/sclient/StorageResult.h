@@ -0,0 +1,40 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "common/datatypes/HostAddr.h"
+#include "common/thrift/ThriftTypes.h"
+#include "nebula/sclient/RpcStats.h"
+
+namespace nebula {
+
+// The result of a request split by the leaders of its parts, which are sent
+// in parallel
+template <typename T>
+struct StorageResult {
+  // Whether all parts succeeded
+  bool succeeded() const {
+    return ok_ && failedParts_.empty();
+  }
+
+  // False if nothing was sent, e.g. the space is not found, or if the
+  // responses can't be merged
+  bool ok_{true};
+  // Merged from the parts which succeeded
+  T data_;
+  // The failed parts and their nebula::cpp2::ErrorCode
+  std::unordered_map<PartitionID, int32_t> failedParts_;
+  // The latency in storage of the request sent to each leader
+  std::unordered_map<HostAddr, int64_t> latencyUs_;
+  // Where the time of the request to each leader went, of the slowest one if
+  // there are several
+  std::unordered_map<HostAddr, RpcLatency> rpcLatency_;
+};
+
+}  // namespace nebula
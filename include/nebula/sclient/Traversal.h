@@ -0,0 +1,64 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/datatypes/Value.h"
+#include "nebula/sclient/StorageClient.h"
+#include "nebula/sclient/StorageResult.h"
+
+namespace nebula {
+
+struct TraversalConfig {
+  // Max number of hops from the start vids
+  int32_t maxHops_{1};
+  // Follow at most this many edges of each vertex, 0 for all
+  int64_t maxDegree_{0};
+  // Stop once this many vertices are reached, the start vids included, 0 for
+  // no limit
+  int64_t maxVertices_{0};
+  // Max number of vids of a hop asked by one getNeighbors call
+  int32_t batchSize_{256};
+  // Max number of getNeighbors calls in flight
+  int32_t concurrency_{8};
+};
+
+// Expand the neighborhood of some vertices hop by hop, breadth first, on the
+// client instead of by GO N STEPS in graphd. The vids of each hop are grouped
+// by the leaders of their parts and asked by getNeighbors in batches of
+// TraversalConfig::batchSize_. A batch of the next hop is sent as soon as it's
+// full, while the batches of the current hop are still arriving, and the
+// vids reached before are skipped.
+//
+//   Traversal traversal(&client, config);
+//   auto result = traversal.expand(space, {"101"}, {"like"});
+//   // result.data_[2] are the vids 2 hops away from "101"
+class Traversal {
+ public:
+  explicit Traversal(StorageClient* client, const TraversalConfig& config = TraversalConfig{});
+
+  // The vids reached from startVids by at most maxHops_ hops along edges, or
+  // along all edges of the space if empty, by their distance: data_[0] are
+  // the start vids and data_[h] those h hops away. filter is an encoded
+  // Filter of the edges to follow. ok_ is false if the space or any edge is
+  // not found, or any start vid is not of the vid type of the space. The
+  // vertices of the failed parts are not expanded.
+  StorageResult<std::vector<std::vector<Value>>> expand(
+      const std::string& spaceName,
+      const std::vector<Value>& startVids,
+      const std::vector<std::string>& edges,
+      EdgeDirection direction = EdgeDirection::kOut,
+      const std::string& filter = "");
+
+ private:
+  StorageClient* client_;
+  TraversalConfig config_;
+};
+
+}  // namespace nebula
@@ -9,7 +9,9 @@
 #include <folly/io/async/AsyncSSLSocket.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/AsyncTransport.h>
+#include <folly/futures/Promise.h>
 #include <folly/io/async/ScopedEventBaseThread.h>
+#include <thrift/lib/cpp2/async/RequestCallback.h>
 #include <thrift/lib/cpp2/async/HeaderClientChannel.h>
 
 #include <memory>
@@ -54,8 +56,17 @@ class NebulaConnectionErrMessageCallback : public folly::AsyncSocket::ErrMessage
 
 NebulaConnectionErrMessageCallback NebulaConnectionErrMessageCallback::cb_;
 
-Connection::Connection()
-    : client_{nullptr}, clientLoopThread_(new folly::ScopedEventBaseThread()) {}
+Connection::Connection() : Connection(nullptr) {}
+
+Connection::Connection(std::shared_ptr<ClientRuntime> runtime)
+    : client_{nullptr}, runtime_(std::move(runtime)) {
+  if (runtime_ != nullptr) {
+    evb_ = runtime_->eventBase();
+  } else {
+    clientLoopThread_ = new folly::ScopedEventBaseThread();
+    evb_ = clientLoopThread_->getEventBase();
+  }
+}
 
 Connection::~Connection() {
   close();
@@ -71,6 +82,10 @@ Connection &Connection::operator=(Connection &&c) {
   clientLoopThread_ = c.clientLoopThread_;
   c.clientLoopThread_ = nullptr;
 
+  evb_ = c.evb_;
+  c.evb_ = nullptr;
+  runtime_ = std::move(c.runtime_);
+
   return *this;
 }
 
@@ -91,17 +106,16 @@ bool Connection::open(const std::string &address,
     DLOG(ERROR) << "Invalid address: " << address << ":" << port << ": " << e.what();
     return false;
   }
-  clientLoopThread_->getEventBase()->runImmediatelyOrRunInEventBaseThreadAndWait(
+  evb_->runImmediatelyOrRunInEventBaseThreadAndWait(
       [this, &complete, &socket, timeout, &socketAddr, enableSSL, &CAPath]() {
         try {
           if (enableSSL) {
-            auto asyncSSLSocket = folly::AsyncSSLSocket::newSocket(nebula::createSSLContext(CAPath),
-                                                      clientLoopThread_->getEventBase());
+            auto asyncSSLSocket =
+                folly::AsyncSSLSocket::newSocket(nebula::createSSLContext(CAPath), evb_);
             asyncSSLSocket->connect(nullptr, std::move(socketAddr), timeout);
             socket = std::move(asyncSSLSocket);
           } else {
-            socket = folly::AsyncSocket::newSocket(
-                clientLoopThread_->getEventBase(), std::move(socketAddr), timeout);
+            socket = folly::AsyncSocket::newSocket(evb_, std::move(socketAddr), timeout);
           }
           complete = true;
         } catch (const std::exception &e) {
@@ -179,6 +193,31 @@ void Connection::asyncExecute(int64_t sessionId, const std::string &stmt, Execut
   });
 }
 
+LazyExecutionResponse Connection::executeLazy(int64_t sessionId, const std::string &stmt) {
+  if (client_ == nullptr) {
+    return LazyExecutionResponse(ErrorCode::E_DISCONNECTED, "Not open connection.");
+  }
+
+  // Take over the raw reply instead of letting the generated client decode it
+  folly::Promise<LazyExecutionResponse> promise;
+  auto future = promise.getSemiFuture();
+  auto cb = std::make_unique<apache::thrift::FunctionReplyCallback>(
+      [p = std::move(promise)](apache::thrift::ClientReceiveState &&state) mutable {
+        if (state.isException()) {
+          p.setValue(LazyExecutionResponse(ErrorCode::E_RPC_FAILURE,
+                                           state.exception().what().toStdString()));
+          return;
+        }
+        p.setValue(LazyExecutionResponse(state.extractBuf(), state.protocolId()));
+      });
+  try {
+    client_->execute(std::move(cb), sessionId, stmt);
+    return std::move(future).get();
+  } catch (const std::exception &ex) {
+    return LazyExecutionResponse(ErrorCode::E_RPC_FAILURE, ex.what());
+  }
+}
+
 ExecutionResponse Connection::executeWithParameter(
     int64_t sessionId,
     const std::string &stmt,
@@ -285,7 +324,7 @@ bool Connection::isOpen() {
 
 void Connection::close() {
   if (client_ != nullptr) {
-    clientLoopThread_->getEventBase()->runImmediatelyOrRunInEventBaseThreadAndWait(
+    evb_->runImmediatelyOrRunInEventBaseThreadAndWait(
         [this]() { delete client_; });
     client_ = nullptr;
   }
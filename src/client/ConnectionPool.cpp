@@ -70,7 +70,7 @@ Connection ConnectionPool::getConnection() {
     }
   }
   if (conns_.empty()) {
-    return Connection();
+    return Connection(config_.runtime_);
   }
   Connection conn = std::move(conns_.front());
   conns_.pop_front();
@@ -92,7 +92,7 @@ void ConnectionPool::newConnection(std::size_t cursor, std::size_t count) {
     if (addrCursor >= address_.size()) {
       addrCursor = 0;
     }
-    Connection conn;
+    Connection conn(config_.runtime_);
     if (conn.open(address_[addrCursor].first,
                   address_[addrCursor].second,
                   config_.timeout_,
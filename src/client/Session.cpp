@@ -20,6 +20,10 @@ void Session::asyncExecute(const std::string &stmt, ExecuteCallback cb) {
   });
 }
 
+LazyExecutionResponse Session::executeLazy(const std::string &stmt) {
+  return conn_.executeLazy(sessionId_, stmt);
+}
+
 ExecutionResponse Session::executeWithParameter(
     const std::string &stmt, const std::unordered_map<std::string, Value> &parameters) {
   return ExecutionResponse(conn_.executeWithParameter(sessionId_, stmt, parameters));
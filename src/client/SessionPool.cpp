@@ -17,6 +17,7 @@ bool SessionPool::init() {
   conf.minConnectionPoolSize_ = config_.minSize_;
   conf.idleTime_ = config_.idleTime_;
   conf.timeout_ = config_.timeout_;
+  conf.runtime_ = config_.runtime_;
   pool_->init(config_.addrs_, conf);
   if (config_.spaceName_.empty()) {
     return false;
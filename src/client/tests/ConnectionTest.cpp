@@ -124,6 +124,20 @@ TEST_F(ConnectionTest, Basic) {
   runOnce(c);
 }
 
+TEST_F(ConnectionTest, Runtime) {
+  nebula::RuntimeConfig config;
+  config.ioThreads_ = 1;
+  auto runtime = std::make_shared<nebula::ClientRuntime>(config);
+  // The connections share the event loop of the runtime
+  nebula::Connection c(runtime);
+  nebula::Connection other(runtime);
+  LOG(INFO) << "Testing once on the runtime.";
+  runOnce(c);
+  runOnce(other);
+  nebula::Connection moved(std::move(c));
+  runOnce(moved);
+}
+
 TEST_F(ConnectionTest, Timeout) {
   nebula::Connection c;
 
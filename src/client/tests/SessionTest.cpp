@@ -100,6 +100,45 @@ TEST_F(SessionTest, Basic) {
   runOnce(pool);
 }
 
+TEST_F(SessionTest, Lazy) {
+  nebula::ConnectionPool pool;
+  pool.init({kServerHost ":9669"}, nebula::Config{});
+  auto session = pool.getSession("root", "nebula");
+  ASSERT_TRUE(session.valid());
+
+  auto result = session.executeLazy("YIELD 1 AS a, \"x\" AS b, 2.5 AS c");
+  ASSERT_EQ(result.errorCode(), nebula::ErrorCode::SUCCEEDED);
+  ASSERT_TRUE(result.hasData());
+  EXPECT_EQ(result.colNames(), std::vector<std::string>({"a", "b", "c"}));
+
+  // projection skips the unselected values
+  nebula::DataSet expected({"c", "a"});
+  expected.emplace_back(nebula::List({2.5, 1}));
+  EXPECT_EQ(result.data({"c", "unknown", "a"}), expected);
+
+  // same as the eager decoding
+  auto eager = session.execute("YIELD 1 AS a, \"x\" AS b, 2.5 AS c");
+  ASSERT_EQ(eager.errorCode, nebula::ErrorCode::SUCCEEDED);
+  ASSERT_NE(result.data(), nullptr);
+  EXPECT_EQ(*result.data(), *eager.data);
+  EXPECT_EQ(result.data({"c", "a"}), expected);
+
+  result = session.executeLazy("EXPLAIN SHOW HOSTS");
+  ASSERT_EQ(result.errorCode(), nebula::ErrorCode::SUCCEEDED);
+  EXPECT_TRUE(result.hasPlanDesc());
+  EXPECT_NE(result.planDesc(), nullptr);
+  auto resp = std::move(result).toExecutionResponse();
+  EXPECT_NE(resp.planDesc, nullptr);
+
+  result = session.executeLazy("YIELD");
+  EXPECT_NE(result.errorCode(), nebula::ErrorCode::SUCCEEDED);
+  EXPECT_NE(result.errorMsg(), nullptr);
+
+  session.release();
+  result = session.executeLazy("YIELD 1");
+  EXPECT_EQ(result.errorCode(), nebula::ErrorCode::E_DISCONNECTED);
+}
+
 TEST_F(SessionTest, OverUse) {
   nebula::ConnectionPool pool;
   nebula::Config c;
@@ -0,0 +1,441 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/compute/Kernels.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "common/datatypes/ValueHash.h"
+#include "common/datatypes/ValueKey.h"
+#include "common/runtime/ClientRuntime.h"
+
+namespace nebula {
+namespace compute {
+
+namespace {
+
+std::size_t numThreads(std::size_t rows, const KernelOptions& opts) {
+  std::size_t threads = opts.threads_;
+  if (threads == 0) {
+    auto workers = opts.runtime_ == nullptr ? 0 : opts.runtime_->config().cpuThreads_;
+    threads = workers > 0 ? static_cast<std::size_t>(workers) + 1
+                          : std::thread::hardware_concurrency();
+  }
+  std::size_t byRows = rows / std::max<std::size_t>(opts.minRowsPerThread_, 1);
+  return std::max<std::size_t>(std::min(threads, byRows), 1);
+}
+
+// Run fn(i) for i in [0, n), each on its own thread, the first one on the
+// calling thread. With a runtime its workers take the next i in turn, so the
+// calling thread runs those of the workers which are busy.
+template <typename F>
+void parallel(const KernelOptions& opts, std::size_t n, F&& fn) {
+  if (n <= 1) {
+    fn(0);
+    return;
+  }
+  if (opts.runtime_ != nullptr) {
+    std::atomic<std::size_t> next{0};
+    opts.runtime_->runWorkers(n, [&fn, &next, n] {
+      for (auto i = next++; i < n; i = next++) {
+        fn(i);
+      }
+    });
+    return;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(n - 1);
+  for (std::size_t i = 1; i < n; ++i) {
+    threads.emplace_back([&fn, i] { fn(i); });
+  }
+  fn(0);
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+// The i-th of n even ranges over [0, size)
+std::pair<std::size_t, std::size_t> range(std::size_t size, std::size_t n, std::size_t i) {
+  return {size * i / n, size * (i + 1) / n};
+}
+
+// Use the high bits, the hash tables of each partition take the low ones
+std::size_t partitionOf(uint64_t hash, std::size_t n) {
+  return (hash >> 32) % n;
+}
+
+// Sort n chunks on their own threads, then merge them pairwise until only one
+// is left
+template <typename T, typename Less>
+void parallelSort(const KernelOptions& opts, std::vector<T>* items, std::size_t n, Less less) {
+  auto& v = *items;
+  if (n == 1) {
+    std::sort(v.begin(), v.end(), less);
+    return;
+  }
+
+  std::vector<std::size_t> bounds;
+  for (std::size_t i = 0; i < n; ++i) {
+    bounds.emplace_back(range(v.size(), n, i).first);
+  }
+  bounds.emplace_back(v.size());
+  parallel(opts, n, [&](std::size_t i) {
+    std::sort(v.begin() + bounds[i], v.begin() + bounds[i + 1], less);
+  });
+
+  std::vector<T> merged(v.size());
+  while (bounds.size() > 2) {
+    auto chunks = bounds.size() - 1;
+    parallel(opts, (chunks + 1) / 2, [&](std::size_t i) {
+      auto begin = bounds[2 * i];
+      auto mid = bounds[std::min(2 * i + 1, chunks)];
+      auto end = bounds[std::min(2 * i + 2, chunks)];
+      std::merge(std::make_move_iterator(v.begin() + begin),
+                 std::make_move_iterator(v.begin() + mid),
+                 std::make_move_iterator(v.begin() + mid),
+                 std::make_move_iterator(v.begin() + end),
+                 merged.begin() + begin,
+                 less);
+    });
+    v.swap(merged);
+    std::vector<std::size_t> next;
+    for (std::size_t i = 0; i < bounds.size(); i += 2) {
+      next.emplace_back(bounds[i]);
+    }
+    if (next.back() != v.size()) {
+      next.emplace_back(v.size());
+    }
+    bounds.swap(next);
+  }
+}
+
+struct KeyedRow {
+  std::string key;
+  std::size_t index;
+};
+
+bool equalKeys(const Row& lhs,
+               const std::vector<std::size_t>& lhsKeys,
+               const Row& rhs,
+               const std::vector<std::size_t>& rhsKeys) {
+  for (std::size_t i = 0; i < lhsKeys.size(); ++i) {
+    if (!hashEqual(lhs.values[lhsKeys[i]], rhs.values[rhsKeys[i]])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool hasNullKey(const Row& row, const std::vector<std::size_t>& keys) {
+  for (auto key : keys) {
+    const auto& v = row.values[key];
+    if (v.isNull() || v.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct AggState {
+  Value acc;
+  int64_t count{0};
+};
+
+void accumulate(AggState* state, AggFunc func, const Value& v) {
+  if (func == AggFunc::COUNT_ALL) {
+    ++state->count;
+    return;
+  }
+  if (v.isNull() || v.empty()) {
+    return;
+  }
+  switch (func) {
+    case AggFunc::SUM:
+    case AggFunc::AVG:
+      state->acc = state->count == 0 ? v : state->acc + v;
+      break;
+    case AggFunc::MIN:
+      if (state->count == 0 || v < state->acc) {
+        state->acc = v;
+      }
+      break;
+    case AggFunc::MAX:
+      if (state->count == 0 || state->acc < v) {
+        state->acc = v;
+      }
+      break;
+    default:
+      break;
+  }
+  ++state->count;
+}
+
+Value finalize(AggState&& state, AggFunc func) {
+  switch (func) {
+    case AggFunc::COUNT_ALL:
+    case AggFunc::COUNT:
+      return Value(state.count);
+    case AggFunc::AVG:
+      if (state.count == 0) {
+        return Value::kNullValue;
+      }
+      return state.acc / Value(static_cast<double>(state.count));
+    default:
+      return state.count == 0 ? Value::kNullValue : std::move(state.acc);
+  }
+}
+
+}  // namespace
+
+void sort(DataSet* ds, const std::vector<SortKey>& keys, const KernelOptions& opts) {
+  auto& rows = ds->rows;
+  auto n = numThreads(rows.size(), opts);
+
+  // Encode the sort keys so that they're compared bytewise
+  std::vector<KeyedRow> keyed(rows.size());
+  std::vector<char> encoded(n, 1);
+  parallel(opts, n, [&](std::size_t i) {
+    auto r = range(rows.size(), n, i);
+    for (auto idx = r.first; idx < r.second; ++idx) {
+      auto& key = keyed[idx].key;
+      keyed[idx].index = idx;
+      bool ok = true;
+      if (keys.empty()) {
+        ok = appendSortKey(rows[idx].values, &key);
+      }
+      for (std::size_t k = 0; ok && k < keys.size(); ++k) {
+        ok = appendSortKey(rows[idx].values[keys[k].column], &key, !keys[k].ascending);
+      }
+      if (!ok) {
+        encoded[i] = 0;
+        return;
+      }
+    }
+  });
+
+  if (std::all_of(encoded.begin(), encoded.end(), [](char ok) { return ok; })) {
+    parallelSort(opts, &keyed, n, [](const KeyedRow& lhs, const KeyedRow& rhs) {
+      return lhs.key < rhs.key;
+    });
+    std::vector<Row> sorted;
+    sorted.reserve(rows.size());
+    for (auto& k : keyed) {
+      sorted.emplace_back(std::move(rows[k.index]));
+    }
+    rows.swap(sorted);
+    return;
+  }
+
+  // Some type has no sort key, fall back to Value::operator<
+  keyed.clear();
+  parallelSort(opts, &rows, n, [&keys](const Row& lhs, const Row& rhs) {
+    if (keys.empty()) {
+      return lhs < rhs;
+    }
+    for (const auto& key : keys) {
+      const auto& l = lhs.values[key.column];
+      const auto& r = rhs.values[key.column];
+      if (l < r) {
+        return key.ascending;
+      }
+      if (r < l) {
+        return !key.ascending;
+      }
+    }
+    return false;
+  });
+}
+
+std::size_t dedup(DataSet* ds, const KernelOptions& opts) {
+  auto& rows = ds->rows;
+  auto n = numThreads(rows.size(), opts);
+
+  std::vector<uint64_t> hashes(rows.size());
+  parallel(opts, n, [&](std::size_t i) {
+    auto r = range(rows.size(), n, i);
+    hashRows(rows.data() + r.first, r.second - r.first, hashes.data() + r.first);
+  });
+
+  // Equal rows have equal hashes, so each partition can be deduplicated alone
+  std::vector<char> keep(rows.size(), 0);
+  parallel(opts, n, [&](std::size_t p) {
+    auto hash = [&hashes](std::size_t idx) { return hashes[idx]; };
+    auto equal = [&rows](std::size_t lhs, std::size_t rhs) {
+      return hashEqualRows(rows[lhs], rows[rhs]);
+    };
+    std::unordered_set<std::size_t, decltype(hash), decltype(equal)> seen(16, hash, equal);
+    for (std::size_t idx = 0; idx < rows.size(); ++idx) {
+      if (partitionOf(hashes[idx], n) == p) {
+        keep[idx] = seen.emplace(idx).second;
+      }
+    }
+  });
+
+  std::size_t kept = 0;
+  for (std::size_t idx = 0; idx < rows.size(); ++idx) {
+    if (keep[idx]) {
+      if (kept != idx) {
+        rows[kept] = std::move(rows[idx]);
+      }
+      ++kept;
+    }
+  }
+  auto removed = rows.size() - kept;
+  rows.resize(kept);
+  return removed;
+}
+
+DataSet groupBy(const DataSet& ds,
+                const std::vector<std::size_t>& keys,
+                const std::vector<Aggregate>& aggs,
+                const KernelOptions& opts) {
+  DataSet result;
+  for (auto key : keys) {
+    result.colNames.emplace_back(ds.colNames[key]);
+  }
+  for (const auto& agg : aggs) {
+    result.colNames.emplace_back(agg.name);
+  }
+
+  const auto& rows = ds.rows;
+  auto n = numThreads(rows.size(), opts);
+  std::vector<uint64_t> hashes(rows.size());
+  parallel(opts, n, [&](std::size_t i) {
+    auto r = range(rows.size(), n, i);
+    hashRows(rows.data() + r.first, r.second - r.first, keys, hashes.data() + r.first);
+  });
+
+  // Each partition owns the groups whose keys hash to it
+  std::vector<std::vector<Row>> outputs(n);
+  parallel(opts, n, [&](std::size_t p) {
+    // Map the first row of each group to the index of the group
+    auto hash = [&hashes](std::size_t idx) { return hashes[idx]; };
+    auto equal = [&rows, &keys](std::size_t lhs, std::size_t rhs) {
+      return equalKeys(rows[lhs], keys, rows[rhs], keys);
+    };
+    std::unordered_map<std::size_t, std::size_t, decltype(hash), decltype(equal)> groups(
+        16, hash, equal);
+    std::vector<std::size_t> firstRows;
+    std::vector<std::vector<AggState>> states;
+    for (std::size_t idx = 0; idx < rows.size(); ++idx) {
+      if (partitionOf(hashes[idx], n) != p) {
+        continue;
+      }
+      auto ret = groups.emplace(idx, states.size());
+      if (ret.second) {
+        firstRows.emplace_back(idx);
+        states.emplace_back(aggs.size());
+      }
+      auto& group = states[ret.first->second];
+      for (std::size_t a = 0; a < aggs.size(); ++a) {
+        const auto& v =
+            aggs[a].func == AggFunc::COUNT_ALL ? Value::kEmpty : rows[idx].values[aggs[a].column];
+        accumulate(&group[a], aggs[a].func, v);
+      }
+    }
+
+    auto& output = outputs[p];
+    output.reserve(states.size());
+    for (std::size_t g = 0; g < states.size(); ++g) {
+      std::vector<Value> values;
+      values.reserve(keys.size() + aggs.size());
+      for (auto key : keys) {
+        values.emplace_back(rows[firstRows[g]].values[key]);
+      }
+      for (std::size_t a = 0; a < aggs.size(); ++a) {
+        values.emplace_back(finalize(std::move(states[g][a]), aggs[a].func));
+      }
+      output.emplace_back(std::move(values));
+    }
+  });
+
+  for (auto& output : outputs) {
+    result.rows.insert(result.rows.end(),
+                       std::make_move_iterator(output.begin()),
+                       std::make_move_iterator(output.end()));
+  }
+  return result;
+}
+
+DataSet hashJoin(const DataSet& left,
+                 const DataSet& right,
+                 const std::vector<std::size_t>& leftKeys,
+                 const std::vector<std::size_t>& rightKeys,
+                 const KernelOptions& opts) {
+  DataSet result;
+  if (leftKeys.size() != rightKeys.size()) {
+    LOG(ERROR) << "Join keys mismatch, left " << leftKeys.size() << ", right "
+               << rightKeys.size();
+    return result;
+  }
+  result.colNames = left.colNames;
+  result.colNames.insert(result.colNames.end(), right.colNames.begin(), right.colNames.end());
+
+  // Build, each partition has its own table so no locking is needed
+  const auto& build = right.rows;
+  auto nb = numThreads(build.size(), opts);
+  std::vector<uint64_t> hashes(build.size());
+  parallel(opts, nb, [&](std::size_t i) {
+    auto r = range(build.size(), nb, i);
+    hashRows(build.data() + r.first, r.second - r.first, rightKeys, hashes.data() + r.first);
+  });
+  std::vector<std::unordered_multimap<uint64_t, std::size_t>> tables(nb);
+  parallel(opts, nb, [&](std::size_t p) {
+    auto& table = tables[p];
+    for (std::size_t idx = 0; idx < build.size(); ++idx) {
+      if (partitionOf(hashes[idx], nb) == p && !hasNullKey(build[idx], rightKeys)) {
+        table.emplace(hashes[idx], idx);
+      }
+    }
+  });
+
+  // Probe, the tables are read only from now on
+  const auto& probe = left.rows;
+  auto np = numThreads(probe.size(), opts);
+  std::vector<std::vector<Row>> outputs(np);
+  parallel(opts, np, [&](std::size_t i) {
+    auto r = range(probe.size(), np, i);
+    auto& output = outputs[i];
+    for (auto idx = r.first; idx < r.second; ++idx) {
+      const auto& row = probe[idx];
+      if (hasNullKey(row, leftKeys)) {
+        continue;
+      }
+      auto hash = hashRow(row, leftKeys);
+      const auto& table = tables[partitionOf(hash, nb)];
+      auto matches = table.equal_range(hash);
+      for (auto it = matches.first; it != matches.second; ++it) {
+        const auto& other = build[it->second];
+        if (!equalKeys(row, leftKeys, other, rightKeys)) {
+          continue;
+        }
+        std::vector<Value> values;
+        values.reserve(row.size() + other.size());
+        values.insert(values.end(), row.values.begin(), row.values.end());
+        values.insert(values.end(), other.values.begin(), other.values.end());
+        output.emplace_back(std::move(values));
+      }
+    }
+  });
+
+  for (auto& output : outputs) {
+    result.rows.insert(result.rows.end(),
+                       std::make_move_iterator(output.begin()),
+                       std::make_move_iterator(output.end()));
+  }
+  return result;
+}
+
+}  // namespace compute
+}  // namespace nebula
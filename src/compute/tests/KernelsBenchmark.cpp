@@ -0,0 +1,128 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/compute/Kernels.h"
+
+// Each kernel on 1 thread and then on all cores, e.g.
+//   kernels_bm --bm_min_iters=10
+
+namespace nebula {
+namespace compute {
+
+static constexpr std::size_t kRows = 1000000;
+
+static DataSet makeDataSet(std::size_t rows, int64_t distinct) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int64_t> dist(0, distinct - 1);
+  DataSet ds({"k", "name", "v"});
+  ds.rows.reserve(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    auto k = dist(gen);
+    ds.emplace_back(Row({k, "name_" + std::to_string(k % 1000), static_cast<int64_t>(i)}));
+  }
+  return ds;
+}
+
+static const DataSet kDataSet = makeDataSet(kRows, kRows / 10);
+static const DataSet kDimension = makeDataSet(kRows / 10, kRows / 10);
+
+static KernelOptions withThreads(std::size_t threads) {
+  KernelOptions opts;
+  opts.threads_ = threads;
+  return opts;
+}
+
+static void runSort(std::size_t iters, std::size_t threads) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    DataSet ds;
+    BENCHMARK_SUSPEND {
+      ds = kDataSet;
+    }
+    sort(&ds, {{0, true}}, withThreads(threads));
+    folly::doNotOptimizeAway(ds);
+  }
+}
+
+static void runDedup(std::size_t iters, std::size_t threads) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    DataSet ds;
+    BENCHMARK_SUSPEND {
+      ds = kDataSet;
+      for (auto& row : ds.rows) {
+        row.values.pop_back();
+      }
+    }
+    folly::doNotOptimizeAway(dedup(&ds, withThreads(threads)));
+  }
+}
+
+static void runGroupBy(std::size_t iters, std::size_t threads) {
+  std::vector<Aggregate> aggs = {{AggFunc::COUNT_ALL, 0, "cnt"}, {AggFunc::SUM, 2, "sum"}};
+  for (std::size_t i = 0; i < iters; ++i) {
+    auto result = groupBy(kDataSet, {0}, aggs, withThreads(threads));
+    folly::doNotOptimizeAway(result);
+  }
+}
+
+static void runHashJoin(std::size_t iters, std::size_t threads) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    auto result = hashJoin(kDataSet, kDimension, {0}, {0}, withThreads(threads));
+    folly::doNotOptimizeAway(result);
+  }
+}
+
+BENCHMARK(sortSerial, iters) {
+  runSort(iters, 1);
+}
+
+BENCHMARK_RELATIVE(sortParallel, iters) {
+  runSort(iters, 0);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(dedupSerial, iters) {
+  runDedup(iters, 1);
+}
+
+BENCHMARK_RELATIVE(dedupParallel, iters) {
+  runDedup(iters, 0);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(groupBySerial, iters) {
+  runGroupBy(iters, 1);
+}
+
+BENCHMARK_RELATIVE(groupByParallel, iters) {
+  runGroupBy(iters, 0);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(hashJoinSerial, iters) {
+  runHashJoin(iters, 1);
+}
+
+BENCHMARK_RELATIVE(hashJoinParallel, iters) {
+  runHashJoin(iters, 0);
+}
+
+}  // namespace compute
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
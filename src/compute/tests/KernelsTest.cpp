@@ -0,0 +1,241 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <common/compute/Kernels.h>
+#include <common/datatypes/ValueHash.h>
+#include <common/runtime/ClientRuntime.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nebula {
+namespace compute {
+
+// Small enough thresholds to run these on several threads
+static KernelOptions parallelOptions() {
+  KernelOptions opts;
+  opts.threads_ = 4;
+  opts.minRowsPerThread_ = 8;
+  return opts;
+}
+
+static KernelOptions serialOptions() {
+  KernelOptions opts;
+  opts.threads_ = 1;
+  return opts;
+}
+
+static DataSet makeDataSet(std::size_t rows, int64_t distinct) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int64_t> dist(0, distinct - 1);
+  DataSet ds({"k", "name", "v"});
+  for (std::size_t i = 0; i < rows; ++i) {
+    auto k = dist(gen);
+    ds.emplace_back(Row({k, "name_" + std::to_string(k % 7), static_cast<int64_t>(i % 13)}));
+  }
+  return ds;
+}
+
+TEST(KernelsTest, Sort) {
+  for (auto size : {0, 1, 5, 100, 1001}) {
+    auto ds = makeDataSet(size, 50);
+    auto expected = ds;
+    std::sort(expected.rows.begin(), expected.rows.end());
+    sort(&ds, {}, parallelOptions());
+    EXPECT_EQ(ds, expected) << "size " << size;
+  }
+
+  auto ds = makeDataSet(1000, 50);
+  sort(&ds, {{0, false}, {2, true}}, parallelOptions());
+  for (std::size_t i = 1; i < ds.rowSize(); ++i) {
+    const auto& prev = ds.rows[i - 1].values;
+    const auto& cur = ds.rows[i].values;
+    ASSERT_FALSE(prev[0] < cur[0]);
+    if (prev[0] == cur[0]) {
+      ASSERT_FALSE(cur[2] < prev[2]);
+    }
+  }
+}
+
+TEST(KernelsTest, Dedup) {
+  auto ds = makeDataSet(1000, 20);
+  auto expected = ds;
+  std::vector<Row> unique;
+  for (const auto& row : expected.rows) {
+    if (std::find(unique.begin(), unique.end(), row) == unique.end()) {
+      unique.emplace_back(row);
+    }
+  }
+  auto removed = dedup(&ds, parallelOptions());
+  EXPECT_EQ(removed, expected.rowSize() - unique.size());
+  EXPECT_EQ(ds.rows, unique);
+}
+
+TEST(KernelsTest, GroupBy) {
+  DataSet ds({"k", "v"});
+  ds.emplace_back(Row({1, 2}));
+  ds.emplace_back(Row({2, 5}));
+  ds.emplace_back(Row({1, Value::kNullValue}));
+  ds.emplace_back(Row({1, 4}));
+  ds.emplace_back(Row({3, Value::kNullValue}));
+
+  std::vector<Aggregate> aggs = {{AggFunc::COUNT_ALL, 0, "cnt"},
+                                 {AggFunc::COUNT, 1, "cnt_v"},
+                                 {AggFunc::SUM, 1, "sum"},
+                                 {AggFunc::MIN, 1, "min"},
+                                 {AggFunc::MAX, 1, "max"},
+                                 {AggFunc::AVG, 1, "avg"}};
+  auto result = groupBy(ds, {0}, aggs, serialOptions());
+  sort(&result);
+
+  DataSet expected({"k", "cnt", "cnt_v", "sum", "min", "max", "avg"});
+  expected.emplace_back(Row({1, 3, 2, 6, 2, 4, 3.0}));
+  expected.emplace_back(Row({2, 1, 1, 5, 5, 5, 5.0}));
+  expected.emplace_back(Row({3,
+                             1,
+                             0,
+                             Value::kNullValue,
+                             Value::kNullValue,
+                             Value::kNullValue,
+                             Value::kNullValue}));
+  EXPECT_EQ(result, expected);
+
+  // Same result on multiple threads
+  auto big = makeDataSet(1000, 30);
+  auto serial = groupBy(big, {0, 1}, aggs, serialOptions());
+  auto parallel = groupBy(big, {0, 1}, aggs, parallelOptions());
+  sort(&serial);
+  sort(&parallel);
+  EXPECT_EQ(serial, parallel);
+  EXPECT_EQ(serial.rowSize(), 30);
+}
+
+TEST(KernelsTest, HashJoin) {
+  DataSet left({"id", "name"});
+  left.emplace_back(Row({1, "a"}));
+  left.emplace_back(Row({2, "b"}));
+  left.emplace_back(Row({Value::kNullValue, "c"}));
+  left.emplace_back(Row({1, "d"}));
+  DataSet right({"rid", "score"});
+  right.emplace_back(Row({1, 10}));
+  right.emplace_back(Row({3, 30}));
+  right.emplace_back(Row({Value::kNullValue, 0}));
+
+  auto result = hashJoin(left, right, {0}, {0}, serialOptions());
+  DataSet expected({"id", "name", "rid", "score"});
+  expected.emplace_back(Row({1, "a", 1, 10}));
+  expected.emplace_back(Row({1, "d", 1, 10}));
+  EXPECT_EQ(result, expected);
+
+  EXPECT_TRUE(hashJoin(left, right, {0, 1}, {0}).colNames.empty());
+
+  // Same result on multiple threads, in the order of left
+  auto big = makeDataSet(1000, 100);
+  auto other = makeDataSet(300, 100);
+  auto serial = hashJoin(big, other, {0}, {0}, serialOptions());
+  auto parallel = hashJoin(big, other, {0}, {0}, parallelOptions());
+  sort(&serial);
+  sort(&parallel);
+  EXPECT_EQ(serial, parallel);
+}
+
+// The numbers within kEpsilon of each other are equal by operator==, but not
+// by the hash, so they are different keys
+TEST(KernelsTest, ExactNumbers) {
+  const int64_t big = (int64_t(1) << 53) + 1;
+  const double bigFloat = 9007199254740992.0;  // 2^53
+  std::vector<Value> numbers = {0.1 + 0.2, 0.3, 1, 1.0, big, bigFloat};
+  ASSERT_TRUE(Value(0.1 + 0.2) == Value(0.3));
+  ASSERT_TRUE(Value(big) == Value(bigFloat));
+  for (const auto& lhs : numbers) {
+    for (const auto& rhs : numbers) {
+      if (hashEqual(lhs, rhs)) {
+        EXPECT_EQ(hashValue(lhs), hashValue(rhs)) << lhs << " " << rhs;
+      }
+    }
+  }
+  EXPECT_TRUE(hashEqual(Value(1), Value(1.0)));
+  EXPECT_FALSE(hashEqual(Value(0.1 + 0.2), Value(0.3)));
+  EXPECT_FALSE(hashEqual(Value(big), Value(bigFloat)));
+
+  DataSet ds({"v"});
+  for (int i = 0; i < 10; ++i) {
+    for (const auto& v : numbers) {
+      ds.emplace_back(Row({v}));
+    }
+  }
+  for (const auto& opts : {serialOptions(), parallelOptions()}) {
+    auto deduped = ds;
+    EXPECT_EQ(dedup(&deduped, opts), ds.rowSize() - 5);
+    DataSet expected({"v"});
+    for (const auto& v : {Value(0.1 + 0.2), Value(0.3), Value(1), Value(big), Value(bigFloat)}) {
+      expected.emplace_back(Row({v}));
+    }
+    EXPECT_EQ(deduped.rows, expected.rows);
+
+    auto groups = groupBy(ds, {0}, {{AggFunc::COUNT_ALL, 0, "cnt"}}, opts);
+    EXPECT_EQ(groups.rowSize(), 5);
+
+    DataSet left({"l"});
+    left.emplace_back(Row({0.3}));
+    left.emplace_back(Row({1}));
+    left.emplace_back(Row({big}));
+    DataSet right({"r"});
+    right.emplace_back(Row({0.1 + 0.2}));
+    right.emplace_back(Row({1.0}));
+    right.emplace_back(Row({bigFloat}));
+    auto joined = hashJoin(left, right, {0}, {0}, opts);
+    DataSet matched({"l", "r"});
+    matched.emplace_back(Row({1, 1.0}));
+    EXPECT_EQ(joined, matched);
+  }
+}
+
+TEST(KernelsTest, Runtime) {
+  RuntimeConfig config;
+  config.ioThreads_ = 1;
+  config.cpuThreads_ = 2;
+  ClientRuntime runtime(config);
+  auto opts = parallelOptions();
+  opts.runtime_ = &runtime;
+
+  // Same results on the workers of the runtime
+  auto ds = makeDataSet(1000, 30);
+  auto expected = ds;
+  sort(&expected, {}, serialOptions());
+  auto sorted = ds;
+  sort(&sorted, {}, opts);
+  EXPECT_EQ(sorted, expected);
+
+  std::vector<Aggregate> aggs = {{AggFunc::COUNT_ALL, 0, "cnt"}, {AggFunc::SUM, 2, "sum"}};
+  auto serial = groupBy(ds, {0}, aggs, serialOptions());
+  auto parallel = groupBy(ds, {0}, aggs, opts);
+  sort(&serial);
+  sort(&parallel);
+  EXPECT_EQ(serial, parallel);
+
+  // The threads of the runtime by default
+  opts.threads_ = 0;
+  auto deduped = ds;
+  auto serialDeduped = ds;
+  EXPECT_EQ(dedup(&deduped, opts), dedup(&serialDeduped, serialOptions()));
+  EXPECT_EQ(deduped, serialDeduped);
+}
+
+}  // namespace compute
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
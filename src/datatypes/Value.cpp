@@ -19,70 +19,13 @@
 #include "common/datatypes/Map.h"
 #include "common/datatypes/Path.h"
 #include "common/datatypes/Set.h"
+#include "common/datatypes/ValueHash.h"
 #include "common/datatypes/Vertex.h"
 
 namespace std {
 
 std::size_t hash<nebula::Value>::operator()(const nebula::Value& v) const noexcept {
-  switch (v.type()) {
-    case nebula::Value::Type::__EMPTY__: {
-      return 0;
-    }
-    case nebula::Value::Type::NULLVALUE: {
-      return ~0UL;
-    }
-    case nebula::Value::Type::BOOL: {
-      return hash<bool>()(v.getBool());
-    }
-    case nebula::Value::Type::INT: {
-      return hash<int64_t>()(v.getInt());
-    }
-    case nebula::Value::Type::FLOAT: {
-      return hash<double>()(v.getFloat());
-    }
-    case nebula::Value::Type::STRING: {
-      return hash<string>()(v.getStr());
-    }
-    case nebula::Value::Type::DATE: {
-      return hash<nebula::Date>()(v.getDate());
-    }
-    case nebula::Value::Type::TIME: {
-      return hash<nebula::Time>()(v.getTime());
-    }
-    case nebula::Value::Type::DATETIME: {
-      return hash<nebula::DateTime>()(v.getDateTime());
-    }
-    case nebula::Value::Type::VERTEX: {
-      return hash<nebula::Vertex>()(v.getVertex());
-    }
-    case nebula::Value::Type::EDGE: {
-      return hash<nebula::Edge>()(v.getEdge());
-    }
-    case nebula::Value::Type::PATH: {
-      return hash<nebula::Path>()(v.getPath());
-    }
-    case nebula::Value::Type::LIST: {
-      return hash<nebula::List>()(v.getList());
-    }
-    case nebula::Value::Type::GEOGRAPHY: {
-      return hash<nebula::Geography>()(v.getGeography());
-    }
-    case nebula::Value::Type::MAP: {
-      return hash<nebula::Map>()(v.getMap());
-    }
-    case nebula::Value::Type::SET: {
-      return hash<nebula::Set>()(v.getSet());
-    }
-    case nebula::Value::Type::DURATION: {
-      return hash<nebula::Duration>()(v.getDuration());
-    }
-    case nebula::Value::Type::DATASET: {
-      LOG(FATAL) << "Hash for DATASET has not been implemented";
-    }
-    default: {
-      LOG(FATAL) << "Unknown type";
-    }
-  }
+  return nebula::hashValue(v);
 }
 
 }  // namespace std
@@ -211,7 +154,7 @@ Value::Value(const Value& rhs) : type_(Value::Type::__EMPTY__) {
       break;
     }
     case Type::STRING: {
-      setS(*rhs.value_.sVal);
+      setS(rhs.value_.sVal);
       break;
     }
     case Type::DATE: {
@@ -887,7 +830,11 @@ double& Value::mutableFloat() {
 
 std::string& Value::mutableStr() {
   CHECK_EQ(type_, Type::STRING);
+#ifdef NEBULA_COMPACT_VALUE
+  return value_.sVal.mutableRef();
+#else
   return *value_.sVal;
+#endif
 }
 
 Date& Value::mutableDate() {
@@ -980,7 +927,11 @@ double Value::moveFloat() {
 
 std::string Value::moveStr() {
   CHECK_EQ(type_, Type::STRING);
+#ifdef NEBULA_COMPACT_VALUE
+  std::string v = value_.sVal.take();
+#else
   std::string v = std::move(*value_.sVal);
+#endif
   clear();
   return v;
 }
@@ -1258,7 +1209,7 @@ Value& Value::operator=(const Value& rhs) {
       break;
     }
     case Type::STRING: {
-      setS(*rhs.value_.sVal);
+      setS(rhs.value_.sVal);
       break;
     }
     case Type::DATE: {
@@ -1358,24 +1309,40 @@ void Value::setF(double&& v) {
   new (std::addressof(value_.fVal)) double(std::move(v));  // NOLINT
 }
 
-void Value::setS(std::unique_ptr<std::string> v) {
+void Value::setS(const StrPayload& v) {
+  type_ = Type::STRING;
+#ifdef NEBULA_COMPACT_VALUE
+  new (std::addressof(value_.sVal)) StrPayload(v);
+#else
+  new (std::addressof(value_.sVal)) StrPayload(new std::string(*v));
+#endif
+}
+
+void Value::setS(StrPayload&& v) {
   type_ = Type::STRING;
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(std::move(v));
+  new (std::addressof(value_.sVal)) StrPayload(std::move(v));
 }
 
 void Value::setS(const std::string& v) {
   type_ = Type::STRING;
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(v));
+#ifdef NEBULA_COMPACT_VALUE
+  new (std::addressof(value_.sVal)) StrPayload(v);
+#else
+  new (std::addressof(value_.sVal)) StrPayload(new std::string(v));
+#endif
 }
 
 void Value::setS(std::string&& v) {
   type_ = Type::STRING;
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(std::move(v)));
+#ifdef NEBULA_COMPACT_VALUE
+  new (std::addressof(value_.sVal)) StrPayload(std::move(v));
+#else
+  new (std::addressof(value_.sVal)) StrPayload(new std::string(std::move(v)));
+#endif
 }
 
 void Value::setS(const char* v) {
-  type_ = Type::STRING;
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(v));
+  setS(std::string(v));
 }
 
 void Value::setD(const Date& v) {
@@ -0,0 +1,241 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/datatypes/ValueHash.h"
+
+#include <folly/hash/SpookyHashV2.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/Duration.h"
+#include "common/datatypes/Edge.h"
+#include "common/datatypes/Geography.h"
+#include "common/datatypes/Map.h"
+#include "common/datatypes/Path.h"
+#include "common/datatypes/Set.h"
+#include "common/datatypes/Vertex.h"
+
+namespace nebula {
+
+namespace {
+
+// Salt the payload with its type, so e.g. a date and a time with the same
+// fields don't collide
+inline uint64_t hashTyped(Value::Type type, uint64_t payload) {
+  return hashMix(payload ^ (static_cast<uint64_t>(type) * kHashSeed));
+}
+
+inline uint64_t hashInt(int64_t i) {
+  return hashTyped(Value::Type::INT, static_cast<uint64_t>(i));
+}
+
+// INT and FLOAT which are hashEqual must hash the same, so an integral FLOAT in
+// the range of int64 is hashed as that INT, and the other FLOATs by their
+// bits. INTs keep all their bits, e.g. those above 2^53, which a double can't
+// tell apart.
+inline uint64_t hashFloat(double d) {
+  // [-2^63, 2^63), -0.0 is hashed as 0
+  if (d >= -9223372036854775808.0 && d < 9223372036854775808.0 && std::trunc(d) == d) {
+    return hashInt(static_cast<int64_t>(d));
+  }
+  if (std::isnan(d)) {
+    d = std::numeric_limits<double>::quiet_NaN();
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &d, sizeof(bits));
+  return hashTyped(Value::Type::FLOAT, bits);
+}
+
+// Whether the FLOAT is the INT, i.e. hashFloat(f) is hashInt(i)
+inline bool sameNumber(double f, int64_t i) {
+  return f >= -9223372036854775808.0 && f < 9223372036854775808.0 && std::trunc(f) == f &&
+         static_cast<int64_t>(f) == i;
+}
+
+inline bool hashEqualValues(const std::vector<Value>& lhs, const std::vector<Value>& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    if (!hashEqual(lhs[i], rhs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline uint64_t hashBytes(const std::string& str) {
+  return folly::hash::SpookyHashV2::Hash64(str.data(), str.size(), kHashSeed);
+}
+
+inline uint64_t hashValues(const std::vector<Value>& values) {
+  uint64_t seed = kHashSeed;
+  for (const auto& v : values) {
+    seed = hashCombine(seed, hashValue(v));
+  }
+  return seed;
+}
+
+}  // namespace
+
+uint64_t hashValue(const Value& v) {
+  auto type = v.type();
+  switch (type) {
+    case Value::Type::__EMPTY__:
+    case Value::Type::NULLVALUE: {
+      // All nulls are equal
+      return hashTyped(type, 0);
+    }
+    case Value::Type::BOOL: {
+      return hashTyped(type, v.getBool());
+    }
+    case Value::Type::INT: {
+      return hashInt(v.getInt());
+    }
+    case Value::Type::FLOAT: {
+      return hashFloat(v.getFloat());
+    }
+    case Value::Type::STRING: {
+      return hashBytes(v.getStr());
+    }
+    case Value::Type::DATE: {
+      const auto& d = v.getDate();
+      return hashTyped(type,
+                       (static_cast<uint64_t>(static_cast<uint16_t>(d.year)) << 16) |
+                           (static_cast<uint64_t>(static_cast<uint8_t>(d.month)) << 8) |
+                           static_cast<uint8_t>(d.day));
+    }
+    case Value::Type::TIME: {
+      const auto& t = v.getTime();
+      return hashTyped(type,
+                       (static_cast<uint64_t>(static_cast<uint8_t>(t.hour)) << 48) |
+                           (static_cast<uint64_t>(static_cast<uint8_t>(t.minute)) << 40) |
+                           (static_cast<uint64_t>(static_cast<uint8_t>(t.sec)) << 32) |
+                           static_cast<uint32_t>(t.microsec));
+    }
+    case Value::Type::DATETIME: {
+      // All fields are packed into the qword
+      return hashTyped(type, v.getDateTime().qword);
+    }
+    case Value::Type::VERTEX: {
+      return hashTyped(type, std::hash<Vertex>()(v.getVertex()));
+    }
+    case Value::Type::EDGE: {
+      return hashTyped(type, std::hash<Edge>()(v.getEdge()));
+    }
+    case Value::Type::PATH: {
+      return hashTyped(type, std::hash<Path>()(v.getPath()));
+    }
+    case Value::Type::LIST: {
+      return hashTyped(type, hashValues(v.getList().values));
+    }
+    case Value::Type::MAP: {
+      return hashTyped(type, std::hash<Map>()(v.getMap()));
+    }
+    case Value::Type::SET: {
+      return hashTyped(type, std::hash<Set>()(v.getSet()));
+    }
+    case Value::Type::DATASET: {
+      const auto& ds = v.getDataSet();
+      uint64_t seed = kHashSeed;
+      for (const auto& col : ds.colNames) {
+        seed = hashCombine(seed, hashBytes(col));
+      }
+      for (const auto& row : ds.rows) {
+        seed = hashCombine(seed, hashValues(row.values));
+      }
+      return hashTyped(type, seed);
+    }
+    case Value::Type::GEOGRAPHY: {
+      return hashTyped(type, std::hash<Geography>()(v.getGeography()));
+    }
+    case Value::Type::DURATION: {
+      return hashTyped(type, std::hash<Duration>()(v.getDuration()));
+    }
+  }
+  LOG(FATAL) << "Unknown type " << static_cast<uint64_t>(type);
+  return 0;
+}
+
+bool hashEqual(const Value& lhs, const Value& rhs) {
+  auto lType = lhs.type();
+  auto rType = rhs.type();
+  if (lType == Value::Type::INT && rType == Value::Type::INT) {
+    return lhs.getInt() == rhs.getInt();
+  }
+  if (lType == Value::Type::FLOAT && rType == Value::Type::FLOAT) {
+    auto l = lhs.getFloat();
+    auto r = rhs.getFloat();
+    return l == r || (std::isnan(l) && std::isnan(r));
+  }
+  if (lType == Value::Type::INT && rType == Value::Type::FLOAT) {
+    return sameNumber(rhs.getFloat(), lhs.getInt());
+  }
+  if (lType == Value::Type::FLOAT && rType == Value::Type::INT) {
+    return sameNumber(lhs.getFloat(), rhs.getInt());
+  }
+  if (lType != rType) {
+    return false;
+  }
+  if (lType == Value::Type::LIST) {
+    return hashEqualValues(lhs.getList().values, rhs.getList().values);
+  }
+  if (lType == Value::Type::DATASET) {
+    const auto& l = lhs.getDataSet();
+    const auto& r = rhs.getDataSet();
+    if (l.colNames != r.colNames || l.rows.size() != r.rows.size()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < l.rows.size(); ++i) {
+      if (!hashEqualRows(l.rows[i], r.rows[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return lhs == rhs;
+}
+
+bool hashEqualRows(const Row& lhs, const Row& rhs) {
+  return hashEqualValues(lhs.values, rhs.values);
+}
+
+uint64_t hashRow(const Row& row) {
+  return hashValues(row.values);
+}
+
+uint64_t hashRow(const Row& row, const std::vector<std::size_t>& columns) {
+  uint64_t seed = kHashSeed;
+  for (auto column : columns) {
+    seed = hashCombine(seed, hashValue(row.values[column]));
+  }
+  return seed;
+}
+
+void hashRows(const Row* rows, std::size_t n, uint64_t* hashes) {
+  for (std::size_t i = 0; i < n; ++i) {
+    hashes[i] = hashValues(rows[i].values);
+  }
+}
+
+void hashRows(const Row* rows,
+              std::size_t n,
+              const std::vector<std::size_t>& columns,
+              uint64_t* hashes) {
+  std::fill(hashes, hashes + n, kHashSeed);
+  for (auto column : columns) {
+    for (std::size_t i = 0; i < n; ++i) {
+      hashes[i] = hashCombine(hashes[i], hashValue(rows[i].values[column]));
+    }
+  }
+}
+
+}  // namespace nebula
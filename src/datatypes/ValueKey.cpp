@@ -0,0 +1,178 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/datatypes/ValueKey.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "common/datatypes/Date.h"
+
+namespace nebula {
+
+namespace {
+
+// Terminates a list, less than any tag
+constexpr char kListEnd = 0x00;
+
+// The bit of the type plus one, so the tags keep the order of the types
+char tagOf(Value::Type type) {
+  return static_cast<char>(__builtin_ctzll(static_cast<uint64_t>(type)) + 1);
+}
+
+void appendBigEndian(uint64_t v, std::size_t bytes, std::string* key) {
+  for (std::size_t i = bytes; i > 0; --i) {
+    key->push_back(static_cast<char>((v >> ((i - 1) * 8)) & 0xFF));
+  }
+}
+
+// Flip the sign bit so that negative numbers come first
+void appendSigned(int64_t v, std::size_t bytes, std::string* key) {
+  uint64_t u = static_cast<uint64_t>(v) ^ (1ULL << (bytes * 8 - 1));
+  appendBigEndian(u, bytes, key);
+}
+
+void appendDouble(double d, std::string* key) {
+  if (d == 0.0) {
+    d = 0.0;
+  } else if (std::isnan(d)) {
+    // NaN is compared false both ways, put it after +inf
+    d = std::numeric_limits<double>::quiet_NaN();
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &d, sizeof(bits));
+  // Negative numbers are stored as magnitude, so invert them entirely
+  bits = (bits & (1ULL << 63)) ? ~bits : bits ^ (1ULL << 63);
+  appendBigEndian(bits, 8, key);
+}
+
+// 0x00 is escaped as 0x00 0xFF and the string ends with 0x00 0x00, so a
+// string sorts before any longer string it is a prefix of
+void appendString(const std::string& str, std::string* key) {
+  key->reserve(key->size() + str.size() + 2);
+  for (auto c : str) {
+    key->push_back(c);
+    if (c == '\0') {
+      key->push_back('\xFF');
+    }
+  }
+  key->push_back('\0');
+  key->push_back('\0');
+}
+
+bool append(const Value& v, std::string* key) {
+  auto type = v.type();
+  switch (type) {
+    case Value::Type::__EMPTY__:
+    case Value::Type::NULLVALUE: {
+      key->push_back(tagOf(type));
+      return true;
+    }
+    case Value::Type::BOOL: {
+      key->push_back(tagOf(type));
+      key->push_back(v.getBool() ? 1 : 0);
+      return true;
+    }
+    case Value::Type::INT: {
+      // Compared with FLOAT as double first, then exactly with INT
+      key->push_back(tagOf(Value::Type::INT));
+      appendDouble(static_cast<double>(v.getInt()), key);
+      key->push_back(1);
+      appendSigned(v.getInt(), 8, key);
+      return true;
+    }
+    case Value::Type::FLOAT: {
+      key->push_back(tagOf(Value::Type::INT));
+      appendDouble(v.getFloat(), key);
+      key->push_back(0);
+      return true;
+    }
+    case Value::Type::STRING: {
+      key->push_back(tagOf(type));
+      appendString(v.getStr(), key);
+      return true;
+    }
+    case Value::Type::DATE: {
+      const auto& d = v.getDate();
+      key->push_back(tagOf(type));
+      appendSigned(d.year, 2, key);
+      appendSigned(d.month, 1, key);
+      appendSigned(d.day, 1, key);
+      return true;
+    }
+    case Value::Type::TIME: {
+      const auto& t = v.getTime();
+      key->push_back(tagOf(type));
+      appendSigned(t.hour, 1, key);
+      appendSigned(t.minute, 1, key);
+      appendSigned(t.sec, 1, key);
+      appendSigned(t.microsec, 4, key);
+      return true;
+    }
+    case Value::Type::DATETIME: {
+      const auto& dt = v.getDateTime();
+      key->push_back(tagOf(type));
+      appendSigned(dt.year, 2, key);
+      appendBigEndian(dt.month, 1, key);
+      appendBigEndian(dt.day, 1, key);
+      appendBigEndian(dt.hour, 1, key);
+      appendBigEndian(dt.minute, 1, key);
+      appendBigEndian(dt.sec, 1, key);
+      appendBigEndian(dt.microsec, 3, key);
+      return true;
+    }
+    case Value::Type::LIST: {
+      key->push_back(tagOf(type));
+      for (const auto& item : v.getList().values) {
+        if (!append(item, key)) {
+          return false;
+        }
+      }
+      key->push_back(kListEnd);
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+void invert(std::string* key, std::size_t from) {
+  for (auto i = from; i < key->size(); ++i) {
+    (*key)[i] = static_cast<char>(~(*key)[i]);
+  }
+}
+
+}  // namespace
+
+bool appendSortKey(const Value& v, std::string* key, bool descending) {
+  auto start = key->size();
+  if (!append(v, key)) {
+    key->resize(start);
+    return false;
+  }
+  if (descending) {
+    invert(key, start);
+  }
+  return true;
+}
+
+bool appendSortKey(const std::vector<Value>& values, std::string* key, bool descending) {
+  auto start = key->size();
+  for (const auto& v : values) {
+    if (!append(v, key)) {
+      key->resize(start);
+      return false;
+    }
+  }
+  key->push_back(kListEnd);
+  if (descending) {
+    invert(key, start);
+  }
+  return true;
+}
+
+}  // namespace nebula
@@ -0,0 +1,136 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/DataSetView.h"
+
+namespace nebula {
+
+static constexpr std::size_t kRows = 10000;
+static constexpr std::size_t kCols = 16;
+
+static DataSet makeDataSet() {
+  std::vector<std::string> colNames;
+  for (std::size_t c = 0; c < kCols; ++c) {
+    colNames.emplace_back("col_" + std::to_string(c));
+  }
+  DataSet ds(std::move(colNames));
+  for (std::size_t r = 0; r < kRows; ++r) {
+    std::vector<Value> values;
+    for (std::size_t c = 0; c < kCols; ++c) {
+      if (c % 2 == 0) {
+        values.emplace_back(static_cast<int64_t>(r * kCols + c));
+      } else {
+        values.emplace_back("value_" + std::to_string(r));
+      }
+    }
+    ds.emplace_back(Row(std::move(values)));
+  }
+  return ds;
+}
+
+static const DataSet kDataSet = makeDataSet();
+// The last columns are the worst case of the linear search in colValues
+static const std::string kIntCol = "col_14";
+static const std::string kStrCol = "col_15";
+
+BENCHMARK(sumIntByColValues, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    int64_t sum = 0;
+    for (const auto& v : kDataSet.colValues(kIntCol)) {
+      sum += v.getInt();
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+}
+
+BENCHMARK_RELATIVE(sumIntByColumnView, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    DataSetView view(kDataSet);
+    int64_t sum = 0;
+    for (auto v : view.column<int64_t>(kIntCol)) {
+      sum += v;
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+}
+
+BENCHMARK_RELATIVE(sumIntByExtract, iters) {
+  std::vector<int64_t> ints;
+  for (std::size_t i = 0; i < iters; ++i) {
+    DataSetView view(kDataSet);
+    ints.clear();
+    view.column<int64_t>(kIntCol).extract(&ints);
+    int64_t sum = 0;
+    for (auto v : ints) {
+      sum += v;
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(strLenByColValues, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    std::size_t len = 0;
+    for (const auto& v : kDataSet.colValues(kStrCol)) {
+      len += v.getStr().size();
+    }
+    folly::doNotOptimizeAway(len);
+  }
+}
+
+BENCHMARK_RELATIVE(strLenByColumnView, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    DataSetView view(kDataSet);
+    std::size_t len = 0;
+    for (const auto& s : view.column<std::string>(kStrCol)) {
+      len += s.size();
+    }
+    folly::doNotOptimizeAway(len);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+// Look up a cell by name in every row
+BENCHMARK(cellByColValues, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    int64_t sum = 0;
+    for (std::size_t r = 0; r < kDataSet.rowSize(); ++r) {
+      const auto& names = kDataSet.colNames;
+      auto index = std::find(names.begin(), names.end(), kIntCol) - names.begin();
+      sum += kDataSet.rows[r].values[index].getInt();
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+}
+
+BENCHMARK_RELATIVE(cellByRowView, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    DataSetView view(kDataSet);
+    int64_t sum = 0;
+    for (std::size_t r = 0; r < view.rowSize(); ++r) {
+      sum += *view.row(r).get<int64_t>(kIntCol);
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
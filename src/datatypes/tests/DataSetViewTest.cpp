@@ -0,0 +1,101 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <common/datatypes/DataSetView.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace nebula {
+
+static DataSet makeDataSet() {
+  DataSet ds({"id", "name", "score"});
+  ds.emplace_back(Row({1, "Tim", 9.5}));
+  ds.emplace_back(Row({2, "Tony", Value::kNullValue}));
+  ds.emplace_back(Row({3, "Tom", 7.0}));
+  return ds;
+}
+
+TEST(DataSetViewTest, Column) {
+  auto ds = makeDataSet();
+  DataSetView view(ds);
+  EXPECT_EQ(view.rowSize(), 3);
+  EXPECT_EQ(view.colSize(), 3);
+  EXPECT_EQ(view.colIndex("name"), 1);
+  EXPECT_EQ(view.colIndex("unknown"), -1);
+
+  auto ids = view.column<int64_t>("id");
+  ASSERT_TRUE(ids.valid());
+  ASSERT_TRUE(ids.allOf());
+  EXPECT_EQ(ids.size(), 3);
+  EXPECT_EQ(ids[2], 3);
+  // no copy, refer to the value in the data set
+  EXPECT_EQ(&ids[0], &ds.rows[0].values[0].getInt());
+
+  std::vector<int64_t> got;
+  for (auto id : ids) {
+    got.emplace_back(id);
+  }
+  EXPECT_EQ(got, std::vector<int64_t>({1, 2, 3}));
+
+  got.clear();
+  ASSERT_TRUE(ids.extract(&got));
+  EXPECT_EQ(got, std::vector<int64_t>({1, 2, 3}));
+
+  int64_t buf[3];
+  ASSERT_TRUE(ids.extract(buf, 3));
+  EXPECT_EQ(buf[1], 2);
+  EXPECT_FALSE(ids.extract(buf, 2));
+
+  // type checked
+  auto scores = view.column<double>("score");
+  EXPECT_FALSE(scores.allOf());
+  EXPECT_TRUE(scores.isNull(1));
+  EXPECT_EQ(scores.get(1), nullptr);
+  ASSERT_NE(scores.get(0), nullptr);
+  EXPECT_EQ(*scores.get(0), 9.5);
+  std::vector<double> dbls;
+  EXPECT_FALSE(scores.extract(&dbls));
+  EXPECT_TRUE(dbls.empty());
+
+  EXPECT_FALSE(view.column<std::string>("id").allOf());
+  EXPECT_FALSE(view.column<int64_t>("unknown").valid());
+  EXPECT_EQ(view.column<int64_t>("unknown").size(), 0);
+
+  // same as colValues
+  auto names = view.column("name");
+  auto expected = ds.colValues("name");
+  ASSERT_EQ(names.size(), expected.size());
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    EXPECT_EQ(names[i], expected[i]);
+  }
+}
+
+TEST(DataSetViewTest, Row) {
+  auto ds = makeDataSet();
+  DataSetView view(ds);
+  auto row = view.row(1);
+  EXPECT_EQ(row.size(), 3);
+  EXPECT_EQ(row[0], Value(2));
+  EXPECT_EQ(row["name"], Value("Tony"));
+  EXPECT_TRUE(row["unknown"].empty());
+  ASSERT_NE(row.get<std::string>("name"), nullptr);
+  EXPECT_EQ(*row.get<std::string>("name"), "Tony");
+  EXPECT_EQ(row.get<int64_t>("name"), nullptr);
+  EXPECT_EQ(row.get<double>("score"), nullptr);
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/datatypes/Date.h"
+#include "common/datatypes/List.h"
+#include "common/datatypes/Value.h"
+#include "common/datatypes/ValueHash.h"
+#include "common/datatypes/ValueKey.h"
+
+// Run once with the default build and once with -DENABLE_COMPACT_VALUE=ON to
+// compare the two Value layouts.
+
+namespace nebula {
+
+static const Value kInt(static_cast<int64_t>(1234567));
+static const Value kDateTime(DateTime(2022, 2, 22, 12, 30, 45, 123456));
+static const Value kShortStr("player100");
+static const Value kLongStr(std::string(64, 'x'));
+
+static List makeRow() {
+  std::vector<Value> values;
+  for (int i = 0; i < 8; ++i) {
+    values.emplace_back("name_" + std::to_string(i));
+    values.emplace_back(static_cast<int64_t>(i));
+  }
+  return List(std::move(values));
+}
+
+static const List kRow = makeRow();
+
+static void copyValue(const Value& v, size_t iters) {
+  for (size_t i = 0; i < iters; ++i) {
+    Value copy(v);
+    folly::doNotOptimizeAway(copy);
+  }
+}
+
+static void moveValue(const Value& v, size_t iters) {
+  Value src;
+  BENCHMARK_SUSPEND {
+    src = v;
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    Value dst(std::move(src));
+    src = std::move(dst);
+    folly::doNotOptimizeAway(src);
+  }
+}
+
+static void hashValue(const Value& v, size_t iters) {
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(std::hash<Value>()(v));
+  }
+}
+
+BENCHMARK(copyInt, iters) {
+  copyValue(kInt, iters);
+}
+
+BENCHMARK_RELATIVE(copyDateTime, iters) {
+  copyValue(kDateTime, iters);
+}
+
+BENCHMARK_RELATIVE(copyShortStr, iters) {
+  copyValue(kShortStr, iters);
+}
+
+BENCHMARK_RELATIVE(copyLongStr, iters) {
+  copyValue(kLongStr, iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(moveInt, iters) {
+  moveValue(kInt, iters);
+}
+
+BENCHMARK_RELATIVE(moveShortStr, iters) {
+  moveValue(kShortStr, iters);
+}
+
+BENCHMARK_RELATIVE(moveLongStr, iters) {
+  moveValue(kLongStr, iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(hashInt, iters) {
+  hashValue(kInt, iters);
+}
+
+BENCHMARK_RELATIVE(hashDateTime, iters) {
+  hashValue(kDateTime, iters);
+}
+
+BENCHMARK_RELATIVE(hashShortStr, iters) {
+  hashValue(kShortStr, iters);
+}
+
+BENCHMARK_RELATIVE(hashLongStr, iters) {
+  hashValue(kLongStr, iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(copyRow, iters) {
+  for (size_t i = 0; i < iters; ++i) {
+    List copy(kRow);
+    folly::doNotOptimizeAway(copy);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+static const std::vector<Row> kRows(4096, kRow);
+
+BENCHMARK(hashRowsOneByOne, iters) {
+  for (size_t i = 0; i < iters; ++i) {
+    for (const auto& row : kRows) {
+      folly::doNotOptimizeAway(std::hash<List>()(row));
+    }
+  }
+}
+
+BENCHMARK_RELATIVE(hashRowsBatch, iters) {
+  std::vector<uint64_t> hashes(kRows.size());
+  for (size_t i = 0; i < iters; ++i) {
+    hashRows(kRows.data(), kRows.size(), {0, 1, 2, 3}, hashes.data());
+    folly::doNotOptimizeAway(hashes);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(compareRows, iters) {
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(kRow < kRows[i % kRows.size()]);
+  }
+}
+
+BENCHMARK_RELATIVE(compareSortKeys, iters) {
+  std::string lhs, rhs;
+  BENCHMARK_SUSPEND {
+    appendSortKey(kRow.values, &lhs);
+    appendSortKey(kRows[0].values, &rhs);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(lhs < rhs);
+  }
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+#ifdef NEBULA_COMPACT_VALUE
+  std::cout << "Value layout: compact" << std::endl;
+#else
+  std::cout << "Value layout: default" << std::endl;
+#endif
+  std::cout << "sizeof(Value): " << sizeof(nebula::Value) << std::endl;
+  std::cout << "sizeof(Date): " << sizeof(nebula::Date) << ", sizeof(Time): " << sizeof(nebula::Time)
+            << ", sizeof(DateTime): " << sizeof(nebula::DateTime) << std::endl;
+  folly::runBenchmarks();
+  return 0;
+}
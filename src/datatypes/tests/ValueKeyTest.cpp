@@ -0,0 +1,157 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <common/datatypes/Date.h>
+#include <common/datatypes/DataSet.h>
+#include <common/datatypes/ValueHash.h>
+#include <common/datatypes/ValueKey.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace nebula {
+
+static std::vector<Value> values() {
+  return {Value(),
+          Value::kNullValue,
+          Value::kNullNaN,
+          true,
+          false,
+          0,
+          -1,
+          1,
+          2,
+          int64_t(1) << 53,
+          (int64_t(1) << 53) + 1,
+          std::numeric_limits<int64_t>::min(),
+          std::numeric_limits<int64_t>::max(),
+          -0.0,
+          0.5,
+          -0.5,
+          1.0,
+          1e300,
+          -1e300,
+          "",
+          "a",
+          std::string("a\0", 2),
+          std::string("a\0b", 3),
+          "ab",
+          "b",
+          "\xff",
+          Date(2020, 1, 2),
+          Date(-5, 3, 4),
+          Date(2020, 12, 31),
+          Time(1, 2, 3, 4),
+          Time(23, 0, 0, 0),
+          DateTime(2020, 1, 2, 3, 4, 5, 6),
+          DateTime(-3, 1, 2, 3, 4, 5, 6),
+          DateTime(2020, 1, 2, 3, 4, 5, 7),
+          List({1, 2}),
+          List({1}),
+          List(),
+          List({1, "a"}),
+          List({List({1}), 2})};
+}
+
+TEST(ValueKeyTest, Order) {
+  auto vals = values();
+  for (const auto& a : vals) {
+    for (const auto& b : vals) {
+      for (bool descending : {false, true}) {
+        std::string ka, kb;
+        ASSERT_TRUE(appendSortKey(a, &ka, descending));
+        ASSERT_TRUE(appendSortKey(b, &kb, descending));
+        bool less = descending ? b < a : a < b;
+        if (less) {
+          EXPECT_LT(ka, kb) << a << " vs " << b << ", descending " << descending;
+        }
+        // Prefix free, the following values don't change the order
+        appendSortKey(Value(5), &ka);
+        appendSortKey(Value(-5), &kb);
+        if (less) {
+          EXPECT_LT(ka, kb) << a << " vs " << b << ", descending " << descending;
+        }
+      }
+    }
+  }
+}
+
+TEST(ValueKeyTest, Row) {
+  Row small({1, "b"});
+  Row big({1, "b", 0});
+  Row bigger({2});
+  std::string ks, kb, kbb;
+  ASSERT_TRUE(appendSortKey(small.values, &ks));
+  ASSERT_TRUE(appendSortKey(big.values, &kb));
+  ASSERT_TRUE(appendSortKey(bigger.values, &kbb));
+  EXPECT_LT(ks, kb);
+  EXPECT_LT(kb, kbb);
+}
+
+TEST(ValueKeyTest, Unsupported) {
+  std::string key = "prefix";
+  EXPECT_FALSE(appendSortKey(Value(DataSet()), &key));
+  EXPECT_FALSE(appendSortKey(Value(List({1, DataSet()})), &key));
+  EXPECT_EQ(key, "prefix");
+}
+
+TEST(ValueHashTest, Equality) {
+  auto vals = values();
+  for (const auto& a : vals) {
+    for (const auto& b : vals) {
+      // Floats are equal within an epsilon, which can't be hashed
+      if (a == b && !a.isFloat() && !b.isFloat()) {
+        EXPECT_EQ(hashValue(a), hashValue(b)) << a << " vs " << b;
+      }
+    }
+  }
+  EXPECT_EQ(hashValue(Value(1)), hashValue(Value(1.0)));
+  EXPECT_EQ(hashValue(Value(0.0)), hashValue(Value(-0.0)));
+  EXPECT_EQ(hashValue(Value(-3)), hashValue(Value(-3.0)));
+  EXPECT_EQ(hashValue(Value(int64_t(1) << 62)), hashValue(Value(std::ldexp(1.0, 62))));
+  EXPECT_NE(hashValue(Value(1)), hashValue(Value(1.5)));
+  // Ints which are the same as doubles still hash apart
+  int64_t big = (int64_t(1) << 60) + 1;
+  EXPECT_NE(hashValue(Value(big)), hashValue(Value(big + 1)));
+  // Out of the range of int64
+  EXPECT_EQ(hashValue(Value(std::ldexp(1.0, 63))), hashValue(Value(std::ldexp(1.0, 63))));
+  EXPECT_EQ(hashValue(Value(std::numeric_limits<double>::quiet_NaN())),
+            hashValue(Value(-std::numeric_limits<double>::quiet_NaN())));
+  EXPECT_EQ(std::hash<Value>()(Value("a")), hashValue(Value("a")));
+
+  // Data set is hashable as well
+  DataSet ds({"a"});
+  ds.emplace_back(Row({1}));
+  EXPECT_EQ(hashValue(Value(ds)), hashValue(Value(ds)));
+}
+
+TEST(ValueHashTest, Batch) {
+  std::vector<Row> rows = {Row({1, "a", 2.5}), Row({2, "b", Value::kNullValue})};
+  uint64_t hashes[2];
+  hashRows(rows.data(), rows.size(), {0, 2}, hashes);
+  EXPECT_EQ(hashes[0], hashRow(rows[0], {0, 2}));
+  EXPECT_EQ(hashes[1], hashRow(rows[1], {0, 2}));
+  EXPECT_NE(hashRow(rows[0], {0, 2}), hashRow(rows[0], {2, 0}));
+
+  hashRows(rows.data(), rows.size(), hashes);
+  EXPECT_EQ(hashes[0], hashRow(rows[0]));
+  EXPECT_EQ(hashes[1], hashRow(rows[1]));
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,358 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/graph/LazyExecutionResponse.h"
+
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <glog/logging.h>
+#include <thrift/lib/cpp/TApplicationException.h>
+#include <thrift/lib/cpp2/protocol/BinaryProtocol.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "common/datatypes/DataSetOps-inl.h"
+#include "common/datatypes/ValueOps-inl.h"
+#include "common/graph/PlanDescriptionOps-inl.h"
+
+namespace nebula {
+
+using apache::thrift::protocol::TType;
+
+LazyExecutionResponse::LazyExecutionResponse(std::unique_ptr<folly::IOBuf> buf,
+                                             uint16_t protocolId)
+    : buf_(std::move(buf)), protocolId_(protocolId) {
+  decodeHeader();
+}
+
+LazyExecutionResponse::LazyExecutionResponse(ErrorCode errorCode, const std::string &errorMsg)
+    : errorCode_(errorCode), errorMsg_(std::make_unique<std::string>(errorMsg)) {}
+
+LazyExecutionResponse::LazyExecutionResponse(LazyExecutionResponse &&) noexcept = default;
+
+LazyExecutionResponse &LazyExecutionResponse::operator=(LazyExecutionResponse &&) noexcept =
+    default;
+
+LazyExecutionResponse::~LazyExecutionResponse() = default;
+
+const std::vector<std::string> &LazyExecutionResponse::colNames() {
+  if (colNames_ != nullptr) {
+    return *colNames_;
+  }
+  colNames_ = std::make_unique<std::vector<std::string>>();
+  if (data_ != nullptr) {
+    *colNames_ = data_->colNames;
+  } else if (hasData_) {
+    readAt(dataOffset_, [this](auto *proto) { readColNames(proto, colNames_.get()); });
+  }
+  return *colNames_;
+}
+
+const DataSet *LazyExecutionResponse::data() {
+  if (data_ == nullptr && hasData_) {
+    auto ds = std::make_unique<DataSet>();
+    readAt(dataOffset_, [this, &ds](auto *proto) { readDataSet(proto, ds.get()); });
+    if (hasData_) {
+      data_ = std::move(ds);
+    }
+  }
+  return data_.get();
+}
+
+DataSet LazyExecutionResponse::data(const std::vector<std::string> &columns) {
+  DataSet ds;
+  if (data_ != nullptr) {
+    // Already decoded, just project it
+    std::vector<std::size_t> indexes;
+    for (const auto &col : columns) {
+      auto it = std::find(data_->colNames.begin(), data_->colNames.end(), col);
+      if (it != data_->colNames.end()) {
+        indexes.emplace_back(it - data_->colNames.begin());
+        ds.colNames.emplace_back(col);
+      }
+    }
+    ds.rows.reserve(data_->rows.size());
+    for (const auto &row : data_->rows) {
+      std::vector<Value> values;
+      values.reserve(indexes.size());
+      for (auto idx : indexes) {
+        values.emplace_back(idx < row.size() ? row.values[idx] : Value::kEmpty);
+      }
+      ds.rows.emplace_back(std::move(values));
+    }
+  } else if (hasData_) {
+    readAt(dataOffset_, [this, &columns, &ds](auto *proto) { readColumns(proto, columns, &ds); });
+  }
+  return ds;
+}
+
+const PlanDescription *LazyExecutionResponse::planDesc() {
+  if (planDesc_ == nullptr && hasPlanDesc_) {
+    auto planDesc = std::make_unique<PlanDescription>();
+    readAt(planDescOffset_,
+           [this, &planDesc](auto *proto) { readPlanDesc(proto, planDesc.get()); });
+    if (hasPlanDesc_) {
+      planDesc_ = std::move(planDesc);
+    }
+  }
+  return planDesc_.get();
+}
+
+ExecutionResponse LazyExecutionResponse::toExecutionResponse() && {
+  data();
+  planDesc();
+  ExecutionResponse resp;
+  resp.errorCode = errorCode_;
+  resp.latencyInUs = latencyInUs_;
+  resp.data = std::move(data_);
+  resp.spaceName = std::move(spaceName_);
+  resp.errorMsg = std::move(errorMsg_);
+  resp.planDesc = std::move(planDesc_);
+  resp.comment = std::move(comment_);
+  return resp;
+}
+
+void LazyExecutionResponse::decodeHeader() {
+  if (buf_ == nullptr) {
+    setDecodeError("Empty response buffer");
+    return;
+  }
+  readAt(0, [this](auto *proto) { readHeader(proto); });
+}
+
+template <class Protocol>
+void LazyExecutionResponse::readHeader(Protocol *proto) {
+  std::string name;
+  apache::thrift::MessageType mtype;
+  int32_t seqId;
+  proto->readMessageBegin(name, mtype, seqId);
+  if (mtype == apache::thrift::T_EXCEPTION) {
+    apache::thrift::TApplicationException ex;
+    ex.read(proto);
+    proto->readMessageEnd();
+    throw ex;
+  }
+
+  TType ftype;
+  int16_t fid;
+  bool isset = false;
+  // The result struct of GraphService.execute, field 0 is the ExecutionResponse
+  proto->readStructBegin(name);
+  while (true) {
+    proto->readFieldBegin(name, ftype, fid);
+    if (ftype == TType::T_STOP) {
+      break;
+    }
+    if (fid != 0 || ftype != TType::T_STRUCT) {
+      proto->skip(ftype);
+      proto->readFieldEnd();
+      continue;
+    }
+    isset = true;
+    proto->readStructBegin(name);
+    while (true) {
+      proto->readFieldBegin(name, ftype, fid);
+      if (ftype == TType::T_STOP) {
+        break;
+      }
+      if (fid == 1 && ftype == TType::T_I32) {
+        int32_t code;
+        proto->readI32(code);
+        errorCode_ = static_cast<ErrorCode>(code);
+      } else if (fid == 2 && ftype == TType::T_I64) {
+        proto->readI64(latencyInUs_);
+      } else if (fid == 3 && ftype == TType::T_STRUCT) {
+        hasData_ = true;
+        dataOffset_ = proto->getCursorPosition();
+        proto->skip(ftype);
+      } else if (fid == 4 && ftype == TType::T_STRING) {
+        spaceName_ = std::make_unique<std::string>();
+        proto->readBinary(*spaceName_);
+      } else if (fid == 5 && ftype == TType::T_STRING) {
+        errorMsg_ = std::make_unique<std::string>();
+        proto->readBinary(*errorMsg_);
+      } else if (fid == 6 && ftype == TType::T_STRUCT) {
+        hasPlanDesc_ = true;
+        planDescOffset_ = proto->getCursorPosition();
+        proto->skip(ftype);
+      } else if (fid == 7 && ftype == TType::T_STRING) {
+        comment_ = std::make_unique<std::string>();
+        proto->readBinary(*comment_);
+      } else {
+        proto->skip(ftype);
+      }
+      proto->readFieldEnd();
+    }
+    proto->readStructEnd();
+    proto->readFieldEnd();
+  }
+  proto->readStructEnd();
+  proto->readMessageEnd();
+  if (!isset) {
+    throw std::runtime_error("execute failed: unknown result");
+  }
+}
+
+template <class Protocol>
+void LazyExecutionResponse::readDataSet(Protocol *proto, DataSet *ds) {
+  apache::thrift::Cpp2Ops<DataSet>::read(proto, ds);
+}
+
+template <class Protocol>
+void LazyExecutionResponse::readColNames(Protocol *proto, std::vector<std::string> *colNames) {
+  std::string name;
+  TType ftype;
+  int16_t fid;
+  proto->readStructBegin(name);
+  while (true) {
+    proto->readFieldBegin(name, ftype, fid);
+    if (ftype == TType::T_STOP) {
+      break;
+    }
+    if (fid == 1 && ftype == TType::T_LIST) {
+      TType elemType;
+      uint32_t size;
+      proto->readListBegin(elemType, size);
+      colNames->resize(size);
+      for (auto &col : *colNames) {
+        proto->readBinary(col);
+      }
+      proto->readListEnd();
+      // Nothing else is needed, leave the rows untouched
+      return;
+    }
+    proto->skip(ftype);
+    proto->readFieldEnd();
+  }
+}
+
+template <class Protocol>
+void LazyExecutionResponse::readColumns(Protocol *proto,
+                                        const std::vector<std::string> &columns,
+                                        DataSet *ds) {
+  std::string name;
+  TType ftype;
+  int16_t fid;
+  // Positions in the projected row of each column on the wire, empty if not selected.
+  // A column requested twice is kept twice, same as projecting the decoded data set.
+  std::vector<std::vector<std::size_t>> slots;
+  proto->readStructBegin(name);
+  while (true) {
+    proto->readFieldBegin(name, ftype, fid);
+    if (ftype == TType::T_STOP) {
+      break;
+    }
+    if (fid == 1 && ftype == TType::T_LIST) {
+      std::vector<std::string> colNames;
+      TType elemType;
+      uint32_t size;
+      proto->readListBegin(elemType, size);
+      colNames.resize(size);
+      for (auto &col : colNames) {
+        proto->readBinary(col);
+      }
+      proto->readListEnd();
+
+      std::unordered_map<std::string, std::size_t> index;
+      for (std::size_t i = 0; i < colNames.size(); ++i) {
+        index.emplace(colNames[i], i);
+      }
+      slots.assign(colNames.size(), {});
+      for (const auto &col : columns) {
+        auto it = index.find(col);
+        if (it != index.end()) {
+          slots[it->second].emplace_back(ds->colNames.size());
+          ds->colNames.emplace_back(col);
+        }
+      }
+    } else if (fid == 2 && ftype == TType::T_LIST) {
+      TType rowType;
+      uint32_t numRows;
+      proto->readListBegin(rowType, numRows);
+      ds->rows.reserve(numRows);
+      for (uint32_t r = 0; r < numRows; ++r) {
+        std::vector<Value> values(ds->colNames.size());
+        proto->readStructBegin(name);
+        while (true) {
+          proto->readFieldBegin(name, ftype, fid);
+          if (ftype == TType::T_STOP) {
+            break;
+          }
+          if (fid == 1 && ftype == TType::T_LIST) {
+            TType valueType;
+            uint32_t numValues;
+            proto->readListBegin(valueType, numValues);
+            for (uint32_t i = 0; i < numValues; ++i) {
+              if (i < slots.size() && !slots[i].empty()) {
+                auto &value = values[slots[i].front()];
+                apache::thrift::Cpp2Ops<Value>::read(proto, &value);
+                for (std::size_t j = 1; j < slots[i].size(); ++j) {
+                  values[slots[i][j]] = value;
+                }
+              } else {
+                proto->skip(valueType);
+              }
+            }
+            proto->readListEnd();
+          } else {
+            proto->skip(ftype);
+          }
+          proto->readFieldEnd();
+        }
+        proto->readStructEnd();
+        ds->rows.emplace_back(std::move(values));
+      }
+      proto->readListEnd();
+    } else {
+      proto->skip(ftype);
+    }
+    proto->readFieldEnd();
+  }
+  proto->readStructEnd();
+}
+
+template <class Protocol>
+void LazyExecutionResponse::readPlanDesc(Protocol *proto, PlanDescription *planDesc) {
+  apache::thrift::Cpp2Ops<PlanDescription>::read(proto, planDesc);
+}
+
+template <class Reader>
+void LazyExecutionResponse::readAt(std::size_t offset, Reader &&reader) {
+  try {
+    folly::io::Cursor cursor(buf_.get());
+    cursor.skip(offset);
+    switch (protocolId_) {
+      case apache::thrift::protocol::T_BINARY_PROTOCOL: {
+        apache::thrift::BinaryProtocolReader proto;
+        proto.setInput(cursor);
+        reader(&proto);
+        break;
+      }
+      case apache::thrift::protocol::T_COMPACT_PROTOCOL: {
+        apache::thrift::CompactProtocolReader proto;
+        proto.setInput(cursor);
+        reader(&proto);
+        break;
+      }
+      default:
+        throw std::runtime_error("Unsupported protocol " + std::to_string(protocolId_));
+    }
+  } catch (const std::exception &ex) {
+    setDecodeError(ex.what());
+  }
+}
+
+void LazyExecutionResponse::setDecodeError(const std::string &what) {
+  LOG(ERROR) << "Decode execution response failed: " << what;
+  errorCode_ = ErrorCode::E_RPC_FAILURE;
+  errorMsg_ = std::make_unique<std::string>(what);
+  hasData_ = false;
+  hasPlanDesc_ = false;
+}
+
+}  // namespace nebula
@@ -0,0 +1,121 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <folly/io/IOBufQueue.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+
+#include <string>
+#include <vector>
+
+#include "common/graph/ExecutionResponseOps-inl.h"
+#include "common/graph/LazyExecutionResponse.h"
+
+namespace nebula {
+
+static constexpr std::size_t kRows = 10000;
+static constexpr std::size_t kCols = 16;
+
+// The reply of GraphService.execute carrying a kRows x kCols data set
+static std::unique_ptr<folly::IOBuf> makeReply() {
+  std::vector<std::string> colNames;
+  for (std::size_t c = 0; c < kCols; ++c) {
+    colNames.emplace_back("col_" + std::to_string(c));
+  }
+  DataSet ds(std::move(colNames));
+  for (std::size_t r = 0; r < kRows; ++r) {
+    std::vector<Value> values;
+    for (std::size_t c = 0; c < kCols; ++c) {
+      if (c % 2 == 0) {
+        values.emplace_back(static_cast<int64_t>(r * kCols + c));
+      } else {
+        values.emplace_back("value_" + std::to_string(r));
+      }
+    }
+    ds.emplace_back(Row(std::move(values)));
+  }
+  ExecutionResponse resp;
+  resp.data = std::make_unique<DataSet>(std::move(ds));
+
+  folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+  apache::thrift::CompactProtocolWriter writer;
+  writer.setOutput(&queue);
+  writer.writeMessageBegin("execute", apache::thrift::T_REPLY, 0);
+  writer.writeStructBegin("GraphService_execute_presult");
+  writer.writeFieldBegin("success", apache::thrift::protocol::T_STRUCT, 0);
+  apache::thrift::Cpp2Ops<ExecutionResponse>::write(&writer, &resp);
+  writer.writeFieldEnd();
+  writer.writeFieldStop();
+  writer.writeStructEnd();
+  writer.writeMessageEnd();
+  auto buf = queue.move();
+  buf->coalesce();
+  return buf;
+}
+
+static const std::unique_ptr<folly::IOBuf> kReply = makeReply();
+static const std::vector<std::string> kColumns = {"col_14", "col_15"};
+
+static LazyExecutionResponse makeLazy() {
+  return LazyExecutionResponse(kReply->clone(), apache::thrift::protocol::T_COMPACT_PROTOCOL);
+}
+
+// What the generated client does before returning anything
+BENCHMARK(decodeAll, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    apache::thrift::CompactProtocolReader reader;
+    reader.setInput(kReply.get());
+    std::string name;
+    apache::thrift::MessageType mtype;
+    int32_t seqId;
+    apache::thrift::protocol::TType ftype;
+    int16_t fid;
+    ExecutionResponse resp;
+    reader.readMessageBegin(name, mtype, seqId);
+    reader.readStructBegin(name);
+    reader.readFieldBegin(name, ftype, fid);
+    apache::thrift::Cpp2Ops<ExecutionResponse>::read(&reader, &resp);
+    folly::doNotOptimizeAway(resp);
+  }
+}
+
+// Time to the first field, only the header is decoded
+BENCHMARK_RELATIVE(lazyErrorCode, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    auto lazy = makeLazy();
+    folly::doNotOptimizeAway(lazy.errorCode());
+  }
+}
+
+BENCHMARK_RELATIVE(lazyColNames, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    auto lazy = makeLazy();
+    folly::doNotOptimizeAway(lazy.colNames());
+  }
+}
+
+BENCHMARK_RELATIVE(lazyTwoColumns, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    auto lazy = makeLazy();
+    auto ds = lazy.data(kColumns);
+    folly::doNotOptimizeAway(ds);
+  }
+}
+
+BENCHMARK_RELATIVE(lazyAll, iters) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    auto lazy = makeLazy();
+    folly::doNotOptimizeAway(lazy.data());
+  }
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <common/graph/ExecutionResponseOps-inl.h>
+#include <common/graph/LazyExecutionResponse.h>
+#include <folly/io/IOBufQueue.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <thrift/lib/cpp2/protocol/BinaryProtocol.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+
+#include <string>
+#include <vector>
+
+namespace nebula {
+
+static ExecutionResponse makeResponse() {
+  ExecutionResponse resp;
+  resp.errorCode = ErrorCode::SUCCEEDED;
+  resp.latencyInUs = 10;
+  resp.spaceName = std::make_unique<std::string>("nba");
+  DataSet ds({"id", "name", "score"});
+  ds.emplace_back(Row({1, "Tim", 9.5}));
+  ds.emplace_back(Row({2, "Tony", Value::kNullValue}));
+  ds.emplace_back(Row({3, "Tom", 7.0}));
+  resp.data = std::make_unique<DataSet>(std::move(ds));
+  return resp;
+}
+
+// Serialize the response as the reply of GraphService.execute
+template <class Writer>
+static std::unique_ptr<folly::IOBuf> serialize(ExecutionResponse* resp) {
+  folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+  Writer writer;
+  writer.setOutput(&queue);
+  writer.writeMessageBegin("execute", apache::thrift::T_REPLY, 0);
+  writer.writeStructBegin("GraphService_execute_presult");
+  writer.writeFieldBegin("success", apache::thrift::protocol::T_STRUCT, 0);
+  apache::thrift::Cpp2Ops<ExecutionResponse>::write(&writer, resp);
+  writer.writeFieldEnd();
+  writer.writeFieldStop();
+  writer.writeStructEnd();
+  writer.writeMessageEnd();
+  return queue.move();
+}
+
+template <class Writer>
+static void testColumns(uint16_t protocolId) {
+  auto resp = makeResponse();
+  auto buf = serialize<Writer>(&resp);
+  // A duplicated, an unknown and a reordered column
+  const std::vector<std::string> columns = {"score", "id", "unknown", "score"};
+
+  // Read from the wire
+  LazyExecutionResponse raw(buf->clone(), protocolId);
+  ASSERT_EQ(raw.errorCode(), ErrorCode::SUCCEEDED);
+  EXPECT_EQ(raw.latencyInUs(), 10);
+  ASSERT_NE(raw.spaceName(), nullptr);
+  EXPECT_EQ(*raw.spaceName(), "nba");
+  EXPECT_EQ(raw.colNames(), std::vector<std::string>({"id", "name", "score"}));
+  auto fromRaw = raw.data(columns);
+
+  DataSet expected({"score", "id", "score"});
+  expected.emplace_back(Row({9.5, 1, 9.5}));
+  expected.emplace_back(Row({Value::kNullValue, 2, Value::kNullValue}));
+  expected.emplace_back(Row({7.0, 3, 7.0}));
+  EXPECT_EQ(fromRaw, expected);
+
+  // Projected from the decoded data set
+  LazyExecutionResponse decoded(buf->clone(), protocolId);
+  ASSERT_NE(decoded.data(), nullptr);
+  EXPECT_EQ(*decoded.data(), *resp.data);
+  EXPECT_EQ(decoded.data(columns), fromRaw);
+}
+
+TEST(LazyExecutionResponseTest, Compact) {
+  testColumns<apache::thrift::CompactProtocolWriter>(
+      apache::thrift::protocol::T_COMPACT_PROTOCOL);
+}
+
+TEST(LazyExecutionResponseTest, Binary) {
+  testColumns<apache::thrift::BinaryProtocolWriter>(apache::thrift::protocol::T_BINARY_PROTOCOL);
+}
+
+TEST(LazyExecutionResponseTest, ToExecutionResponse) {
+  auto resp = makeResponse();
+  auto buf = serialize<apache::thrift::CompactProtocolWriter>(&resp);
+  LazyExecutionResponse lazy(std::move(buf), apache::thrift::protocol::T_COMPACT_PROTOCOL);
+  EXPECT_FALSE(lazy.hasPlanDesc());
+  EXPECT_EQ(std::move(lazy).toExecutionResponse(), resp);
+}
+
+TEST(LazyExecutionResponseTest, DecodeError) {
+  auto resp = makeResponse();
+  auto buf = serialize<apache::thrift::CompactProtocolWriter>(&resp);
+  buf->coalesce();
+  buf->trimEnd(buf->length() / 2);
+  LazyExecutionResponse lazy(std::move(buf), apache::thrift::protocol::T_COMPACT_PROTOCOL);
+  EXPECT_EQ(lazy.errorCode(), ErrorCode::E_RPC_FAILURE);
+  EXPECT_FALSE(lazy.hasData());
+  EXPECT_EQ(lazy.data(), nullptr);
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
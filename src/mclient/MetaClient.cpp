@@ -7,6 +7,7 @@
 #include <folly/executors/IOThreadPoolExecutor.h>
 
 #include <functional>
+#include <mutex>
 
 #include "../thrift/ThriftClientManager.h"
 #include "common/thrift/ThriftTypes.h"
@@ -15,6 +16,41 @@
 
 namespace nebula {
 
+namespace {
+
+// Meta lists an item for each version of a schema, only the latest version
+// of each tag or edge is kept, in the order they are first listed
+template <typename Item, typename IdOf, typename NameOf>
+std::vector<SchemaInfo> latestSchemas(const std::vector<Item>& items, IdOf idOf, NameOf nameOf) {
+  std::vector<SchemaInfo> schemas;
+  // The index in schemas and the version of each id
+  std::unordered_map<int32_t, std::pair<std::size_t, int64_t>> versions;
+  for (const auto& item : items) {
+    int32_t id = idOf(item);
+    int64_t version = item.get_version();
+    auto it = versions.find(id);
+    if (it != versions.end() && version <= it->second.second) {
+      continue;
+    }
+    SchemaInfo info;
+    info.id_ = id;
+    info.name_ = nameOf(item);
+    for (const auto& col : item.get_schema().get_columns()) {
+      info.props_.emplace_back(col.get_name());
+    }
+    if (it == versions.end()) {
+      versions.emplace(id, std::make_pair(schemas.size(), version));
+      schemas.emplace_back(std::move(info));
+    } else {
+      it->second.second = version;
+      schemas[it->second.first] = std::move(info);
+    }
+  }
+  return schemas;
+}
+
+}  // namespace
+
 MetaClient::MetaClient(const std::vector<std::string>& metaAddrs, const MConfig& mConfig) {
   for (const auto& addr : metaAddrs) {
     std::vector<std::string> ip_port;
@@ -25,7 +61,8 @@ MetaClient::MetaClient(const std::vector<std::string>& metaAddrs, const MConfig&
   CHECK(!metaAddrs_.empty()) << "metaAddrs_ is empty";
   mConfig_ = mConfig;
 
-  ioExecutor_ = std::make_shared<folly::IOThreadPoolExecutor>(std::thread::hardware_concurrency());
+  runtime_ = mConfig_.runtime_ != nullptr ? mConfig_.runtime_ : std::make_shared<ClientRuntime>();
+  ioExecutor_ = runtime_->ioExecutor();
   clientsMan_ = std::make_shared<thrift::ThriftClientManager<meta::cpp2::MetaServiceAsyncClient>>(
       mConfig_.connTimeoutInMs_, mConfig_.enableSSL_, mConfig_.CAPath_);
   bool b = loadData();  // load data into cache
@@ -55,6 +92,16 @@ std::pair<bool, EdgeType> MetaClient::getEdgeTypeByNameFromCache(GraphSpaceID sp
   return {true, it->second};
 }
 
+std::pair<bool, TagID> MetaClient::getTagIdByNameFromCache(GraphSpaceID space,
+                                                          const std::string& name) {
+  auto it = spaceTagIndexByName_.find(std::make_pair(space, name));
+  if (it == spaceTagIndexByName_.end()) {
+    LOG(ERROR) << "getTagIdByNameFromCache(" << space << ", " << name << ") failed";
+    return {false, -1};
+  }
+  return {true, it->second};
+}
+
 std::pair<bool, std::vector<PartitionID>> MetaClient::getPartsFromCache(GraphSpaceID spaceId) {
   auto iter = spacePartsMap_.find(spaceId);
   if (iter == spacePartsMap_.end()) {
@@ -65,8 +112,47 @@ std::pair<bool, std::vector<PartitionID>> MetaClient::getPartsFromCache(GraphSpa
   return {true, iter->second};
 }
 
+std::pair<bool, SpaceInfo> MetaClient::getSpaceInfoFromCache(GraphSpaceID spaceId) {
+  auto iter = spaceInfos_.find(spaceId);
+  if (iter == spaceInfos_.end()) {
+    LOG(ERROR) << "getSpaceInfoFromCache(" << spaceId << ") failed";
+    return {false, SpaceInfo()};
+  }
+  return {true, iter->second};
+}
+
+std::pair<bool, std::vector<SchemaInfo>> MetaClient::getEdgeSchemasFromCache(
+    GraphSpaceID spaceId) {
+  auto iter = spaceEdgeSchemas_.find(spaceId);
+  if (iter == spaceEdgeSchemas_.end()) {
+    LOG(ERROR) << "getEdgeSchemasFromCache(" << spaceId << ") failed";
+    return {false, {}};
+  }
+  return {true, iter->second};
+}
+
+std::pair<bool, std::vector<SchemaInfo>> MetaClient::getTagSchemasFromCache(GraphSpaceID spaceId) {
+  auto iter = spaceTagSchemas_.find(spaceId);
+  if (iter == spaceTagSchemas_.end()) {
+    LOG(ERROR) << "getTagSchemasFromCache(" << spaceId << ") failed";
+    return {false, {}};
+  }
+  return {true, iter->second};
+}
+
+std::pair<bool, IndexInfo> MetaClient::getIndexFromCache(GraphSpaceID spaceId,
+                                                         const std::string& name) {
+  auto iter = spaceIndexInfoByName_.find(std::make_pair(spaceId, name));
+  if (iter == spaceIndexInfoByName_.end()) {
+    LOG(ERROR) << "getIndexFromCache(" << spaceId << ", " << name << ") failed";
+    return {false, IndexInfo()};
+  }
+  return {true, iter->second};
+}
+
 std::pair<bool, HostAddr> MetaClient::getPartLeaderFromCache(GraphSpaceID spaceId,
                                                              PartitionID partId) {
+  std::shared_lock<std::shared_mutex> guard(lock_);
   auto iter = spacePartLeaderMap_.find({spaceId, partId});
   if (iter == spacePartLeaderMap_.end()) {
     LOG(ERROR) << "getPartLeaderFromCache(" << spaceId << ", " << partId << ") failed";
@@ -76,6 +162,38 @@ std::pair<bool, HostAddr> MetaClient::getPartLeaderFromCache(GraphSpaceID spaceI
   return {true, iter->second};
 }
 
+void MetaClient::updateLeader(GraphSpaceID spaceId, PartitionID partId, const HostAddr& leader) {
+  std::unique_lock<std::shared_mutex> guard(lock_);
+  spacePartLeaderMap_[{spaceId, partId}] = leader;
+}
+
+bool MetaClient::refreshLeaders() {
+  std::unique_lock<std::mutex> guard(refreshLock_);
+  if (refreshing_) {
+    // Share the refresh in progress instead of asking meta again
+    auto refreshes = refreshes_;
+    refreshed_.wait(guard, [this, refreshes] { return refreshes_ != refreshes; });
+    return refreshSucceeded_;
+  }
+  refreshing_ = true;
+  guard.unlock();
+
+  auto hostsRet = listHosts(meta::cpp2::ListHostType::ALLOC);
+  if (!hostsRet.first) {
+    LOG(ERROR) << "List hosts failed";
+  } else {
+    loadLeader(hostsRet.second, spaceIndexByName_);
+  }
+
+  guard.lock();
+  refreshing_ = false;
+  ++refreshes_;
+  refreshSucceeded_ = hostsRet.first;
+  guard.unlock();
+  refreshed_.notify_all();
+  return hostsRet.first;
+}
+
 bool MetaClient::loadData() {
   auto ret = listSpaces();
   if (!ret.first) {
@@ -85,6 +203,17 @@ bool MetaClient::loadData() {
   for (auto space : ret.second) {
     GraphSpaceID spaceId = space.first;
     spaceIndexByName_.emplace(space.second, spaceId);
+    auto spaceRet = getSpace(space.second);
+    if (!spaceRet.first) {
+      LOG(ERROR) << "Get space " << space.second << " failed";
+      return false;
+    }
+    spaceInfos_[spaceId] = spaceRet.second;
+    // All parts, whether they have a leader at the moment or not
+    auto& parts = spacePartsMap_[spaceId];
+    for (PartitionID partId = 1; partId <= spaceRet.second.partNum_; ++partId) {
+      parts.emplace_back(partId);
+    }
     auto edgesRet = listEdgeSchemas(spaceId);
     if (!edgesRet.first) {
       LOG(ERROR) << "List edge schemas failed";
@@ -94,6 +223,42 @@ bool MetaClient::loadData() {
     for (auto& edgeItem : edgeItems) {
       spaceEdgeIndexByName_[{spaceId, edgeItem.get_edge_name()}] = edgeItem.get_edge_type();
     }
+    spaceEdgeSchemas_[spaceId] = latestSchemas(
+        edgeItems,
+        [](const meta::cpp2::EdgeItem& item) { return item.get_edge_type(); },
+        [](const meta::cpp2::EdgeItem& item) { return item.get_edge_name(); });
+    auto tagsRet = listTagSchemas(spaceId);
+    if (!tagsRet.first) {
+      LOG(ERROR) << "List tag schemas failed";
+      return false;
+    }
+    auto& tagItems = tagsRet.second;
+    for (auto& tagItem : tagItems) {
+      spaceTagIndexByName_[{spaceId, tagItem.get_tag_name()}] = tagItem.get_tag_id();
+    }
+    spaceTagSchemas_[spaceId] = latestSchemas(
+        tagItems,
+        [](const meta::cpp2::TagItem& item) { return item.get_tag_id(); },
+        [](const meta::cpp2::TagItem& item) { return item.get_tag_name(); });
+    for (bool isEdge : {false, true}) {
+      auto indexesRet = listIndexes(spaceId, isEdge);
+      if (!indexesRet.first) {
+        LOG(ERROR) << "List " << (isEdge ? "edge" : "tag") << " indexes failed";
+        return false;
+      }
+      for (auto& indexItem : indexesRet.second) {
+        IndexInfo info;
+        info.id_ = indexItem.get_index_id();
+        info.isEdge_ = isEdge;
+        const auto& schemaId = indexItem.get_schema_id();
+        info.schemaId_ = isEdge ? schemaId.get_edge_type() : schemaId.get_tag_id();
+        info.schemaName_ = indexItem.get_schema_name();
+        for (const auto& field : indexItem.get_fields()) {
+          info.fields_.emplace_back(field.get_name());
+        }
+        spaceIndexInfoByName_[{spaceId, indexItem.get_index_name()}] = std::move(info);
+      }
+    }
   }
   auto hostsRet = listHosts(meta::cpp2::ListHostType::ALLOC);
   if (!hostsRet.first) {
@@ -121,6 +286,27 @@ std::pair<bool, std::vector<SpaceIdName>> MetaClient::listSpaces() {
   return std::move(future).get();
 }
 
+std::pair<bool, SpaceInfo> MetaClient::getSpace(const std::string& name) {
+  meta::cpp2::GetSpaceReq req;
+  req.set_space_name(name);
+  folly::Promise<std::pair<bool, SpaceInfo>> promise;
+  auto future = promise.getFuture();
+  getResponse(
+      std::move(req),
+      [](auto client, auto request) { return client->future_getSpace(request); },
+      [](meta::cpp2::GetSpaceResp&& resp) -> decltype(auto) {
+        const auto& desc = resp.get_item().get_properties();
+        const auto& vidType = desc.get_vid_type();
+        SpaceInfo info;
+        info.partNum_ = desc.get_partition_num();
+        info.intVid_ = vidType.get_type() == nebula::cpp2::PropertyType::INT64;
+        info.vidLength_ = vidType.type_length_ref().value_or(0);
+        return std::make_pair(true, info);
+      },
+      std::move(promise));
+  return std::move(future).get();
+}
+
 std::pair<bool, std::vector<meta::cpp2::HostItem>> MetaClient::listHosts(
     meta::cpp2::ListHostType tp) {
   meta::cpp2::ListHostsReq req;
@@ -153,8 +339,53 @@ std::pair<bool, std::vector<meta::cpp2::EdgeItem>> MetaClient::listEdgeSchemas(
   return std::move(future).get();
 }
 
+std::pair<bool, std::vector<meta::cpp2::TagItem>> MetaClient::listTagSchemas(
+    GraphSpaceID spaceId) {
+  meta::cpp2::ListTagsReq req;
+  req.set_space_id(spaceId);
+  folly::Promise<std::pair<bool, std::vector<meta::cpp2::TagItem>>> promise;
+  auto future = promise.getFuture();
+  getResponse(
+      std::move(req),
+      [](auto client, auto request) { return client->future_listTags(request); },
+      [](meta::cpp2::ListTagsResp&& resp) -> decltype(auto) {
+        return std::make_pair(true, resp.get_tags());
+      },
+      std::move(promise));
+  return std::move(future).get();
+}
+
+std::pair<bool, std::vector<meta::cpp2::IndexItem>> MetaClient::listIndexes(GraphSpaceID spaceId,
+                                                                            bool isEdge) {
+  folly::Promise<std::pair<bool, std::vector<meta::cpp2::IndexItem>>> promise;
+  auto future = promise.getFuture();
+  if (isEdge) {
+    meta::cpp2::ListEdgeIndexesReq req;
+    req.set_space_id(spaceId);
+    getResponse(
+        std::move(req),
+        [](auto client, auto request) { return client->future_listEdgeIndexes(request); },
+        [](meta::cpp2::ListEdgeIndexesResp&& resp) -> decltype(auto) {
+          return std::make_pair(true, resp.get_items());
+        },
+        std::move(promise));
+  } else {
+    meta::cpp2::ListTagIndexesReq req;
+    req.set_space_id(spaceId);
+    getResponse(
+        std::move(req),
+        [](auto client, auto request) { return client->future_listTagIndexes(request); },
+        [](meta::cpp2::ListTagIndexesResp&& resp) -> decltype(auto) {
+          return std::make_pair(true, resp.get_items());
+        },
+        std::move(promise));
+  }
+  return std::move(future).get();
+}
+
 void MetaClient::loadLeader(const std::vector<meta::cpp2::HostItem>& hostItems,
                             const SpaceNameIdMap& spaceIndexByName) {
+  decltype(spacePartLeaderMap_) spacePartLeaderMap;
   for (auto& item : hostItems) {
     for (auto& spaceEntry : item.get_leader_parts()) {
       auto spaceName = spaceEntry.first;
@@ -164,11 +395,16 @@ void MetaClient::loadLeader(const std::vector<meta::cpp2::HostItem>& hostItems,
       }
       auto spaceId = iter->second;
       for (const auto& partId : spaceEntry.second) {
-        spacePartLeaderMap_[{spaceId, partId}] = item.get_hostAddr();
-        spacePartsMap_[spaceId].emplace_back(partId);
+        spacePartLeaderMap[{spaceId, partId}] = item.get_hostAddr();
       }
     }
   }
+  // A part without a leader, e.g. in an election, keeps its last one until
+  // it's listed again
+  std::unique_lock<std::shared_mutex> guard(lock_);
+  for (auto& entry : spacePartLeaderMap) {
+    spacePartLeaderMap_[entry.first] = std::move(entry.second);
+  }
 }
 
 std::vector<SpaceIdName> MetaClient::toSpaceIdName(
@@ -12,6 +12,8 @@
 #include <nebula/client/Session.h>
 #include <nebula/mclient/MetaClient.h>
 
+#include <algorithm>
+
 #include "./MClientTest.h"
 #include "common/datatypes/HostAddr.h"
 #include "common/thrift/ThriftTypes.h"
@@ -36,6 +38,12 @@ class MetaClientTest : public MClientTest {
     auto result2 = session.execute("CREATE EDGE IF NOT EXISTS like(likeness int)");
     ASSERT_EQ(result2.errorCode, nebula::ErrorCode::SUCCEEDED);
 
+    // Two versions of the schema of serve, it fails once the property exists
+    auto result4 = session.execute(
+        "CREATE EDGE IF NOT EXISTS serve(start_year int);"
+        "ALTER EDGE serve ADD (end_year int)");
+    LOG(INFO) << "Alter edge serve: " << static_cast<int>(result4.errorCode);
+
     ::sleep(30);
 
     auto result3 = session.execute(
@@ -58,6 +66,19 @@ class MetaClientTest : public MClientTest {
     LOG(INFO) << "edgeType of like: " << edgeType;
     EXPECT_GT(edgeType, 0);
 
+    // Only the latest version of serve
+    auto ret5 = c.getEdgeSchemasFromCache(spaceId);
+    ASSERT_TRUE(ret5.first);
+    auto serve = std::count_if(ret5.second.begin(), ret5.second.end(), [](const auto &schema) {
+      return schema.name_ == "serve";
+    });
+    EXPECT_EQ(serve, 1);
+    for (const auto &schema : ret5.second) {
+      if (schema.name_ == "serve") {
+        EXPECT_EQ(schema.props_, (std::vector<std::string>{"start_year", "end_year"}));
+      }
+    }
+
     auto ret3 = c.getPartsFromCache(spaceId);
     ASSERT_TRUE(ret3.first);
     auto parts = ret3.second;
@@ -0,0 +1,138 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/runtime/ClientRuntime.h"
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/system/ThreadName.h>
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace nebula {
+
+namespace {
+
+void pinToCpu(int32_t cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  auto err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (err != 0) {
+    LOG(ERROR) << "Pin thread to CPU " << cpu << " failed: " << folly::errnoStr(err);
+  }
+#else
+  LOG(WARNING) << "Pin thread to CPU " << cpu << " is not supported";
+#endif
+}
+
+// Name the threads by the prefix and their index, and pin them to cpus in
+// turn if there are
+class RuntimeThreadFactory : public folly::NamedThreadFactory {
+ public:
+  RuntimeThreadFactory(const std::string& prefix, std::vector<int32_t> cpus)
+      : folly::NamedThreadFactory(prefix), cpus_(std::move(cpus)) {}
+
+  std::thread newThread(folly::Func&& func) override {
+    auto index = next_++;
+    auto name = folly::to<std::string>(getNamePrefix(), index);
+    auto cpu = cpus_.empty() ? -1 : cpus_[index % cpus_.size()];
+    return std::thread([func = std::move(func), name = std::move(name), cpu]() mutable {
+      folly::setThreadName(name);
+      if (cpu >= 0) {
+        pinToCpu(cpu);
+      }
+      func();
+    });
+  }
+
+ private:
+  std::vector<int32_t> cpus_;
+  std::atomic<std::size_t> next_{0};
+};
+
+}  // namespace
+
+ClientRuntime::ClientRuntime(const RuntimeConfig& config) : config_(config) {
+  auto ioThreads = config_.ioThreads_ > 0 ? static_cast<std::size_t>(config_.ioThreads_)
+                                          : std::thread::hardware_concurrency();
+  ioExecutor_ = std::make_shared<folly::IOThreadPoolExecutor>(
+      ioThreads, std::make_shared<RuntimeThreadFactory>(config_.ioThreadName_, config_.ioCpus_));
+  if (config_.cpuThreads_ > 0) {
+    cpuExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(
+        config_.cpuThreads_,
+        std::make_shared<RuntimeThreadFactory>(config_.cpuThreadName_, config_.cpuCpus_));
+  }
+}
+
+ClientRuntime::~ClientRuntime() {
+  if (cpuExecutor_ != nullptr) {
+    cpuExecutor_->join();
+  }
+  ioExecutor_->join();
+}
+
+folly::EventBase* ClientRuntime::eventBase() const {
+  return ioExecutor_->getEventBase();
+}
+
+void ClientRuntime::runWorkers(std::size_t concurrency, const std::function<void()>& worker) {
+  if (cpuExecutor_ == nullptr) {
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < concurrency; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+      t.join();
+    }
+    return;
+  }
+
+  // The workers which start late may outlive the call, so they share it
+  struct Gate {
+    std::mutex lock_;
+    std::condition_variable cv_;
+    bool closed_{false};
+    int32_t running_{0};
+  };
+  auto gate = std::make_shared<Gate>();
+  for (std::size_t i = 1; i < concurrency; ++i) {
+    cpuExecutor_->add([gate, &worker] {
+      {
+        std::lock_guard<std::mutex> guard(gate->lock_);
+        if (gate->closed_) {
+          return;
+        }
+        ++gate->running_;
+      }
+      worker();
+      {
+        std::lock_guard<std::mutex> guard(gate->lock_);
+        --gate->running_;
+      }
+      gate->cv_.notify_all();
+    });
+  }
+  worker();
+  std::unique_lock<std::mutex> guard(gate->lock_);
+  gate->closed_ = true;
+  gate->cv_.wait(guard, [&gate] { return gate->running_ == 0; });
+}
+
+}  // namespace nebula
@@ -0,0 +1,121 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <common/runtime/ClientRuntime.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
+#include <folly/system/ThreadName.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace nebula {
+
+TEST(ClientRuntimeTest, Threads) {
+  RuntimeConfig config;
+  config.ioThreads_ = 2;
+  config.ioThreadName_ = "test-io-";
+  ClientRuntime runtime(config);
+  EXPECT_EQ(runtime.cpuExecutor(), nullptr);
+  EXPECT_EQ(runtime.ioExecutor()->numThreads(), 2U);
+
+  auto name = folly::via(runtime.eventBase(), [] {
+                return folly::getCurrentThreadName().value_or("");
+              }).get();
+  EXPECT_EQ(name.rfind("test-io-", 0), 0U);
+}
+
+TEST(ClientRuntimeTest, Pin) {
+#ifdef __linux__
+  RuntimeConfig config;
+  config.ioThreads_ = 1;
+  config.ioCpus_ = {0};
+  config.cpuThreads_ = 1;
+  config.cpuCpus_ = {0};
+  ClientRuntime runtime(config);
+  EXPECT_EQ(folly::via(runtime.eventBase(), [] { return sched_getcpu(); }).get(), 0);
+  EXPECT_EQ(folly::via(runtime.cpuExecutor().get(), [] { return sched_getcpu(); }).get(), 0);
+#endif
+}
+
+TEST(ClientRuntimeTest, RunWorkers) {
+  for (int32_t cpuThreads : {0, 2, 8}) {
+    RuntimeConfig config;
+    config.ioThreads_ = 1;
+    config.cpuThreads_ = cpuThreads;
+    ClientRuntime runtime(config);
+
+    // The items are taken by the caller and the workers, whichever come
+    std::mutex lock;
+    int32_t next = 0;
+    std::set<std::thread::id> threads;
+    std::atomic<int32_t> sum{0};
+    runtime.runWorkers(4, [&] {
+      while (true) {
+        int32_t item;
+        {
+          std::lock_guard<std::mutex> guard(lock);
+          if (next == 100) {
+            return;
+          }
+          item = next++;
+          threads.emplace(std::this_thread::get_id());
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        sum += item;
+      }
+    });
+    EXPECT_EQ(sum, 4950);
+    EXPECT_EQ(next, 100);
+    EXPECT_LE(threads.size(), 4U);
+    EXPECT_EQ(threads.count(std::this_thread::get_id()), 1U);
+  }
+}
+
+TEST(ClientRuntimeTest, BusyWorkers) {
+  int32_t calls = 0;
+  {
+    RuntimeConfig config;
+    config.ioThreads_ = 1;
+    config.cpuThreads_ = 1;
+    ClientRuntime runtime(config);
+
+    // The only CPU thread is busy, the caller does all the work and doesn't
+    // wait for the worker queued
+    std::atomic<bool> release{false};
+    runtime.cpuExecutor()->add([&release] {
+      while (!release) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+    runtime.runWorkers(2, [&calls] { ++calls; });
+    EXPECT_EQ(calls, 1);
+    release = true;
+  }
+  // The worker queued started after the call and didn't run it
+  EXPECT_EQ(calls, 1);
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
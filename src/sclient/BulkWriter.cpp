@@ -0,0 +1,567 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/BulkWriter.h"
+
+#include <folly/futures/Future.h>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+#include "interface/gen-cpp2/storage_types.h"
+
+namespace nebula {
+
+namespace {
+
+// Move the rows of partId from one parts map of a request to another, return
+// the number of rows moved
+template <typename Parts>
+int64_t moveRows(Parts* from, PartitionID partId, Parts* to) {
+  auto it = from->find(partId);
+  if (it == from->end()) {
+    return 0;
+  }
+  auto rows = static_cast<int64_t>(it->second.size());
+  auto& dst = (*to)[partId];
+  if (dst.empty()) {
+    dst = std::move(it->second);
+  } else {
+    std::move(it->second.begin(), it->second.end(), std::back_inserter(dst));
+  }
+  from->erase(it);
+  return rows;
+}
+
+template <typename Parts>
+std::vector<PartitionID> partIdsOf(const Parts& parts) {
+  std::vector<PartitionID> partIds;
+  partIds.reserve(parts.size());
+  for (const auto& part : parts) {
+    partIds.emplace_back(part.first);
+  }
+  return partIds;
+}
+
+}  // namespace
+
+struct BulkWriter::Batch {
+  // The rows of the request of the kind of the target, by part
+  std::vector<PartitionID> partIds() const {
+    return isEdge_ ? partIdsOf(edges_.get_parts()) : partIdsOf(vertices_.get_parts());
+  }
+
+  void append(PartitionID partId, storage::cpp2::NewVertex&& vertex) {
+    vertices_.parts_ref().value()[partId].emplace_back(std::move(vertex));
+    ++rows_;
+  }
+
+  void append(PartitionID partId, storage::cpp2::NewEdge&& edge) {
+    edges_.parts_ref().value()[partId].emplace_back(std::move(edge));
+    ++rows_;
+  }
+
+  // Move the rows of partId to other, return the number of rows moved
+  int64_t moveTo(PartitionID partId, Batch* other) {
+    auto rows = isEdge_ ? moveRows(&edges_.parts_ref().value(),
+                                   partId,
+                                   &other->edges_.parts_ref().value())
+                        : moveRows(&vertices_.parts_ref().value(),
+                                   partId,
+                                   &other->vertices_.parts_ref().value());
+    rows_ -= rows;
+    other->rows_ += rows;
+    return rows;
+  }
+
+  std::size_t target_{0};
+  bool isEdge_{false};
+  HostAddr leader_;
+  int64_t rows_{0};
+  // When the first row was added
+  std::chrono::steady_clock::time_point since_;
+  // Only the one of the kind of the target is used
+  storage::cpp2::AddVerticesRequest vertices_;
+  storage::cpp2::AddEdgesRequest edges_;
+};
+
+std::unique_ptr<BulkWriter> BulkWriter::make(StorageClient* client,
+                                             const std::string& spaceName,
+                                             const TagProps& tags,
+                                             const EdgeProps& edges,
+                                             const BulkWriterConfig& config) {
+  auto* mClient = client->getMetaClient();
+  auto spaceIdResult = mClient->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    return nullptr;
+  }
+  auto spaceId = spaceIdResult.second;
+  auto router = PartitionRouter::make(mClient, spaceId);
+  if (!router.first) {
+    return nullptr;
+  }
+
+  std::vector<Target> targets;
+  for (const auto& tag : tags) {
+    auto tagIdResult = mClient->getTagIdByNameFromCache(spaceId, tag.first);
+    if (!tagIdResult.first) {
+      return nullptr;
+    }
+    targets.emplace_back(Target{tag.first, false, tagIdResult.second, tag.second});
+  }
+  for (const auto& edge : edges) {
+    auto edgeTypeResult = mClient->getEdgeTypeByNameFromCache(spaceId, edge.first);
+    if (!edgeTypeResult.first) {
+      return nullptr;
+    }
+    targets.emplace_back(Target{edge.first, true, edgeTypeResult.second, edge.second});
+  }
+  return std::unique_ptr<BulkWriter>(
+      new BulkWriter(client, spaceId, router.second, std::move(targets), config));
+}
+
+BulkWriter::BulkWriter(StorageClient* client,
+                       GraphSpaceID spaceId,
+                       PartitionRouter router,
+                       std::vector<Target> targets,
+                       const BulkWriterConfig& config)
+    : client_(client),
+      spaceId_(spaceId),
+      router_(router),
+      targets_(std::move(targets)),
+      config_(config),
+      start_(std::chrono::steady_clock::now()) {
+  for (std::size_t i = 0; i < targets_.size(); ++i) {
+    auto& index = targets_[i].isEdge_ ? edgeIndex_ : tagIndex_;
+    index.emplace(targets_[i].name_, i);
+  }
+  leaders_.resize(router_.numParts() + 1);
+  leaderVersions_.resize(router_.numParts() + 1, 0);
+  partRetries_.resize(router_.numParts() + 1, 0);
+  loadLeaders(false);
+  flusher_ = std::thread(&BulkWriter::flushLoop, this);
+}
+
+BulkWriter::~BulkWriter() {
+  finish();
+}
+
+bool BulkWriter::addVertex(const std::string& tag, const Value& vid, std::vector<Value> props) {
+  auto it = tagIndex_.find(tag);
+  if (it == tagIndex_.end()) {
+    LOG(ERROR) << "Tag " << tag << " is not of the writer";
+    return false;
+  }
+  auto partId = router_.partFor(vid);
+  if (partId == 0) {
+    LOG(ERROR) << "Invalid vid " << vid << ", it must be of the vid type of space " << spaceId_;
+    return false;
+  }
+  storage::cpp2::NewTag newTag;
+  newTag.set_tag_id(targets_[it->second].id_);
+  newTag.set_props(std::move(props));
+  storage::cpp2::NewVertex vertex;
+  vertex.set_id(vid);
+  vertex.set_tags({std::move(newTag)});
+
+  std::vector<std::shared_ptr<Batch>> batches;
+  {
+    std::unique_lock<std::mutex> guard(lock_);
+    if (!admit(&guard)) {
+      return false;
+    }
+    add(it->second, partId, std::move(vertex), &batches);
+  }
+  send(std::move(batches));
+  return true;
+}
+
+bool BulkWriter::addEdge(const std::string& edge,
+                         const Value& src,
+                         const Value& dst,
+                         std::vector<Value> props,
+                         EdgeRanking rank) {
+  auto it = edgeIndex_.find(edge);
+  if (it == edgeIndex_.end()) {
+    LOG(ERROR) << "Edge " << edge << " is not of the writer";
+    return false;
+  }
+  auto srcPartId = router_.partFor(src);
+  auto dstPartId = router_.partFor(dst);
+  if (srcPartId == 0 || dstPartId == 0) {
+    LOG(ERROR) << "Invalid edge " << src << "->" << dst
+               << ", the vids must be of the vid type of space " << spaceId_;
+    return false;
+  }
+  auto edgeType = targets_[it->second].id_;
+  // As graphd does, the out-edge is in the part of src and the in-edge,
+  // which is of the negative type, in the part of dst
+  storage::cpp2::EdgeKey outKey;
+  outKey.set_src(src);
+  outKey.set_edge_type(edgeType);
+  outKey.set_ranking(rank);
+  outKey.set_dst(dst);
+  storage::cpp2::NewEdge outEdge;
+  outEdge.set_key(std::move(outKey));
+  outEdge.set_props(props);
+
+  storage::cpp2::EdgeKey inKey;
+  inKey.set_src(dst);
+  inKey.set_edge_type(-edgeType);
+  inKey.set_ranking(rank);
+  inKey.set_dst(src);
+  storage::cpp2::NewEdge inEdge;
+  inEdge.set_key(std::move(inKey));
+  inEdge.set_props(std::move(props));
+
+  // Both halves are added under one lock, so that none is if the writer is
+  // finished
+  std::vector<std::shared_ptr<Batch>> batches;
+  {
+    std::unique_lock<std::mutex> guard(lock_);
+    if (!admit(&guard)) {
+      return false;
+    }
+    add(it->second, srcPartId, std::move(outEdge), &batches);
+    add(it->second, dstPartId, std::move(inEdge), &batches);
+  }
+  send(std::move(batches));
+  return true;
+}
+
+bool BulkWriter::admit(std::unique_lock<std::mutex>* guard) {
+  notFull_.wait(*guard, [this] { return pending_ < config_.maxPendingRows_ || stopped_; });
+  if (stopped_) {
+    LOG(ERROR) << "The writer is finished";
+    return false;
+  }
+  return true;
+}
+
+template <typename Row>
+void BulkWriter::add(std::size_t target,
+                     PartitionID partId,
+                     Row&& row,
+                     std::vector<std::shared_ptr<Batch>>* batches) {
+  ++pending_;
+  auto leader = leaders_[partId];
+  if (leader.host.empty()) {
+    orphansOf(target)->append(partId, std::forward<Row>(row));
+    return;
+  }
+  auto* batch = batchOf(target, leader);
+  batch->append(partId, std::forward<Row>(row));
+  if (batch->rows_ < config_.batchRows_) {
+    return;
+  }
+  seal(BatchKey(target, leader));
+  take(leader, batches);
+}
+
+bool BulkWriter::flush() {
+  std::vector<std::shared_ptr<Batch>> batches;
+  std::unique_lock<std::mutex> guard(lock_);
+  std::vector<BatchKey> keys;
+  for (const auto& entry : open_) {
+    keys.emplace_back(entry.first);
+  }
+  for (const auto& key : keys) {
+    seal(key);
+  }
+  for (const auto& entry : sealed_) {
+    take(entry.first, &batches);
+  }
+  guard.unlock();
+  send(std::move(batches));
+  // The orphans are sent by the flusher
+  wakeup_.notify_one();
+  guard.lock();
+  idle_.wait(guard, [this] { return pending_ == 0; });
+  return stats_.failedRows_ == 0;
+}
+
+bool BulkWriter::finish() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (stopped_) {
+      return stats_.failedRows_ == 0;
+    }
+  }
+  auto ok = flush();
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopped_ = true;
+  }
+  wakeup_.notify_all();
+  notFull_.notify_all();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+  return ok;
+}
+
+BulkWriterStats BulkWriter::stats() const {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto stats = stats_;
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - start_)
+                     .count();
+  if (elapsed > 0) {
+    stats.rowsPerSecond_ = static_cast<double>(stats.rows_) * 1000000 / elapsed;
+  }
+  return stats;
+}
+
+BulkWriter::Batch* BulkWriter::batchOf(std::size_t target, const HostAddr& leader) {
+  auto& batch = open_[BatchKey(target, leader)];
+  if (batch == nullptr) {
+    const auto& t = targets_[target];
+    batch.reset(new Batch);
+    batch->target_ = target;
+    batch->isEdge_ = t.isEdge_;
+    batch->leader_ = leader;
+    batch->since_ = std::chrono::steady_clock::now();
+    if (t.isEdge_) {
+      batch->edges_.set_space_id(spaceId_);
+      batch->edges_.set_prop_names(t.propNames_);
+      batch->edges_.set_if_not_exists(config_.ifNotExists_);
+      batch->edges_.set_ignore_existed_index(config_.ignoreExistedIndex_);
+    } else {
+      batch->vertices_.set_space_id(spaceId_);
+      batch->vertices_.set_prop_names({{t.id_, t.propNames_}});
+      batch->vertices_.set_if_not_exists(config_.ifNotExists_);
+      batch->vertices_.set_ignore_existed_index(config_.ignoreExistedIndex_);
+    }
+  }
+  return batch.get();
+}
+
+BulkWriter::Batch* BulkWriter::orphansOf(std::size_t target) {
+  auto& batch = orphans_[target];
+  if (batch == nullptr) {
+    batch.reset(new Batch);
+    batch->target_ = target;
+    batch->isEdge_ = targets_[target].isEdge_;
+  }
+  return batch.get();
+}
+
+BulkWriter::BatchKey BulkWriter::reroute(Batch* batch, PartitionID partId) {
+  auto leader = leaders_[partId];
+  auto* to = leader.host.empty() ? orphansOf(batch->target_) : batchOf(batch->target_, leader);
+  batch->moveTo(partId, to);
+  return BatchKey(batch->target_, leader);
+}
+
+void BulkWriter::seal(const BatchKey& key) {
+  auto it = open_.find(key);
+  if (it == open_.end()) {
+    return;
+  }
+  sealed_[key.second].emplace_back(std::move(it->second));
+  open_.erase(it);
+}
+
+void BulkWriter::take(const HostAddr& host, std::vector<std::shared_ptr<Batch>>* batches) {
+  auto& queue = sealed_[host];
+  auto& inflight = inflight_[host];
+  while (!queue.empty() &&
+         (config_.maxInflightPerHost_ <= 0 || inflight < config_.maxInflightPerHost_)) {
+    batches->emplace_back(std::move(queue.front()));
+    queue.pop_front();
+    ++inflight;
+  }
+}
+
+void BulkWriter::send(std::vector<std::shared_ptr<Batch>> batches) {
+  for (auto& batch : batches) {
+    // The request is a copy, the batch keeps the rows to reroute the parts
+    // failed
+    auto future = batch->isEdge_ ? client_->doAddEdgesAsync(batch->leader_, batch->edges_)
+                                 : client_->doAddVerticesAsync(batch->leader_, batch->vertices_);
+    std::move(future).thenValue(
+        [batch = std::move(batch), this](std::pair<bool, storage::cpp2::ExecResponse>&& r) {
+          onResponse(batch, r.first, r.second);
+        });
+  }
+}
+
+void BulkWriter::onResponse(const std::shared_ptr<Batch>& batch,
+                            bool succeeded,
+                            const storage::cpp2::ExecResponse& resp) {
+  std::vector<std::shared_ptr<Batch>> batches;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    ++stats_.requests_;
+    --inflight_[batch->leader_];
+
+    // The failed parts with their codes and leaders, all parts if the
+    // request failed
+    std::vector<std::tuple<PartitionID, nebula::cpp2::ErrorCode, HostAddr>> failedParts;
+    if (!succeeded) {
+      for (auto partId : batch->partIds()) {
+        failedParts.emplace_back(partId, nebula::cpp2::ErrorCode::E_RPC_FAILURE, HostAddr());
+      }
+    } else {
+      for (const auto& failedPart : resp.get_result().get_failed_parts()) {
+        auto leader = failedPart.leader_ref();
+        failedParts.emplace_back(failedPart.get_part_id(),
+                                 failedPart.get_code(),
+                                 leader.has_value() ? leader.value() : HostAddr());
+      }
+    }
+
+    std::vector<BatchKey> rerouted;
+    Batch failed;
+    failed.isEdge_ = batch->isEdge_;
+    for (const auto& failedPart : failedParts) {
+      auto partId = std::get<0>(failedPart);
+      auto code = std::get<1>(failedPart);
+      const auto& leader = std::get<2>(failedPart);
+      if (partId <= 0 || partId > router_.numParts()) {
+        continue;
+      }
+      bool retriable = code == nebula::cpp2::ErrorCode::E_RPC_FAILURE ||
+                       code == nebula::cpp2::ErrorCode::E_LEADER_CHANGED ||
+                       code == nebula::cpp2::ErrorCode::E_PART_NOT_FOUND;
+      if (!retriable || !retry(partId)) {
+        LOG(ERROR) << "Write part " << partId << " of space " << spaceId_ << " failed, code "
+                   << static_cast<int32_t>(code);
+        done(batch->moveTo(partId, &failed), false);
+        continue;
+      }
+      ++stats_.retries_;
+      if (code == nebula::cpp2::ErrorCode::E_LEADER_CHANGED && !leader.host.empty()) {
+        leaders_[partId] = leader;
+        ++leaderVersions_[partId];
+        client_->getMetaClient()->updateLeader(spaceId_, partId, leader);
+      } else {
+        // The leaders are loaded again by the flusher
+        leaders_[partId] = HostAddr();
+      }
+      rerouted.emplace_back(reroute(batch.get(), partId));
+    }
+
+    // The rows left are written
+    for (auto partId : batch->partIds()) {
+      partRetries_[partId] = 0;
+    }
+    done(batch->rows_, true);
+
+    take(batch->leader_, &batches);
+    for (const auto& key : rerouted) {
+      seal(key);
+      take(key.second, &batches);
+    }
+  }
+  send(std::move(batches));
+}
+
+bool BulkWriter::retry(PartitionID partId) {
+  if (++partRetries_[partId] > config_.retryTimes_) {
+    partRetries_[partId] = 0;
+    return false;
+  }
+  return true;
+}
+
+void BulkWriter::done(int64_t rows, bool succeeded) {
+  if (succeeded) {
+    stats_.rows_ += rows;
+  } else {
+    stats_.failedRows_ += rows;
+  }
+  pending_ -= rows;
+  notFull_.notify_all();
+  if (pending_ == 0) {
+    idle_.notify_all();
+  }
+}
+
+void BulkWriter::flushLoop() {
+  auto interval = std::chrono::milliseconds(config_.flushIntervalMs_);
+  std::unique_lock<std::mutex> guard(lock_);
+  while (!stopped_) {
+    wakeup_.wait_for(guard, interval);
+    if (stopped_) {
+      break;
+    }
+
+    if (!orphans_.empty()) {
+      guard.unlock();
+      loadLeaders(true);
+      guard.lock();
+      auto orphans = std::move(orphans_);
+      orphans_.clear();
+      for (auto& entry : orphans) {
+        auto* batch = entry.second.get();
+        Batch failed;
+        failed.isEdge_ = batch->isEdge_;
+        for (auto partId : batch->partIds()) {
+          if (leaders_[partId].host.empty() && !retry(partId)) {
+            LOG(ERROR) << "Part " << partId << " of space " << spaceId_ << " has no leader";
+            done(batch->moveTo(partId, &failed), false);
+            continue;
+          }
+          // Sent with the other rows of the leader below
+          auto key = reroute(batch, partId);
+          auto it = open_.find(key);
+          if (it != open_.end()) {
+            it->second->since_ = std::chrono::steady_clock::time_point();
+          }
+        }
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<BatchKey> expired;
+    for (const auto& entry : open_) {
+      if (now - entry.second->since_ >= interval) {
+        expired.emplace_back(entry.first);
+      }
+    }
+    for (const auto& key : expired) {
+      seal(key);
+    }
+    std::vector<std::shared_ptr<Batch>> batches;
+    for (const auto& entry : sealed_) {
+      take(entry.first, &batches);
+    }
+    if (!batches.empty()) {
+      guard.unlock();
+      send(std::move(batches));
+      guard.lock();
+    }
+  }
+}
+
+void BulkWriter::loadLeaders(bool refresh) {
+  std::vector<int64_t> versions;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    versions = leaderVersions_;
+  }
+  auto* mClient = client_->getMetaClient();
+  if (refresh) {
+    mClient->refreshLeaders();
+  }
+  std::vector<std::pair<PartitionID, HostAddr>> leaders;
+  for (PartitionID partId = 1; partId <= router_.numParts(); ++partId) {
+    auto leader = mClient->getPartLeaderFromCache(spaceId_, partId);
+    if (leader.first) {
+      leaders.emplace_back(partId, std::move(leader.second));
+    }
+  }
+  // Merge them, a leader told by a response since is newer than the cache read
+  std::lock_guard<std::mutex> guard(lock_);
+  for (auto& leader : leaders) {
+    if (leaderVersions_[leader.first] == versions[leader.first]) {
+      leaders_[leader.first] = std::move(leader.second);
+    }
+  }
+}
+
+}  // namespace nebula
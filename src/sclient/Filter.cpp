@@ -0,0 +1,263 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/Filter.h"
+
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include "common/datatypes/ValueOps-inl.h"
+
+namespace nebula {
+
+namespace {
+
+// The same as Expression::Encoder of nebula
+void writeSize(std::size_t size, std::string* buf) {
+  buf->append(reinterpret_cast<const char*>(&size), sizeof(size));
+}
+
+void writeStr(const std::string& str, std::string* buf) {
+  writeSize(str.size(), buf);
+  buf->append(str);
+}
+
+const char* opName(Filter::Kind kind) {
+  switch (kind) {
+    case Filter::Kind::kAdd:
+      return "+";
+    case Filter::Kind::kMinus:
+    case Filter::Kind::kUnaryNegate:
+      return "-";
+    case Filter::Kind::kMultiply:
+      return "*";
+    case Filter::Kind::kDivision:
+      return "/";
+    case Filter::Kind::kMod:
+      return "%";
+    case Filter::Kind::kUnaryNot:
+      return "!";
+    case Filter::Kind::kRelEQ:
+      return "==";
+    case Filter::Kind::kRelNE:
+      return "!=";
+    case Filter::Kind::kRelLT:
+      return "<";
+    case Filter::Kind::kRelLE:
+      return "<=";
+    case Filter::Kind::kRelGT:
+      return ">";
+    case Filter::Kind::kRelGE:
+      return ">=";
+    case Filter::Kind::kRelREG:
+      return " =~ ";
+    case Filter::Kind::kRelIn:
+      return " IN ";
+    case Filter::Kind::kRelNotIn:
+      return " NOT IN ";
+    case Filter::Kind::kContains:
+      return " CONTAINS ";
+    case Filter::Kind::kStartsWith:
+      return " STARTS WITH ";
+    case Filter::Kind::kEndsWith:
+      return " ENDS WITH ";
+    case Filter::Kind::kLogicalAnd:
+      return " AND ";
+    case Filter::Kind::kLogicalOr:
+      return " OR ";
+    case Filter::Kind::kIsNull:
+      return " IS NULL";
+    case Filter::Kind::kIsNotNull:
+      return " IS NOT NULL";
+    case Filter::Kind::kIsEmpty:
+      return " IS EMPTY";
+    case Filter::Kind::kIsNotEmpty:
+      return " IS NOT EMPTY";
+    default:
+      return "?";
+  }
+}
+
+}  // namespace
+
+Filter::Filter(Value value) : kind_(Kind::kConstant), value_(std::move(value)) {}
+
+Filter::Filter(Kind kind, std::string ref, std::string sym, std::string prop)
+    : kind_(kind), ref_(std::move(ref)), sym_(std::move(sym)), prop_(std::move(prop)) {}
+
+Filter Filter::edgeProp(std::string edge, std::string prop) {
+  return Filter(Kind::kEdgeProperty, "", std::move(edge), std::move(prop));
+}
+
+Filter Filter::tagProp(std::string tag, std::string prop) {
+  return Filter(Kind::kTagProperty, "", std::move(tag), std::move(prop));
+}
+
+Filter Filter::srcProp(std::string tag, std::string prop) {
+  return Filter(Kind::kSrcProperty, "$^", std::move(tag), std::move(prop));
+}
+
+Filter Filter::dstProp(std::string tag, std::string prop) {
+  return Filter(Kind::kDstProperty, "$$", std::move(tag), std::move(prop));
+}
+
+Filter Filter::edgeSrc(std::string edge) {
+  return Filter(Kind::kEdgeSrc, "", std::move(edge), "_src");
+}
+
+Filter Filter::edgeType(std::string edge) {
+  return Filter(Kind::kEdgeType, "", std::move(edge), "_type");
+}
+
+Filter Filter::edgeRank(std::string edge) {
+  return Filter(Kind::kEdgeRank, "", std::move(edge), "_rank");
+}
+
+Filter Filter::edgeDst(std::string edge) {
+  return Filter(Kind::kEdgeDst, "", std::move(edge), "_dst");
+}
+
+Filter Filter::isNull() const {
+  return unary(Kind::kIsNull, *this);
+}
+
+Filter Filter::isNotNull() const {
+  return unary(Kind::kIsNotNull, *this);
+}
+
+Filter Filter::isEmpty() const {
+  return unary(Kind::kIsEmpty, *this);
+}
+
+Filter Filter::isNotEmpty() const {
+  return unary(Kind::kIsNotEmpty, *this);
+}
+
+Filter Filter::in(List values) const {
+  return binary(Kind::kRelIn, *this, Value(std::move(values)));
+}
+
+Filter Filter::notIn(List values) const {
+  return binary(Kind::kRelNotIn, *this, Value(std::move(values)));
+}
+
+Filter Filter::contains(Filter str) const {
+  return binary(Kind::kContains, *this, std::move(str));
+}
+
+Filter Filter::startsWith(Filter str) const {
+  return binary(Kind::kStartsWith, *this, std::move(str));
+}
+
+Filter Filter::endsWith(Filter str) const {
+  return binary(Kind::kEndsWith, *this, std::move(str));
+}
+
+Filter Filter::matches(Filter regex) const {
+  return binary(Kind::kRelREG, *this, std::move(regex));
+}
+
+Filter Filter::binary(Kind kind, Filter lhs, Filter rhs) {
+  Filter filter(kind, "", "", "");
+  filter.operands_.reserve(2);
+  filter.operands_.emplace_back(std::move(lhs));
+  filter.operands_.emplace_back(std::move(rhs));
+  return filter;
+}
+
+Filter Filter::logical(Kind kind, Filter lhs, Filter rhs) {
+  Filter filter(kind, "", "", "");
+  for (auto* operand : {&lhs, &rhs}) {
+    if (operand->kind_ == kind) {
+      for (auto& op : operand->operands_) {
+        filter.operands_.emplace_back(std::move(op));
+      }
+    } else {
+      filter.operands_.emplace_back(std::move(*operand));
+    }
+  }
+  return filter;
+}
+
+Filter Filter::unary(Kind kind, Filter operand) {
+  Filter filter(kind, "", "", "");
+  filter.operands_.emplace_back(std::move(operand));
+  return filter;
+}
+
+std::string Filter::encode() const {
+  std::string buf;
+  buf.reserve(256);
+  writeTo(&buf);
+  return buf;
+}
+
+void Filter::writeTo(std::string* buf) const {
+  buf->push_back(static_cast<char>(kind_));
+  switch (kind_) {
+    case Kind::kConstant:
+      apache::thrift::CompactSerializer::serialize(value_, buf);
+      return;
+    case Kind::kEdgeProperty:
+    case Kind::kTagProperty:
+    case Kind::kSrcProperty:
+    case Kind::kDstProperty:
+    case Kind::kEdgeSrc:
+    case Kind::kEdgeType:
+    case Kind::kEdgeRank:
+    case Kind::kEdgeDst:
+      writeStr(ref_, buf);
+      writeStr(sym_, buf);
+      writeStr(prop_, buf);
+      return;
+    case Kind::kLogicalAnd:
+    case Kind::kLogicalOr:
+      // The operands of a logical expression are counted
+      writeSize(operands_.size(), buf);
+      break;
+    default:
+      break;
+  }
+  for (const auto& operand : operands_) {
+    operand.writeTo(buf);
+  }
+}
+
+std::string Filter::toString() const {
+  switch (kind_) {
+    case Kind::kConstant:
+      return value_.toString();
+    case Kind::kEdgeProperty:
+    case Kind::kTagProperty:
+    case Kind::kEdgeSrc:
+    case Kind::kEdgeType:
+    case Kind::kEdgeRank:
+    case Kind::kEdgeDst:
+      return sym_ + "." + prop_;
+    case Kind::kSrcProperty:
+    case Kind::kDstProperty:
+      return ref_ + "." + sym_ + "." + prop_;
+    case Kind::kUnaryNot:
+    case Kind::kUnaryNegate:
+      return opName(kind_) + operands_[0].toString();
+    case Kind::kIsNull:
+    case Kind::kIsNotNull:
+    case Kind::kIsEmpty:
+    case Kind::kIsNotEmpty:
+      return operands_[0].toString() + opName(kind_);
+    default:
+      break;
+  }
+  std::string str = "(";
+  for (std::size_t i = 0; i < operands_.size(); ++i) {
+    if (i != 0) {
+      str += opName(kind_);
+    }
+    str += operands_[i].toString();
+  }
+  str += ")";
+  return str;
+}
+
+}  // namespace nebula
@@ -0,0 +1,114 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/HostLimiter.h"
+
+#include <algorithm>
+
+namespace nebula {
+
+namespace {
+
+// The requests at the back of a queue tried for a merge, as the later ones
+// are the likeliest to be alike and the search is done with the lock held
+constexpr std::size_t kMergeScan = 8;
+
+}  // namespace
+
+HostLimiter::HostLimiter(const SConfig& sConfig)
+    : maxInflight_(std::max(sConfig.maxInflightPerHost_, 0)),
+      targetLatencyUs_(int64_t(std::max(sConfig.targetLatencyMs_, 0)) * 1000),
+      coalesce_(sConfig.coalesceRequests_) {}
+
+void HostLimiter::submit(const HostAddr& host, std::unique_ptr<Pending> request) {
+  if (maxInflight_ == 0) {
+    request->send();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    auto& h = hosts_[host];
+    if (h.limit_ == 0) {
+      h.limit_ = maxInflight_;
+    }
+    if (h.queue_.empty() && h.inflight_ < static_cast<int32_t>(h.limit_)) {
+      ++h.inflight_;
+    } else {
+      if (coalesce_) {
+        auto scan = std::min(h.queue_.size(), kMergeScan);
+        for (auto it = h.queue_.rbegin(); it != h.queue_.rbegin() + scan; ++it) {
+          if ((*it)->merge(request.get())) {
+            ++stats_.merged_;
+            return;
+          }
+        }
+      }
+      ++stats_.queued_;
+      h.queue_.emplace_back(std::move(request));
+      return;
+    }
+  }
+  request->send();
+}
+
+void HostLimiter::release(const HostAddr& host, int64_t latencyUs, bool succeeded) {
+  if (maxInflight_ == 0) {
+    return;
+  }
+  std::deque<std::unique_ptr<Pending>> ready;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    auto found = hosts_.find(host);
+    if (found == hosts_.end()) {
+      return;
+    }
+    auto& h = found->second;
+    --h.inflight_;
+    if (targetLatencyUs_ > 0) {
+      // Add about 1 to the limit after a round of fast responses, and halve
+      // it after a slow one or a failure, but once for the requests which
+      // were in flight together
+      bool fast = succeeded && latencyUs <= targetLatencyUs_;
+      if (h.holdDecrease_ > 0) {
+        --h.holdDecrease_;
+      } else if (!fast) {
+        h.limit_ = std::max(h.limit_ / 2, 1.0);
+        h.holdDecrease_ = h.inflight_;
+        ++stats_.decreases_;
+      }
+      if (fast) {
+        h.limit_ = std::min<double>(h.limit_ + 1 / h.limit_, maxInflight_);
+      }
+    }
+    takeReady(&h, &ready);
+  }
+  for (auto& request : ready) {
+    request->send();
+  }
+}
+
+void HostLimiter::takeReady(Host* host, std::deque<std::unique_ptr<Pending>>* ready) {
+  while (!host->queue_.empty() && host->inflight_ < static_cast<int32_t>(host->limit_)) {
+    ++host->inflight_;
+    ready->emplace_back(std::move(host->queue_.front()));
+    host->queue_.pop_front();
+  }
+}
+
+int32_t HostLimiter::limitOf(const HostAddr& host) const {
+  if (maxInflight_ == 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> g(lock_);
+  auto found = hosts_.find(host);
+  return found == hosts_.end() ? maxInflight_ : static_cast<int32_t>(found->second.limit_);
+}
+
+HostLimiterStats HostLimiter::stats() const {
+  std::lock_guard<std::mutex> g(lock_);
+  return stats_;
+}
+
+}  // namespace nebula
@@ -0,0 +1,72 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/ParallelScanIter.h"
+
+#include <algorithm>
+
+namespace nebula {
+
+ParallelScanIter::ParallelScanIter(Runner runner, std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1)) {
+  thread_ = std::thread([this, runner = std::move(runner)]() {
+    auto ok = runner([this](PartitionID partId, DataSet&& page) {
+      return push(partId, std::move(page));
+    });
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      finished_ = true;
+      succeeded_ = ok;
+    }
+    notEmpty_.notify_all();
+  });
+}
+
+ParallelScanIter::~ParallelScanIter() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    closed_ = true;
+  }
+  notFull_.notify_all();
+  notEmpty_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool ParallelScanIter::push(PartitionID partId, DataSet&& page) {
+  std::unique_lock<std::mutex> guard(lock_);
+  notFull_.wait(guard, [this] { return closed_ || pages_.size() < capacity_; });
+  if (closed_) {
+    return false;
+  }
+  pages_.emplace_back(partId, std::move(page));
+  guard.unlock();
+  notEmpty_.notify_one();
+  return true;
+}
+
+bool ParallelScanIter::next(DataSet* page, PartitionID* partId) {
+  std::unique_lock<std::mutex> guard(lock_);
+  notEmpty_.wait(guard, [this] { return closed_ || finished_ || !pages_.empty(); });
+  if (pages_.empty()) {
+    return false;
+  }
+  if (partId != nullptr) {
+    *partId = pages_.front().first;
+  }
+  *page = std::move(pages_.front().second);
+  pages_.pop_front();
+  guard.unlock();
+  notFull_.notify_one();
+  return true;
+}
+
+bool ParallelScanIter::succeeded() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return succeeded_;
+}
+
+}  // namespace nebula
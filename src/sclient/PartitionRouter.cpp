@@ -0,0 +1,131 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/PartitionRouter.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "nebula/mclient/MetaClient.h"
+
+namespace nebula {
+
+PartitionRouter::PartitionRouter(int32_t numParts, bool intVid)
+    : numParts_(std::max(numParts, 1)), intVid_(intVid) {
+  uint64_t n = numParts_;
+  if (n > 1 && (n & (n - 1)) == 0) {
+    mask_ = n - 1;
+  }
+}
+
+std::pair<bool, PartitionRouter> PartitionRouter::make(MetaClient* metaClient,
+                                                       GraphSpaceID spaceId) {
+  auto ret = metaClient->getSpaceInfoFromCache(spaceId);
+  if (!ret.first || ret.second.partNum_ <= 0) {
+    return {false, PartitionRouter(1, false)};
+  }
+  return {true, PartitionRouter(ret.second.partNum_, ret.second.intVid_)};
+}
+
+PartitionID PartitionRouter::partFor(const Value& vid) const {
+  uint64_t id = 0;
+  if (intVid_) {
+    if (!vid.isInt()) {
+      return 0;
+    }
+    auto v = vid.getInt();
+    std::memcpy(&id, &v, sizeof(id));
+  } else {
+    if (!vid.isStr()) {
+      return 0;
+    }
+    return partForKey(vid.getStr());
+  }
+  return partOf(id);
+}
+
+PartitionID PartitionRouter::partForKey(folly::StringPiece key) const {
+  uint64_t id = 0;
+  if (key.size() == sizeof(id)) {
+    std::memcpy(&id, key.data(), sizeof(id));
+  } else {
+    id = hash(key);
+  }
+  return partOf(id);
+}
+
+bool PartitionRouter::partsFor(folly::Range<const Value*> vids, PartitionID* parts) const {
+  bool ok = true;
+  for (std::size_t i = 0; i < vids.size(); ++i) {
+    parts[i] = partFor(vids[i]);
+    ok = ok && parts[i] != 0;
+  }
+  return ok;
+}
+
+void PartitionRouter::partsForInts(folly::Range<const int64_t*> vids, PartitionID* parts) const {
+  const auto* ids = vids.data();
+  auto n = vids.size();
+  if (mask_ != 0) {
+    for (std::size_t i = 0; i < n; ++i) {
+      parts[i] = static_cast<PartitionID>((static_cast<uint64_t>(ids[i]) & mask_) + 1);
+    }
+    return;
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    parts[i] = static_cast<PartitionID>(static_cast<uint64_t>(ids[i]) % numParts_ + 1);
+  }
+}
+
+uint64_t PartitionRouter::hash(folly::StringPiece vid) {
+  // nebula hashes the vid as a C string
+  auto len = std::find(vid.begin(), vid.end(), '\0') - vid.begin();
+  const char* key = vid.data();
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  uint64_t h = 0xc70f6907ULL ^ (len * m);
+  const char* end = key + len / 8 * 8;
+  for (; key != end; key += 8) {
+    uint64_t k;
+    std::memcpy(&k, key, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  const auto* tail = reinterpret_cast<const unsigned char*>(key);
+  switch (len & 7) {
+    case 7:
+      h ^= uint64_t(tail[6]) << 48;
+      [[fallthrough]];
+    case 6:
+      h ^= uint64_t(tail[5]) << 40;
+      [[fallthrough]];
+    case 5:
+      h ^= uint64_t(tail[4]) << 32;
+      [[fallthrough]];
+    case 4:
+      h ^= uint64_t(tail[3]) << 24;
+      [[fallthrough]];
+    case 3:
+      h ^= uint64_t(tail[2]) << 16;
+      [[fallthrough]];
+    case 2:
+      h ^= uint64_t(tail[1]) << 8;
+      [[fallthrough]];
+    case 1:
+      h ^= uint64_t(tail[0]);
+      h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+}  // namespace nebula
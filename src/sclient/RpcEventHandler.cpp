@@ -0,0 +1,83 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "RpcEventHandler.h"
+
+#include "interface/gen-cpp2/storage_types.h"
+
+namespace nebula {
+
+namespace {
+
+// The call sending on this thread, the request is serialized before send()
+// returns so the context of the client can be tied to it
+thread_local RpcCall* tSending = nullptr;
+
+RpcCall* callOf(void* ctx) {
+  return ctx == nullptr ? nullptr : static_cast<std::shared_ptr<RpcCall>*>(ctx)->get();
+}
+
+}  // namespace
+
+RpcCall::Sending::Sending(RpcCall* call) {
+  tSending = call;
+}
+
+RpcCall::Sending::~Sending() {
+  tSending = nullptr;
+}
+
+void RpcCall::finish(const storage::cpp2::ResponseCommon* common) {
+  latency_.totalUs_ = sinceUs(start_);
+  if (common == nullptr) {
+    return;
+  }
+  latency_.serverUs_ = common->get_latency_in_us();
+  auto detail = common->latency_detail_us_ref();
+  if (detail.has_value()) {
+    latency_.serverDetailUs_.insert(detail.value().begin(), detail.value().end());
+  }
+}
+
+void* RpcEventHandler::getContext(const char*, apache::thrift::TConnectionContext*) {
+  // The response may arrive after the caller is gone, so the context keeps
+  // the call alive
+  return tSending == nullptr ? nullptr : new std::shared_ptr<RpcCall>(tSending->shared_from_this());
+}
+
+void RpcEventHandler::freeContext(void* ctx, const char*) {
+  delete static_cast<std::shared_ptr<RpcCall>*>(ctx);
+}
+
+void RpcEventHandler::preWrite(void* ctx, const char*) {
+  if (auto* call = callOf(ctx)) {
+    call->serializeStart_ = std::chrono::steady_clock::now();
+  }
+}
+
+void RpcEventHandler::postWrite(void* ctx, const char*, uint32_t bytes) {
+  if (auto* call = callOf(ctx)) {
+    call->latency_.serializeUs_ += RpcCall::sinceUs(call->serializeStart_);
+    call->latency_.bytesOut_ += bytes;
+  }
+}
+
+void RpcEventHandler::preRead(void* ctx, const char*) {
+  if (auto* call = callOf(ctx)) {
+    call->serializeStart_ = std::chrono::steady_clock::now();
+  }
+}
+
+void RpcEventHandler::postRead(void* ctx,
+                               const char*,
+                               apache::thrift::transport::THeader*,
+                               uint32_t bytes) {
+  if (auto* call = callOf(ctx)) {
+    call->latency_.serializeUs_ += RpcCall::sinceUs(call->serializeStart_);
+    call->latency_.bytesIn_ += bytes;
+  }
+}
+
+}  // namespace nebula
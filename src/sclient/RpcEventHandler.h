@@ -0,0 +1,90 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <thrift/lib/cpp/TProcessorEventHandler.h>
+
+#include <chrono>
+#include <memory>
+
+#include "nebula/sclient/RpcStats.h"
+
+namespace nebula {
+
+namespace storage {
+namespace cpp2 {
+
+class ResponseCommon;
+
+}  // namespace cpp2
+}  // namespace storage
+
+// Measure a storage RPC from the call to the response. The request is sent
+// on the IO thread by send(), the serialization of the request and of its
+// response is measured by RpcEventHandler, which is added to the clients.
+class RpcCall : public std::enable_shared_from_this<RpcCall> {
+ public:
+  RpcCall() : start_(std::chrono::steady_clock::now()) {}
+
+  // Call sender, which sends the request and returns its future, counting
+  // the time since the call was made as queued
+  template <typename Sender>
+  auto send(Sender&& sender) {
+    latency_.queueUs_ = sinceUs(start_);
+    Sending sending(this);
+    return sender();
+  }
+
+  // Count the response, nullptr if there is none
+  void finish(const storage::cpp2::ResponseCommon* common);
+
+  const RpcLatency& latency() const {
+    return latency_;
+  }
+
+ private:
+  friend class RpcEventHandler;
+
+  // Mark the call sending on this thread
+  class Sending {
+   public:
+    explicit Sending(RpcCall* call);
+    ~Sending();
+  };
+
+  static int64_t sinceUs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                 start)
+        .count();
+  }
+
+  std::chrono::steady_clock::time_point start_;
+  // When the serialization in progress started
+  std::chrono::steady_clock::time_point serializeStart_;
+  RpcLatency latency_;
+};
+
+// Count the serialization and the bytes of the calls sent by RpcCall::send()
+// on the clients it's added to, the others are ignored
+class RpcEventHandler : public apache::thrift::TProcessorEventHandler {
+ public:
+  void* getContext(const char* fnName, apache::thrift::TConnectionContext* connCtx) override;
+
+  void freeContext(void* ctx, const char* fnName) override;
+
+  void preWrite(void* ctx, const char* fnName) override;
+
+  void postWrite(void* ctx, const char* fnName, uint32_t bytes) override;
+
+  void preRead(void* ctx, const char* fnName) override;
+
+  void postRead(void* ctx,
+                const char* fnName,
+                apache::thrift::transport::THeader* header,
+                uint32_t bytes) override;
+};
+
+}  // namespace nebula
@@ -0,0 +1,73 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/RpcStats.h"
+
+#include <cmath>
+
+namespace nebula {
+
+namespace {
+
+std::size_t bucketOf(int64_t us) {
+  std::size_t bucket = 0;
+  for (auto v = static_cast<uint64_t>(us); v != 0; v >>= 1) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+void LatencyHistogram::add(int64_t us) {
+  us = std::max<int64_t>(us, 0);
+  ++buckets_[std::min(bucketOf(us), kBuckets - 1)];
+  ++count_;
+  sumUs_ += us;
+  maxUs_ = std::max(maxUs_, us);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sumUs_ += other.sumUs_;
+  maxUs_ = std::max(maxUs_, other.maxUs_);
+}
+
+int64_t LatencyHistogram::percentileUs(double p) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<int64_t>(std::ceil(std::min(std::max(p, 0.0), 100.0) / 100 * count_));
+  rank = std::max<int64_t>(rank, 1);
+  int64_t seen = 0;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      auto upper = static_cast<int64_t>((uint64_t(1) << i) - 1);
+      return std::min(upper, maxUs_);
+    }
+  }
+  return maxUs_;
+}
+
+void RpcStats::add(const RpcLatency& latency, bool succeeded) {
+  ++calls_;
+  totalUs_.add(latency.totalUs_);
+  queueUs_.add(latency.queueUs_);
+  if (!succeeded) {
+    ++failures_;
+    return;
+  }
+  bytesOut_ += latency.bytesOut_;
+  bytesIn_ += latency.bytesIn_;
+  serializeUs_.add(latency.serializeUs_);
+  serverUs_.add(latency.serverUs_);
+  networkUs_.add(latency.networkUs());
+}
+
+}  // namespace nebula
@@ -0,0 +1,131 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/ScanCheckpoint.h"
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/json.h>
+#include <glog/logging.h>
+
+namespace nebula {
+
+namespace {
+
+// Cursors and filters are binary
+std::string hex(const std::string& data) {
+  std::string out;
+  folly::hexlify(data, out);
+  return out;
+}
+
+std::string unhex(const std::string& data) {
+  std::string out;
+  if (!folly::unhexlify(data, out)) {
+    throw std::invalid_argument("Bad hex string " + data);
+  }
+  return out;
+}
+
+folly::dynamic toArray(const std::vector<std::string>& strs) {
+  folly::dynamic arr = folly::dynamic::array;
+  for (const auto& str : strs) {
+    arr.push_back(str);
+  }
+  return arr;
+}
+
+std::vector<std::string> fromArray(const folly::dynamic& arr) {
+  std::vector<std::string> strs;
+  for (const auto& str : arr) {
+    strs.emplace_back(str.asString());
+  }
+  return strs;
+}
+
+}  // namespace
+
+std::string ScanCheckpoint::toJson() const {
+  folly::dynamic tags = folly::dynamic::array;
+  for (const auto& tag : tagProps_) {
+    tags.push_back(folly::dynamic::object("name", tag.first)("props", toArray(tag.second)));
+  }
+  folly::dynamic cursors = folly::dynamic::object;
+  for (const auto& cursor : cursors_) {
+    cursors[folly::to<std::string>(cursor.first)] = hex(cursor.second);
+  }
+  folly::dynamic finished = folly::dynamic::array;
+  for (auto partId : finished_) {
+    finished.push_back(partId);
+  }
+  folly::dynamic obj = folly::dynamic::object;
+  obj["space"] = spaceName_;
+  obj["edge"] = edgeName_;
+  obj["props"] = toArray(propNames_);
+  obj["tags"] = std::move(tags);
+  obj["limit"] = limit_;
+  obj["start_time"] = startTime_;
+  obj["end_time"] = endTime_;
+  obj["filter"] = hex(filter_);
+  obj["only_latest_version"] = onlyLatestVersion_;
+  obj["enable_read_from_follower"] = enableReadFromFollower_;
+  obj["cursors"] = std::move(cursors);
+  obj["finished"] = std::move(finished);
+  obj["rows"] = rows_;
+  return folly::toPrettyJson(obj);
+}
+
+std::pair<bool, ScanCheckpoint> ScanCheckpoint::fromJson(const std::string& json) {
+  ScanCheckpoint checkpoint;
+  try {
+    auto obj = folly::parseJson(json);
+    checkpoint.spaceName_ = obj["space"].asString();
+    checkpoint.edgeName_ = obj["edge"].asString();
+    checkpoint.propNames_ = fromArray(obj["props"]);
+    for (const auto& tag : obj["tags"]) {
+      checkpoint.tagProps_.emplace_back(tag["name"].asString(), fromArray(tag["props"]));
+    }
+    checkpoint.limit_ = obj["limit"].asInt();
+    checkpoint.startTime_ = obj["start_time"].asInt();
+    checkpoint.endTime_ = obj["end_time"].asInt();
+    checkpoint.filter_ = unhex(obj["filter"].asString());
+    checkpoint.onlyLatestVersion_ = obj["only_latest_version"].asBool();
+    checkpoint.enableReadFromFollower_ = obj["enable_read_from_follower"].asBool();
+    for (const auto& cursor : obj["cursors"].items()) {
+      checkpoint.cursors_.emplace(folly::to<PartitionID>(cursor.first.asString()),
+                                  unhex(cursor.second.asString()));
+    }
+    for (const auto& partId : obj["finished"]) {
+      checkpoint.finished_.emplace(partId.asInt());
+    }
+    checkpoint.rows_ = obj["rows"].asInt();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Parse scan checkpoint failed: " << e.what();
+    return {false, ScanCheckpoint()};
+  }
+  return {true, std::move(checkpoint)};
+}
+
+bool ScanCheckpoint::save(const std::string& path) const {
+  try {
+    // Written to a temporary file which is renamed to path
+    folly::writeFileAtomic(path, toJson());
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Save scan checkpoint to " << path << " failed: " << e.what();
+    return false;
+  }
+  return true;
+}
+
+std::pair<bool, ScanCheckpoint> ScanCheckpoint::load(const std::string& path) {
+  std::string json;
+  if (!folly::readFile(path.c_str(), json)) {
+    LOG(ERROR) << "Read scan checkpoint from " << path << " failed";
+    return {false, ScanCheckpoint()};
+  }
+  return fromJson(json);
+}
+
+}  // namespace nebula
@@ -0,0 +1,288 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/ScanIter.h"
+
+#include <folly/futures/Future.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "../interface/gen-cpp2/storage_types.h"
+#include "nebula/sclient/StorageClient.h"
+
+namespace nebula {
+
+template <>
+const char* ScanIter<storage::cpp2::ScanEdgeRequest>::kind() {
+  return "edge";
+}
+
+template <>
+std::pair<bool, storage::cpp2::ScanResponse> ScanIter<storage::cpp2::ScanEdgeRequest>::scan(
+    const storage::cpp2::ScanEdgeRequest& req) {
+  return client_->doScanEdge(req);
+}
+
+template <>
+folly::Future<std::pair<bool, storage::cpp2::ScanResponse>>
+ScanIter<storage::cpp2::ScanEdgeRequest>::scanAsync(const storage::cpp2::ScanEdgeRequest& req) {
+  return client_->doScanEdgeAsync(req);
+}
+
+template <>
+const char* ScanIter<storage::cpp2::ScanVertexRequest>::kind() {
+  return "vertex";
+}
+
+template <>
+std::pair<bool, storage::cpp2::ScanResponse> ScanIter<storage::cpp2::ScanVertexRequest>::scan(
+    const storage::cpp2::ScanVertexRequest& req) {
+  return client_->doScanVertex(req);
+}
+
+template <>
+folly::Future<std::pair<bool, storage::cpp2::ScanResponse>>
+ScanIter<storage::cpp2::ScanVertexRequest>::scanAsync(
+    const storage::cpp2::ScanVertexRequest& req) {
+  return client_->doScanVertexAsync(req);
+}
+
+template <typename Request>
+ScanIter<Request>::ScanIter(StorageClient* client, Request* req, bool hasNext)
+    : client_(client),
+      req_(req),
+      hasNext_(hasNext),
+      prefetchDepth_(client == nullptr ? 0 : std::max(client->sConfig_.scanPrefetchDepth_, 0)) {
+  if (client != nullptr && req != nullptr) {
+    pageSizer_ = ScanPageSizer(client->sConfig_, req->get_limit());
+    if (pageSizer_.enabled()) {
+      req_->set_limit(pageSizer_.limit());
+    }
+  }
+}
+
+template <typename Request>
+bool ScanIter<Request>::hasNext() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return hasNext_ || inflight_ || !ready_.empty();
+}
+
+template <typename Request>
+ScanIter<Request>::~ScanIter() {
+  {
+    // The request in flight refers to this
+    std::unique_lock<std::mutex> guard(lock_);
+    cv_.wait(guard, [this] { return !inflight_; });
+  }
+  delete req_;
+}
+
+template <typename Request>
+DataSet ScanIter<Request>::next() {
+  if (!hasNext()) {
+    LOG(ERROR) << "hasNext() == false !";
+    return DataSet();
+  }
+  DCHECK(!!req_);
+  if (prefetchDepth_ == 0) {
+    while (true) {
+      backoff();
+      auto page = onResponse(scan(*req_));
+      // Nothing to return yet, the failed parts are retried
+      if (page.rows.empty() && retryPending_) {
+        continue;
+      }
+      return page;
+    }
+  }
+
+  bool more = false;
+  DataSet page;
+  {
+    std::unique_lock<std::mutex> guard(lock_);
+    while (ready_.empty()) {
+      if (!inflight_) {
+        if (!hasNext_) {
+          return DataSet();
+        }
+        inflight_ = true;
+        guard.unlock();
+        backoff();
+        fetch();
+        guard.lock();
+      }
+      cv_.wait(guard, [this] { return !ready_.empty() || !inflight_; });
+    }
+    page = std::move(ready_.front());
+    ready_.pop_front();
+    if (!inflight_ && hasNext_ && !retryPending_ && ready_.size() < prefetchDepth_) {
+      inflight_ = more = true;
+    }
+  }
+  if (more) {
+    fetch();
+  }
+  return page;
+}
+
+template <typename Request>
+void ScanIter<Request>::backoff() {
+  GraphSpaceID spaceId;
+  int64_t delay = 0;
+  std::vector<std::pair<PartitionID, HostAddr>> leaders;
+  bool refresh = false;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (!retryPending_) {
+      return;
+    }
+    retryPending_ = false;
+    spaceId = req_->get_space_id();
+    std::swap(delay, retryDelayMs_);
+    leaders.swap(leaderHints_);
+    std::swap(refresh, refreshLeaders_);
+  }
+  if (delay > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+  }
+  for (const auto& leader : leaders) {
+    client_->mClient_->updateLeader(spaceId, leader.first, leader.second);
+  }
+  if (refresh) {
+    client_->mClient_->refreshLeaders();
+  }
+}
+
+template <typename Request>
+void ScanIter<Request>::fetch() {
+  Request req;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    req = *req_;
+  }
+  scanAsync(req).thenValue(
+      [this](std::pair<bool, storage::cpp2::ScanResponse>&& r) {
+        bool more = false;
+        {
+          std::lock_guard<std::mutex> guard(lock_);
+          auto page = onResponse(std::move(r));
+          if (!page.rows.empty() || !retryPending_) {
+            ready_.emplace_back(std::move(page));
+          }
+          // Stop prefetching to back off and update the leaders, next() sends
+          // the retry
+          more = hasNext_ && !retryPending_ && ready_.size() < prefetchDepth_;
+          inflight_ = more;
+          cv_.notify_all();
+        }
+        // Keep fetching until the ready queue is full
+        if (more) {
+          fetch();
+        }
+      });
+}
+
+template <typename Request>
+bool ScanIter<Request>::retry(PartitionID partId,
+                              const storage::cpp2::ScanCursor& cursor,
+                              std::unordered_map<PartitionID, storage::cpp2::ScanCursor>* parts) {
+  const auto& sConfig = client_->sConfig_;
+  auto& times = retryTimes_[partId];
+  if (times >= sConfig.scanRetryTimes_) {
+    LOG(ERROR) << "Scan " << kind() << " of part " << partId << " failed after " << times
+               << " retries";
+    retryTimes_.erase(partId);
+    return false;
+  }
+  ++times;
+  ++retries_;
+  ++client_->scanRetries_;
+  retryPending_ = true;
+  int64_t delay = static_cast<int64_t>(sConfig.scanRetryIntervalMs_) << (times - 1);
+  retryDelayMs_ = std::max(retryDelayMs_, delay);
+  parts->emplace(partId, cursor);
+  return true;
+}
+
+template <typename Request>
+void ScanIter<Request>::fail(PartitionID partId, const storage::cpp2::ScanCursor& cursor) {
+  this->failed_ = true;
+  auto nextCursor = cursor.next_cursor_ref();
+  failedParts_[partId] = nextCursor.has_value() ? nextCursor.value() : "";
+}
+
+template <typename Request>
+DataSet ScanIter<Request>::onResponse(std::pair<bool, storage::cpp2::ScanResponse>&& r) {
+  const auto& partsReq = req_->get_parts();
+  std::unordered_map<PartitionID, storage::cpp2::ScanCursor> partCursorMapReq;
+  if (!r.first) {
+    LOG(ERROR) << "Scan " << kind() << " failed";
+    // The leaders may be gone, retry all parts from their cursors
+    refreshLeaders_ = true;
+    for (const auto& part : partsReq) {
+      if (!retry(part.first, part.second, &partCursorMapReq)) {
+        fail(part.first, part.second);
+      }
+    }
+    hasNext_ = !partCursorMapReq.empty();
+    req_->set_parts(std::move(partCursorMapReq));
+    return DataSet();
+  }
+  auto& scanResponse = r.second;
+  for (const auto& failedPart : scanResponse.get_result().get_failed_parts()) {
+    auto partId = failedPart.get_part_id();
+    auto code = failedPart.get_code();
+    auto part = partsReq.find(partId);
+    bool retryable = code == nebula::cpp2::ErrorCode::E_LEADER_CHANGED ||
+                     code == nebula::cpp2::ErrorCode::E_PART_NOT_FOUND ||
+                     code == nebula::cpp2::ErrorCode::E_RPC_FAILURE;
+    if (retryable && part != partsReq.end() &&
+        retry(partId, part->second, &partCursorMapReq)) {
+      VLOG(1) << "Retry scan " << kind() << " of part " << partId
+              << ", errorcode: " << static_cast<int32_t>(code);
+      auto leader = failedPart.leader_ref();
+      if (code == nebula::cpp2::ErrorCode::E_LEADER_CHANGED && leader.has_value() &&
+          !leader.value().host.empty()) {
+        leaderHints_.emplace_back(partId, leader.value());
+      } else {
+        refreshLeaders_ = true;
+      }
+      continue;
+    }
+    LOG(ERROR) << "Scan " << kind() << " of part " << partId
+               << " failed, errorcode: " << static_cast<int32_t>(code);
+    fail(partId, part != partsReq.end() ? part->second : storage::cpp2::ScanCursor());
+  }
+  // The parts which have more data go on from their next cursors, the
+  // finished and the failed ones are dropped
+  for (const auto& partCursor : scanResponse.get_cursors()) {
+    const auto& scanCursor = partCursor.second;
+    retryTimes_.erase(partCursor.first);
+    if (scanCursor.next_cursor_ref().has_value() && partsReq.count(partCursor.first)) {
+      nextCursor_ = scanCursor.next_cursor_ref().value();
+      partCursorMapReq.emplace(partCursor.first, scanCursor);
+    }
+  }
+  hasNext_ = !partCursorMapReq.empty();
+  req_->set_parts(std::move(partCursorMapReq));
+  if (scanResponse.get_props() == nullptr) {
+    return DataSet();
+  }
+  DataSet page = std::move(scanResponse.props_ref().value());
+  if (pageSizer_.enabled()) {
+    auto rows = static_cast<int64_t>(page.rowSize());
+    auto bytes = estimateScanBytes(page);
+    client_->recordScanPage(req_->get_limit(), rows, bytes);
+    req_->set_limit(pageSizer_.update(rows, bytes, scanResponse.get_result().get_latency_in_us()));
+  }
+  return page;
+}
+
+template struct ScanIter<storage::cpp2::ScanEdgeRequest>;
+template struct ScanIter<storage::cpp2::ScanVertexRequest>;
+
+}  //  namespace nebula
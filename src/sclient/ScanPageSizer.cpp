@@ -0,0 +1,82 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/ScanPageSizer.h"
+
+#include <algorithm>
+
+namespace nebula {
+
+namespace {
+
+// Weight of the last page in the moving averages
+constexpr double kPageWeight = 0.3;
+
+double average(double avg, double value) {
+  return avg == 0 ? value : avg * (1 - kPageWeight) + value * kPageWeight;
+}
+
+}  // namespace
+
+int64_t estimateScanBytes(const DataSet& page) {
+  int64_t bytes = 0;
+  for (const auto& row : page.rows) {
+    for (const auto& value : row.values) {
+      if (value.isStr()) {
+        bytes += value.getStr().size() + 4;
+      } else if (value.isNumeric() || value.isBool()) {
+        bytes += 8;
+      } else if (value.isNull()) {
+        bytes += 1;
+      } else {
+        bytes += value.toString().size();
+      }
+    }
+  }
+  return bytes;
+}
+
+ScanPageSizer::ScanPageSizer(const SConfig& sConfig, int64_t maxLimit)
+    : enabled_(sConfig.scanTargetPageLatencyMs_ > 0 || sConfig.scanTargetPageBytes_ > 0),
+      minLimit_(std::max<int64_t>(std::min(sConfig.scanMinPageSize_, maxLimit), 1)),
+      maxLimit_(std::max<int64_t>(maxLimit, 1)),
+      targetLatencyUs_(sConfig.scanTargetPageLatencyMs_ * 1000.0),
+      targetBytes_(static_cast<double>(sConfig.scanTargetPageBytes_)) {
+  limit_ = std::clamp(sConfig.scanInitialPageSize_, minLimit_, maxLimit_);
+  if (sConfig.scanMemoryBudgetBytes_ > 0) {
+    // The budget is shared by all pages which may be in flight at a time
+    auto pages = std::max(sConfig.scanConcurrency_, 1) *
+                 (std::max(sConfig.scanPrefetchDepth_, 0) + 1);
+    auto budget = static_cast<double>(sConfig.scanMemoryBudgetBytes_) / pages;
+    targetBytes_ = targetBytes_ > 0 ? std::min(targetBytes_, budget) : budget;
+  }
+}
+
+int64_t ScanPageSizer::update(int64_t rows, int64_t bytes, int64_t latencyUs) {
+  if (!enabled_ || rows <= 0) {
+    return limit_;
+  }
+  usPerRow_ = average(usPerRow_, static_cast<double>(latencyUs) / rows);
+  bytesPerRow_ = average(bytesPerRow_, static_cast<double>(bytes) / rows);
+
+  double target = static_cast<double>(maxLimit_);
+  if (targetLatencyUs_ > 0 && usPerRow_ > 0) {
+    target = std::min(target, targetLatencyUs_ / usPerRow_);
+  }
+  if (targetBytes_ > 0 && bytesPerRow_ > 0) {
+    target = std::min(target, targetBytes_ / bytesPerRow_);
+  }
+  // A short page ends the part or is thinned by the filter, it tells nothing
+  // about larger pages
+  double upper = rows < limit_ ? limit_ : limit_ * 2.0;
+  target = std::min(target, upper);
+  // Compare before the cast, a double as large as maxLimit_ may overflow it
+  limit_ = target >= static_cast<double>(maxLimit_)
+               ? maxLimit_
+               : std::clamp(static_cast<int64_t>(target), minLimit_, maxLimit_);
+  return limit_;
+}
+
+}  // namespace nebula
@@ -0,0 +1,84 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/ScanSink.h"
+
+#include <algorithm>
+
+namespace nebula {
+
+ScanSink::ScanSink(ScanCallback consumer, std::size_t consumerThreads, std::size_t maxInflight)
+    : consumer_(std::move(consumer)), maxInflight_(std::max<std::size_t>(maxInflight, 1)) {
+  consumerThreads = std::max<std::size_t>(consumerThreads, 1);
+  threads_.reserve(consumerThreads);
+  for (std::size_t i = 0; i < consumerThreads; ++i) {
+    threads_.emplace_back([this] { consume(); });
+  }
+}
+
+ScanSink::~ScanSink() {
+  finish();
+}
+
+ScanCallback ScanSink::callback() {
+  return [this](PartitionID partId, DataSet&& page) { return push(partId, std::move(page)); };
+}
+
+bool ScanSink::push(PartitionID partId, DataSet&& page) {
+  std::unique_lock<std::mutex> guard(lock_);
+  notFull_.wait(guard, [this] { return stopped_ || inflight_ < maxInflight_; });
+  if (stopped_) {
+    return false;
+  }
+  ++inflight_;
+  pages_.emplace_back(partId, std::move(page));
+  guard.unlock();
+  notEmpty_.notify_one();
+  return true;
+}
+
+void ScanSink::consume() {
+  while (true) {
+    std::pair<PartitionID, DataSet> page;
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      notEmpty_.wait(guard, [this] { return closed_ || !pages_.empty(); });
+      if (pages_.empty()) {
+        return;
+      }
+      page = std::move(pages_.front());
+      pages_.pop_front();
+    }
+    bool goOn = consumer_(page.first, std::move(page.second));
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      --inflight_;
+      if (!goOn) {
+        // The queued pages are dropped
+        stopped_ = true;
+        inflight_ -= pages_.size();
+        pages_.clear();
+      }
+    }
+    notFull_.notify_all();
+  }
+}
+
+bool ScanSink::finish() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    closed_ = true;
+  }
+  notEmpty_.notify_all();
+  for (auto& t : threads_) {
+    if (t.joinable()) {
+      t.join();
+    }
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  return !stopped_;
+}
+
+}  // namespace nebula
@@ -6,22 +6,301 @@
 #include "nebula/sclient/StorageClient.h"
 
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/String.h>
+#include <folly/futures/Future.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 #include "../thrift/ThriftClientManager.h"
+#include "RpcEventHandler.h"
 #include "interface/gen-cpp2/GraphStorageServiceAsyncClient.h"
 #include "interface/gen-cpp2/storage_types.h"
 
 namespace nebula {
 
+namespace {
+
+// Split the parts of a request into those of requests of at most maxRows
+// rows, or of one request if maxRows is 0
+template <typename Parts>
+std::vector<Parts> splitParts(Parts parts, std::size_t maxRows) {
+  std::vector<Parts> requests;
+  if (maxRows == 0) {
+    requests.emplace_back(std::move(parts));
+    return requests;
+  }
+  std::size_t rows = maxRows;
+  for (auto& part : parts) {
+    auto& rowsOfPart = part.second;
+    std::size_t begin = 0;
+    while (begin < rowsOfPart.size()) {
+      if (rows == maxRows) {
+        requests.emplace_back();
+        rows = 0;
+      }
+      auto n = std::min(maxRows - rows, rowsOfPart.size() - begin);
+      auto& dst = requests.back()[part.first];
+      dst.insert(dst.end(),
+                 std::make_move_iterator(rowsOfPart.begin() + begin),
+                 std::make_move_iterator(rowsOfPart.begin() + begin + n));
+      begin += n;
+      rows += n;
+    }
+  }
+  return requests;
+}
+
+const std::string& keyOf(const std::string& key) {
+  return key;
+}
+
+const std::string& keyOf(const KeyValue& kv) {
+  return kv.key;
+}
+
+// The names of the RPCs of the requests in the stats
+const char* rpcName(const storage::cpp2::GetNeighborsRequest&) {
+  return "getNeighbors";
+}
+
+const char* rpcName(const storage::cpp2::GetPropRequest&) {
+  return "getProps";
+}
+
+const char* rpcName(const storage::cpp2::ScanEdgeRequest&) {
+  return "scanEdge";
+}
+
+const char* rpcName(const storage::cpp2::ScanVertexRequest&) {
+  return "scanVertex";
+}
+
+const char* rpcName(const storage::cpp2::LookupIndexRequest&) {
+  return "lookupIndex";
+}
+
+const char* rpcName(const storage::cpp2::KVGetRequest&) {
+  return "get";
+}
+
+const char* rpcName(const storage::cpp2::KVPutRequest&) {
+  return "put";
+}
+
+const char* rpcName(const storage::cpp2::KVRemoveRequest&) {
+  return "remove";
+}
+
+const char* rpcName(const storage::cpp2::AddEdgesRequest&) {
+  return "addEdges";
+}
+
+const char* rpcName(const storage::cpp2::AddVerticesRequest&) {
+  return "addVertices";
+}
+
+// Whether from, a request waiting to be sent to a host, can be merged into
+// into, an earlier one waiting there, so the response of into answers both.
+// Writes and scans are never merged.
+template <typename Request>
+bool mergeable(Request*, Request*, std::size_t) {
+  return false;
+}
+
+bool mergeable(storage::cpp2::GetNeighborsRequest* into,
+               storage::cpp2::GetNeighborsRequest* from,
+               std::size_t) {
+  return *into == *from;
+}
+
+bool mergeable(storage::cpp2::LookupIndexRequest* into,
+               storage::cpp2::LookupIndexRequest* from,
+               std::size_t) {
+  return *into == *from;
+}
+
+// The requests are the same but for their parts, and have at most maxRows
+// rows together
+template <typename Request>
+bool sameButParts(Request* into, Request* from, std::size_t maxRows) {
+  auto& intoParts = into->parts_ref().value();
+  auto& fromParts = from->parts_ref().value();
+  std::size_t rows = 0;
+  for (const auto& part : intoParts) {
+    rows += part.second.size();
+  }
+  for (const auto& part : fromParts) {
+    rows += part.second.size();
+  }
+  if (rows > maxRows) {
+    return false;
+  }
+  std::decay_t<decltype(intoParts)> savedInto, savedFrom;
+  savedInto.swap(intoParts);
+  savedFrom.swap(fromParts);
+  bool same = *into == *from;
+  savedInto.swap(intoParts);
+  savedFrom.swap(fromParts);
+  return same;
+}
+
+bool mergeable(storage::cpp2::GetPropRequest* into,
+               storage::cpp2::GetPropRequest* from,
+               std::size_t maxRows) {
+  // The dedup, the order and the limit apply to the rows of all parts
+  if (into->get_dedup() || into->order_by_ref().has_value() || into->limit_ref().has_value()) {
+    return false;
+  }
+  return sameButParts(into, from, maxRows);
+}
+
+bool mergeable(storage::cpp2::KVGetRequest* into,
+               storage::cpp2::KVGetRequest* from,
+               std::size_t maxRows) {
+  auto partly = into->get_return_partly();
+  into->set_return_partly(from->get_return_partly());
+  bool same = sameButParts(into, from, maxRows);
+  into->set_return_partly(partly);
+  return same;
+}
+
+// Merge from into into, which mergeable() allowed
+template <typename Request>
+void mergeInto(Request*, const Request&) {}
+
+template <typename Request>
+void mergeParts(Request* into, const Request& from) {
+  auto& parts = into->parts_ref().value();
+  for (const auto& part : from.get_parts()) {
+    auto& rows = parts[part.first];
+    rows.insert(rows.end(), part.second.begin(), part.second.end());
+  }
+}
+
+void mergeInto(storage::cpp2::GetPropRequest* into, const storage::cpp2::GetPropRequest& from) {
+  mergeParts(into, from);
+}
+
+void mergeInto(storage::cpp2::KVGetRequest* into, const storage::cpp2::KVGetRequest& from) {
+  // The callers without return_partly fail the parts missing their keys by
+  // themselves, see responseOf()
+  into->set_return_partly(true);
+  mergeParts(into, from);
+}
+
+// The response to own, which was merged into the request of merged
+template <typename Request, typename Response>
+Response responseOf(const Request&, const Response& merged) {
+  return merged;
+}
+
+// The failed parts of merged which are parts of own
+template <typename Parts>
+storage::cpp2::ResponseCommon commonOf(const Parts& own,
+                                       const storage::cpp2::ResponseCommon& merged) {
+  auto common = merged;
+  std::vector<storage::cpp2::PartitionResult> failedParts;
+  for (const auto& failedPart : merged.get_failed_parts()) {
+    if (own.count(failedPart.get_part_id()) != 0) {
+      failedParts.emplace_back(failedPart);
+    }
+  }
+  common.set_failed_parts(std::move(failedParts));
+  return common;
+}
+
+storage::cpp2::GetPropResponse responseOf(const storage::cpp2::GetPropRequest& own,
+                                          const storage::cpp2::GetPropResponse& merged) {
+  // The rows of the other parts are left, getProps() takes those it asked
+  // for by their keys
+  auto resp = merged;
+  resp.set_result(commonOf(own.get_parts(), merged.get_result()));
+  return resp;
+}
+
+storage::cpp2::KVGetResponse responseOf(const storage::cpp2::KVGetRequest& own,
+                                        const storage::cpp2::KVGetResponse& merged) {
+  storage::cpp2::KVGetResponse resp;
+  auto common = commonOf(own.get_parts(), merged.get_result());
+  std::unordered_set<PartitionID> failed;
+  for (const auto& failedPart : common.get_failed_parts()) {
+    failed.emplace(failedPart.get_part_id());
+  }
+  const auto& all = merged.get_key_values();
+  auto& keyValues = resp.key_values_ref().value();
+  auto failedParts = common.get_failed_parts();
+  for (const auto& part : own.get_parts()) {
+    bool missing = false;
+    for (const auto& key : part.second) {
+      auto found = all.find(key);
+      if (found == all.end()) {
+        missing = true;
+      } else {
+        keyValues.emplace(*found);
+      }
+    }
+    if (missing && !own.get_return_partly() && failed.count(part.first) == 0) {
+      storage::cpp2::PartitionResult result;
+      result.set_code(nebula::cpp2::ErrorCode::E_PARTIAL_RESULT);
+      result.set_part_id(part.first);
+      failedParts.emplace_back(std::move(result));
+    }
+  }
+  common.set_failed_parts(std::move(failedParts));
+  resp.set_result(std::move(common));
+  return resp;
+}
+
+// Fetch the whole result of a request as one page, for scanParts
+struct OnePageIter {
+  explicit OnePageIter(std::function<std::pair<bool, DataSet>()> fetch)
+      : fetch_(std::move(fetch)) {}
+
+  bool hasNext() const {
+    return !fetched_;
+  }
+
+  DataSet next() {
+    fetched_ = true;
+    auto page = fetch_();
+    failed_ = !page.first;
+    return std::move(page.second);
+  }
+
+  std::function<std::pair<bool, DataSet>()> fetch_;
+  bool fetched_{false};
+  bool failed_{false};
+};
+
+}  // namespace
+
 StorageClient::StorageClient(const std::vector<std::string>& metaAddrs,
                              const MConfig& mConfig,
-                             const SConfig& sConfig) {
-  mClient_ = std::make_unique<MetaClient>(metaAddrs, mConfig);
+                             const SConfig& sConfig)
+    : limiter_(sConfig) {
   sConfig_ = sConfig;
-  ioExecutor_ = std::make_shared<folly::IOThreadPoolExecutor>(std::thread::hardware_concurrency());
+  runtime_ = sConfig_.runtime_ != nullptr ? sConfig_.runtime_ : std::make_shared<ClientRuntime>();
+  if (mConfig.runtime_ == nullptr && sConfig_.runtime_ != nullptr) {
+    auto shared = mConfig;
+    shared.runtime_ = runtime_;
+    mClient_ = std::make_unique<MetaClient>(metaAddrs, shared);
+  } else {
+    mClient_ = std::make_unique<MetaClient>(metaAddrs, mConfig);
+  }
+  ioExecutor_ = runtime_->ioExecutor();
   clientsMan_ =
       std::make_shared<thrift::ThriftClientManager<storage::cpp2::GraphStorageServiceAsyncClient>>(
-          sConfig.connTimeoutInMs_, sConfig.enableSSL_, sConfig.CAPath_);
+          sConfig.connTimeoutInMs_,
+          sConfig.enableSSL_,
+          sConfig.CAPath_,
+          std::make_shared<RpcEventHandler>());
 }
 
 StorageClient::~StorageClient() = default;
@@ -51,14 +330,844 @@ ScanEdgeIter StorageClient::scanEdgeWithPart(std::string spaceName,
                                              std::string filter,
                                              bool onlyLatestVersion,
                                              bool enableReadFromFollower) {
+  auto* req = makeScanEdgeRequest(spaceName,
+                                  edgeName,
+                                  propNames,
+                                  limit,
+                                  startTime,
+                                  endTime,
+                                  filter,
+                                  onlyLatestVersion,
+                                  enableReadFromFollower);
+  if (req == nullptr) {
+    return {nullptr, nullptr, false};
+  }
+  // old interface
+  // req->set_part_id(partId);
+  // req->set_cursor("");
+  // new interface
+  storage::cpp2::ScanCursor scanCursor;
+  req->set_parts(std::unordered_map<PartitionID, storage::cpp2::ScanCursor>{{partId, scanCursor}});
+
+  return {this, req};
+}
+
+StorageResult<DataSet> StorageClient::getNeighbors(const std::string& spaceName,
+                                                   const std::vector<Value>& vids,
+                                                   const EdgeProps& edges,
+                                                   EdgeDirection direction,
+                                                   const TagProps& vertexProps,
+                                                   const std::string& filter,
+                                                   int64_t limit,
+                                                   bool dedup) {
+  StorageResult<DataSet> result;
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto spaceId = spaceIdResult.second;
+
+  storage::cpp2::TraverseSpec spec;
+  std::vector<EdgeType> edgeTypes;
+  std::vector<storage::cpp2::EdgeProp> edgeProps;
+  for (const auto& edge : edges) {
+    auto edgeTypeResult = mClient_->getEdgeTypeByNameFromCache(spaceId, edge.first);
+    if (!edgeTypeResult.first) {
+      result.ok_ = false;
+      return result;
+    }
+    // The in-edges are of the negative type
+    for (auto edgeType : {edgeTypeResult.second, -edgeTypeResult.second}) {
+      if ((edgeType > 0 && direction == EdgeDirection::kIn) ||
+          (edgeType < 0 && direction == EdgeDirection::kOut)) {
+        continue;
+      }
+      edgeTypes.emplace_back(edgeType);
+      storage::cpp2::EdgeProp edgeProp;
+      edgeProp.set_type(edgeType);
+      edgeProp.set_props(edge.second);
+      edgeProps.emplace_back(std::move(edgeProp));
+    }
+  }
+  std::vector<storage::cpp2::VertexProp> tagProps;
+  for (const auto& tagProp : vertexProps) {
+    auto tagIdResult = mClient_->getTagIdByNameFromCache(spaceId, tagProp.first);
+    if (!tagIdResult.first) {
+      result.ok_ = false;
+      return result;
+    }
+    storage::cpp2::VertexProp vertexProp;
+    vertexProp.set_tag(tagIdResult.second);
+    vertexProp.set_props(tagProp.second);
+    tagProps.emplace_back(std::move(vertexProp));
+  }
+  spec.set_edge_types(std::move(edgeTypes));
+  spec.set_edge_direction(direction == EdgeDirection::kOut  ? storage::cpp2::EdgeDirection::OUT_EDGE
+                          : direction == EdgeDirection::kIn ? storage::cpp2::EdgeDirection::IN_EDGE
+                                                            : storage::cpp2::EdgeDirection::BOTH);
+  spec.set_dedup(dedup);
+  spec.set_edge_props(std::move(edgeProps));
+  if (!tagProps.empty()) {
+    spec.set_vertex_props(std::move(tagProps));
+  }
+  if (!filter.empty()) {
+    spec.set_filter(filter);
+  }
+  if (limit != DEFAULT_LIMIT) {
+    spec.set_limit(limit);
+  }
+
+  std::vector<Row> rows;
+  rows.reserve(vids.size());
+  for (const auto& vid : vids) {
+    rows.emplace_back(List({vid}));
+  }
+  std::unordered_map<PartitionID, std::vector<Row>> parts;
+  if (!groupByPart(spaceId, std::move(rows), &parts)) {
+    result.ok_ = false;
+    return result;
+  }
+  storage::cpp2::GetNeighborsRequest req;
+  req.set_space_id(spaceId);
+  req.set_column_names({"_vid"});
+  req.set_parts(std::move(parts));
+  req.set_traverse_spec(std::move(spec));
+
+  auto responses = fanOut(std::move(req),
+                          [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                             const storage::cpp2::GetNeighborsRequest& r) {
+                            return client->future_getNeighbors(r);
+                          },
+                          &result);
+  for (auto& resp : responses) {
+    if (resp.vertices_ref().has_value() &&
+        !result.data_.append(std::move(resp.vertices_ref().value()))) {
+      LOG(ERROR) << "The columns of the neighbors from the hosts of space " << spaceId
+                 << " don't match";
+      result.ok_ = false;
+    }
+  }
+  return result;
+}
+
+bool StorageClient::groupByPart(GraphSpaceID spaceId,
+                                std::vector<Row> rows,
+                                std::unordered_map<PartitionID, std::vector<Row>>* parts) {
+  auto router = PartitionRouter::make(mClient_.get(), spaceId);
+  if (!router.first) {
+    return false;
+  }
+  std::vector<Value> vids;
+  vids.reserve(rows.size());
+  for (const auto& row : rows) {
+    vids.emplace_back(row.values[0]);
+  }
+  std::vector<PartitionID> partIds(vids.size());
+  if (!router.second.partsFor(folly::range(vids), partIds.data())) {
+    LOG(ERROR) << "Invalid vids, they must be of the vid type of space " << spaceId;
+    return false;
+  }
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    (*parts)[partIds[i]].emplace_back(std::move(rows[i]));
+  }
+  return true;
+}
+
+StorageResult<DataSet> StorageClient::getVertexProps(const std::string& spaceName,
+                                                     const std::vector<Value>& vids,
+                                                     const TagProps& tagProps,
+                                                     const std::string& filter) {
+  StorageResult<DataSet> result;
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto spaceId = spaceIdResult.second;
+
+  std::vector<storage::cpp2::VertexProp> vertexProps;
+  vertexProps.reserve(tagProps.size());
+  for (const auto& tagProp : tagProps) {
+    auto tagIdResult = mClient_->getTagIdByNameFromCache(spaceId, tagProp.first);
+    if (!tagIdResult.first) {
+      result.ok_ = false;
+      return result;
+    }
+    storage::cpp2::VertexProp vertexProp;
+    vertexProp.set_tag(tagIdResult.second);
+    vertexProp.set_props(tagProp.second);
+    vertexProps.emplace_back(std::move(vertexProp));
+  }
+
+  storage::cpp2::GetPropRequest req;
+  req.set_space_id(spaceId);
+  req.set_vertex_props(std::move(vertexProps));
+  if (!filter.empty()) {
+    req.set_filter(filter);
+  }
+  std::vector<Row> rows;
+  rows.reserve(vids.size());
+  for (const auto& vid : vids) {
+    rows.emplace_back(List({vid}));
+  }
+  // The rows of the responses start with _vid
+  return getProps(std::move(req), std::move(rows), [](const Row& row) { return row.values[0]; });
+}
+
+StorageResult<DataSet> StorageClient::getEdgeProps(const std::string& spaceName,
+                                                   const std::string& edgeName,
+                                                   const std::vector<EdgeKey>& keys,
+                                                   const std::vector<std::string>& props,
+                                                   const std::string& filter) {
+  StorageResult<DataSet> result;
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto spaceId = spaceIdResult.second;
+  auto edgeTypeResult = mClient_->getEdgeTypeByNameFromCache(spaceId, edgeName);
+  if (!edgeTypeResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto edgeType = edgeTypeResult.second;
+
+  // The keys are asked for to match the rows to the keys, so the properties
+  // are never empty and all properties are taken from the schema
+  std::vector<std::string> names{"_src", "_type", "_rank", "_dst"};
+  if (props.empty()) {
+    auto schemas = mClient_->getEdgeSchemasFromCache(spaceId);
+    if (!schemas.first) {
+      result.ok_ = false;
+      return result;
+    }
+    for (const auto& schema : schemas.second) {
+      if (schema.id_ == edgeType) {
+        names.insert(names.end(), schema.props_.begin(), schema.props_.end());
+      }
+    }
+  } else {
+    names.insert(names.end(), props.begin(), props.end());
+  }
+  storage::cpp2::EdgeProp edgeProp;
+  edgeProp.set_type(edgeType);
+  edgeProp.set_props(std::move(names));
+
+  storage::cpp2::GetPropRequest req;
+  req.set_space_id(spaceId);
+  req.set_edge_props({std::move(edgeProp)});
+  if (!filter.empty()) {
+    req.set_filter(filter);
+  }
+  std::vector<Row> rows;
+  rows.reserve(keys.size());
+  for (const auto& key : keys) {
+    rows.emplace_back(List({key.src_, edgeType, key.rank_, key.dst_}));
+  }
+  // Both the rows of the request and of the responses start with _src,
+  // _type, _rank and _dst
+  return getProps(std::move(req), std::move(rows), [](const Row& row) {
+    return Value(List({row.values[0], row.values[2], row.values[3]}));
+  });
+}
+
+template <typename KeyOf>
+StorageResult<DataSet> StorageClient::getProps(storage::cpp2::GetPropRequest req,
+                                               std::vector<Row> rows,
+                                               KeyOf&& keyOf) {
+  StorageResult<DataSet> result;
+  std::unordered_map<Value, std::size_t> index;
+  std::vector<std::size_t> slots;
+  std::vector<Row> unique;
+  slots.reserve(rows.size());
+  for (auto& row : rows) {
+    auto inserted = index.emplace(keyOf(row), unique.size());
+    if (inserted.second) {
+      unique.emplace_back(std::move(row));
+    }
+    slots.emplace_back(inserted.first->second);
+  }
+
+  std::unordered_map<PartitionID, std::vector<Row>> parts;
+  if (!groupByPart(req.get_space_id(), std::move(unique), &parts)) {
+    result.ok_ = false;
+    return result;
+  }
+  req.set_parts(std::move(parts));
+  auto responses = fanOut(std::move(req),
+                          [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                             const storage::cpp2::GetPropRequest& r) {
+                            return client->future_getProps(r);
+                          },
+                          &result);
+
+  std::vector<Row> found(index.size());
+  for (auto& resp : responses) {
+    if (!resp.props_ref().has_value()) {
+      continue;
+    }
+    auto& ds = resp.props_ref().value();
+    if (result.data_.colNames.empty()) {
+      result.data_.colNames = std::move(ds.colNames);
+    }
+    for (auto& row : ds.rows) {
+      auto it = index.find(keyOf(row));
+      if (it != index.end()) {
+        found[it->second] = std::move(row);
+      }
+    }
+  }
+
+  // A found row is moved to the last of its slots and copied to the others
+  std::vector<std::size_t> uses(found.size(), 0);
+  for (auto slot : slots) {
+    ++uses[slot];
+  }
+  auto width = result.data_.colNames.size();
+  result.data_.rows.reserve(slots.size());
+  for (auto slot : slots) {
+    if (found[slot].values.empty()) {
+      result.data_.rows.emplace_back(std::vector<Value>(width));
+    } else if (--uses[slot] == 0) {
+      result.data_.rows.emplace_back(std::move(found[slot]));
+    } else {
+      result.data_.rows.emplace_back(found[slot]);
+    }
+  }
+  return result;
+}
+
+StorageResult<std::unordered_map<std::string, std::string>> StorageClient::kvGet(
+    const std::string& spaceName, const std::vector<std::string>& keys, bool returnPartly) {
+  StorageResult<std::unordered_map<std::string, std::string>> result;
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto spaceId = spaceIdResult.second;
+  std::unordered_map<PartitionID, std::vector<std::string>> parts;
+  if (!groupKeysByPart(spaceId, keys, &parts)) {
+    result.ok_ = false;
+    return result;
+  }
+
+  storage::cpp2::KVGetRequest req;
+  req.set_space_id(spaceId);
+  req.set_parts(std::move(parts));
+  req.set_return_partly(returnPartly);
+  auto responses = fanOut(std::move(req),
+                          [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                             const storage::cpp2::KVGetRequest& r) {
+                            return client->future_get(r);
+                          },
+                          &result,
+                          sConfig_.kvBatchSize_);
+  for (auto& resp : responses) {
+    auto& keyValues = resp.key_values_ref().value();
+    if (result.data_.empty()) {
+      result.data_ = std::move(keyValues);
+    } else {
+      result.data_.insert(std::make_move_iterator(keyValues.begin()),
+                          std::make_move_iterator(keyValues.end()));
+    }
+  }
+  return result;
+}
+
+StorageResult<int64_t> StorageClient::kvPut(const std::string& spaceName,
+                                            std::vector<KeyValue> kvs) {
+  StorageResult<int64_t> result;
+  result.data_ = 0;
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto spaceId = spaceIdResult.second;
+  std::unordered_map<PartitionID, std::vector<KeyValue>> parts;
+  if (!groupKeysByPart(spaceId, std::move(kvs), &parts)) {
+    result.ok_ = false;
+    return result;
+  }
+
+  // The rows are moved to the requests, count them before
+  std::unordered_map<PartitionID, std::size_t> rowsOfParts;
+  for (const auto& part : parts) {
+    rowsOfParts.emplace(part.first, part.second.size());
+  }
+  storage::cpp2::KVPutRequest req;
+  req.set_space_id(spaceId);
+  req.set_parts(std::move(parts));
+  fanOut(std::move(req),
+         [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+            const storage::cpp2::KVPutRequest& r) { return client->future_put(r); },
+         &result,
+         sConfig_.kvBatchSize_);
+  result.data_ = succeededRows(rowsOfParts, result.failedParts_);
+  return result;
+}
+
+StorageResult<int64_t> StorageClient::kvRemove(const std::string& spaceName,
+                                               const std::vector<std::string>& keys) {
+  StorageResult<int64_t> result;
+  result.data_ = 0;
   auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
   if (!spaceIdResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto spaceId = spaceIdResult.second;
+  std::unordered_map<PartitionID, std::vector<std::string>> parts;
+  if (!groupKeysByPart(spaceId, keys, &parts)) {
+    result.ok_ = false;
+    return result;
+  }
+
+  std::unordered_map<PartitionID, std::size_t> rowsOfParts;
+  for (const auto& part : parts) {
+    rowsOfParts.emplace(part.first, part.second.size());
+  }
+  storage::cpp2::KVRemoveRequest req;
+  req.set_space_id(spaceId);
+  req.set_parts(std::move(parts));
+  fanOut(std::move(req),
+         [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+            const storage::cpp2::KVRemoveRequest& r) { return client->future_remove(r); },
+         &result,
+         sConfig_.kvBatchSize_);
+  result.data_ = succeededRows(rowsOfParts, result.failedParts_);
+  return result;
+}
+
+template <typename Item>
+bool StorageClient::groupKeysByPart(GraphSpaceID spaceId,
+                                    std::vector<Item> items,
+                                    std::unordered_map<PartitionID, std::vector<Item>>* parts) {
+  auto router = PartitionRouter::make(mClient_.get(), spaceId);
+  if (!router.first) {
+    return false;
+  }
+  for (auto& item : items) {
+    auto partId = router.second.partForKey(keyOf(item));
+    (*parts)[partId].emplace_back(std::move(item));
+  }
+  return true;
+}
+
+template <typename Parts>
+int64_t StorageClient::succeededRows(const Parts& parts,
+                                     const std::unordered_map<PartitionID, int32_t>& failedParts) {
+  int64_t rows = 0;
+  for (const auto& part : parts) {
+    if (failedParts.find(part.first) == failedParts.end()) {
+      rows += part.second;
+    }
+  }
+  return rows;
+}
+
+bool StorageClient::scanEdge(std::string spaceName,
+                             std::string edgeName,
+                             std::vector<std::string> propNames,
+                             ScanCallback cb,
+                             int64_t limit,
+                             int64_t startTime,
+                             int64_t endTime,
+                             std::string filter,
+                             bool onlyLatestVersion,
+                             bool enableReadFromFollower) {
+  std::unique_ptr<storage::cpp2::ScanEdgeRequest> req(makeScanEdgeRequest(spaceName,
+                                                                          edgeName,
+                                                                          propNames,
+                                                                          limit,
+                                                                          startTime,
+                                                                          endTime,
+                                                                          filter,
+                                                                          onlyLatestVersion,
+                                                                          enableReadFromFollower));
+  if (req == nullptr) {
+    LOG(ERROR) << "Space " << spaceName << " or edge " << edgeName << " not found";
+    return false;
+  }
+  auto spaceId = req->get_space_id();
+  auto parts = mClient_->getPartsFromCache(spaceId);
+  if (!parts.first) {
+    LOG(ERROR) << "Get parts from cache for space id " << spaceId << " failed";
+    return false;
+  }
+  return scanParts(
+      spaceId,
+      parts.second,
+      [this, &req](const std::vector<PartitionID>& partIds) {
+        auto* partReq = new storage::cpp2::ScanEdgeRequest(*req);
+        std::unordered_map<PartitionID, storage::cpp2::ScanCursor> partCursors;
+        for (auto partId : partIds) {
+          partCursors.emplace(partId, storage::cpp2::ScanCursor());
+        }
+        partReq->set_parts(std::move(partCursors));
+        return std::make_unique<ScanEdgeIter>(this, partReq);
+      },
+      cb,
+      [](const ScanEdgeIter&, const std::vector<PartitionID>&, std::size_t) {});
+}
+
+std::unique_ptr<ParallelScanIter> StorageClient::scanEdge(std::string spaceName,
+                                                          std::string edgeName,
+                                                          std::vector<std::string> propNames,
+                                                          int64_t limit,
+                                                          int64_t startTime,
+                                                          int64_t endTime,
+                                                          std::string filter,
+                                                          bool onlyLatestVersion,
+                                                          bool enableReadFromFollower) {
+  return std::make_unique<ParallelScanIter>(
+      [this,
+       spaceName = std::move(spaceName),
+       edgeName = std::move(edgeName),
+       propNames = std::move(propNames),
+       limit,
+       startTime,
+       endTime,
+       filter = std::move(filter),
+       onlyLatestVersion,
+       enableReadFromFollower](const ScanCallback& cb) {
+        return scanEdge(spaceName,
+                        edgeName,
+                        propNames,
+                        cb,
+                        limit,
+                        startTime,
+                        endTime,
+                        filter,
+                        onlyLatestVersion,
+                        enableReadFromFollower);
+      },
+      2 * std::max(sConfig_.scanConcurrency_, 1));
+}
+
+ScanVertexIter StorageClient::scanVertexWithPart(std::string spaceName,
+                                                 PartitionID partId,
+                                                 TagProps tagProps,
+                                                 int64_t limit,
+                                                 int64_t startTime,
+                                                 int64_t endTime,
+                                                 std::string filter,
+                                                 bool onlyLatestVersion,
+                                                 bool enableReadFromFollower) {
+  auto* req = makeScanVertexRequest(spaceName,
+                                    tagProps,
+                                    limit,
+                                    startTime,
+                                    endTime,
+                                    filter,
+                                    onlyLatestVersion,
+                                    enableReadFromFollower);
+  if (req == nullptr) {
     return {nullptr, nullptr, false};
   }
+  storage::cpp2::ScanCursor scanCursor;
+  req->set_parts(std::unordered_map<PartitionID, storage::cpp2::ScanCursor>{{partId, scanCursor}});
+
+  return {this, req};
+}
+
+bool StorageClient::scanVertex(std::string spaceName,
+                               TagProps tagProps,
+                               ScanCallback cb,
+                               int64_t limit,
+                               int64_t startTime,
+                               int64_t endTime,
+                               std::string filter,
+                               bool onlyLatestVersion,
+                               bool enableReadFromFollower) {
+  std::unique_ptr<storage::cpp2::ScanVertexRequest> req(
+      makeScanVertexRequest(spaceName,
+                            tagProps,
+                            limit,
+                            startTime,
+                            endTime,
+                            filter,
+                            onlyLatestVersion,
+                            enableReadFromFollower));
+  if (req == nullptr) {
+    LOG(ERROR) << "Space " << spaceName << " or its tags not found";
+    return false;
+  }
+  auto spaceId = req->get_space_id();
+  auto parts = mClient_->getPartsFromCache(spaceId);
+  if (!parts.first) {
+    LOG(ERROR) << "Get parts from cache for space id " << spaceId << " failed";
+    return false;
+  }
+  return scanParts(
+      spaceId,
+      parts.second,
+      [this, &req](const std::vector<PartitionID>& partIds) {
+        auto* partReq = new storage::cpp2::ScanVertexRequest(*req);
+        std::unordered_map<PartitionID, storage::cpp2::ScanCursor> partCursors;
+        for (auto partId : partIds) {
+          partCursors.emplace(partId, storage::cpp2::ScanCursor());
+        }
+        partReq->set_parts(std::move(partCursors));
+        return std::make_unique<ScanVertexIter>(this, partReq);
+      },
+      cb,
+      [](const ScanVertexIter&, const std::vector<PartitionID>&, std::size_t) {});
+}
+
+std::unique_ptr<ParallelScanIter> StorageClient::scanVertex(std::string spaceName,
+                                                            TagProps tagProps,
+                                                            int64_t limit,
+                                                            int64_t startTime,
+                                                            int64_t endTime,
+                                                            std::string filter,
+                                                            bool onlyLatestVersion,
+                                                            bool enableReadFromFollower) {
+  return std::make_unique<ParallelScanIter>(
+      [this,
+       spaceName = std::move(spaceName),
+       tagProps = std::move(tagProps),
+       limit,
+       startTime,
+       endTime,
+       filter = std::move(filter),
+       onlyLatestVersion,
+       enableReadFromFollower](const ScanCallback& cb) {
+        return scanVertex(spaceName,
+                          tagProps,
+                          cb,
+                          limit,
+                          startTime,
+                          endTime,
+                          filter,
+                          onlyLatestVersion,
+                          enableReadFromFollower);
+      },
+      2 * std::max(sConfig_.scanConcurrency_, 1));
+}
+
+bool StorageClient::scanWithCheckpoint(ScanCheckpoint* checkpoint,
+                                       const std::string& path,
+                                       ScanCallback cb) {
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(checkpoint->spaceName_);
+  if (!spaceIdResult.first) {
+    LOG(ERROR) << "Space " << checkpoint->spaceName_ << " not found";
+    return false;
+  }
+  auto spaceId = spaceIdResult.second;
+  auto partsResult = mClient_->getPartsFromCache(spaceId);
+  if (!partsResult.first) {
+    LOG(ERROR) << "Get parts from cache for space id " << spaceId << " failed";
+    return false;
+  }
+  std::vector<PartitionID> parts;
+  for (auto partId : partsResult.second) {
+    if (!checkpoint->finished_.count(partId)) {
+      parts.emplace_back(partId);
+    }
+  }
+
+  // The progress of each page is recorded after it's passed to cb
+  std::mutex lock;
+  auto lastSaved = std::chrono::steady_clock::now();
+  std::chrono::milliseconds interval(sConfig_.scanCheckpointIntervalMs_);
+  auto progress = [&](const auto& iter, const std::vector<PartitionID>& partIds, std::size_t rows) {
+    const auto& partCursors = iter.req_->get_parts();
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto partId : partIds) {
+      auto part = partCursors.find(partId);
+      if (part != partCursors.end()) {
+        auto nextCursor = part->second.next_cursor_ref();
+        checkpoint->cursors_[partId] = nextCursor.has_value() ? nextCursor.value() : "";
+        continue;
+      }
+      auto failed = iter.failedParts_.find(partId);
+      if (failed != iter.failedParts_.end()) {
+        checkpoint->cursors_[partId] = failed->second;
+        continue;
+      }
+      checkpoint->cursors_.erase(partId);
+      checkpoint->finished_.emplace(partId);
+    }
+    checkpoint->rows_ += rows;
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastSaved >= interval) {
+      checkpoint->save(path);
+      lastSaved = now;
+    }
+  };
+
+  // Each part goes on from its cursor, the pages aren't prefetched since the
+  // cursors have to follow the pages passed to cb
+  auto withCursors = [checkpoint](auto* req, const std::vector<PartitionID>& partIds) {
+    std::unordered_map<PartitionID, storage::cpp2::ScanCursor> partCursors;
+    for (auto partId : partIds) {
+      storage::cpp2::ScanCursor scanCursor;
+      auto cursor = checkpoint->cursors_.find(partId);
+      if (cursor != checkpoint->cursors_.end() && !cursor->second.empty()) {
+        scanCursor.set_next_cursor(cursor->second);
+      }
+      partCursors.emplace(partId, std::move(scanCursor));
+    }
+    req->set_parts(std::move(partCursors));
+  };
+
+  bool ok = false;
+  if (!checkpoint->edgeName_.empty()) {
+    std::unique_ptr<storage::cpp2::ScanEdgeRequest> req(
+        makeScanEdgeRequest(checkpoint->spaceName_,
+                            checkpoint->edgeName_,
+                            checkpoint->propNames_,
+                            checkpoint->limit_,
+                            checkpoint->startTime_,
+                            checkpoint->endTime_,
+                            checkpoint->filter_,
+                            checkpoint->onlyLatestVersion_,
+                            checkpoint->enableReadFromFollower_));
+    if (req == nullptr) {
+      LOG(ERROR) << "Edge " << checkpoint->edgeName_ << " not found";
+      return false;
+    }
+    ok = scanParts(
+        spaceId,
+        parts,
+        [this, &req, &lock, &withCursors](const std::vector<PartitionID>& partIds) {
+          auto* partReq = new storage::cpp2::ScanEdgeRequest(*req);
+          {
+            std::lock_guard<std::mutex> guard(lock);
+            withCursors(partReq, partIds);
+          }
+          auto iter = std::make_unique<ScanEdgeIter>(this, partReq);
+          iter->prefetchDepth_ = 0;
+          return iter;
+        },
+        cb,
+        progress);
+  } else {
+    std::unique_ptr<storage::cpp2::ScanVertexRequest> req(
+        makeScanVertexRequest(checkpoint->spaceName_,
+                              checkpoint->tagProps_,
+                              checkpoint->limit_,
+                              checkpoint->startTime_,
+                              checkpoint->endTime_,
+                              checkpoint->filter_,
+                              checkpoint->onlyLatestVersion_,
+                              checkpoint->enableReadFromFollower_));
+    if (req == nullptr) {
+      LOG(ERROR) << "Tags of space " << checkpoint->spaceName_ << " not found";
+      return false;
+    }
+    ok = scanParts(
+        spaceId,
+        parts,
+        [this, &req, &lock, &withCursors](const std::vector<PartitionID>& partIds) {
+          auto* partReq = new storage::cpp2::ScanVertexRequest(*req);
+          {
+            std::lock_guard<std::mutex> guard(lock);
+            withCursors(partReq, partIds);
+          }
+          auto iter = std::make_unique<ScanVertexIter>(this, partReq);
+          iter->prefetchDepth_ = 0;
+          return iter;
+        },
+        cb,
+        progress);
+  }
+  if (!checkpoint->save(path)) {
+    return false;
+  }
+  return ok;
+}
+
+bool StorageClient::lookupIndex(std::string spaceName,
+                                std::string indexName,
+                                std::vector<IndexHint> hints,
+                                std::vector<std::string> returnCols,
+                                ScanCallback cb,
+                                int64_t limit,
+                                std::string filter) {
+  std::unique_ptr<storage::cpp2::LookupIndexRequest> req(
+      makeLookupIndexRequest(spaceName, indexName, hints, returnCols, limit, filter));
+  if (req == nullptr) {
+    LOG(ERROR) << "Space " << spaceName << " or index " << indexName << " not found";
+    return false;
+  }
+  auto spaceId = req->get_space_id();
+  auto parts = mClient_->getPartsFromCache(spaceId);
+  if (!parts.first) {
+    LOG(ERROR) << "Get parts from cache for space id " << spaceId << " failed";
+    return false;
+  }
+  // The rows which may still be passed to cb, the parts are not looked up
+  // once it's used up
+  std::atomic<int64_t> remaining{limit};
+  return scanParts(
+      spaceId,
+      parts.second,
+      [this, &req, &remaining](const std::vector<PartitionID>& partIds) {
+        return std::make_unique<OnePageIter>([this, &req, &remaining, partIds]() {
+          if (remaining <= 0) {
+            return std::make_pair(true, DataSet());
+          }
+          return lookupParts(*req, partIds);
+        });
+      },
+      [&cb, &remaining](PartitionID partId, DataSet&& page) {
+        auto rows = static_cast<int64_t>(page.rowSize());
+        auto before = remaining.fetch_sub(rows);
+        if (before <= 0) {
+          return false;
+        }
+        if (rows < before) {
+          return cb(partId, std::move(page));
+        }
+        page.rows.resize(before);
+        cb(partId, std::move(page));
+        return false;
+      },
+      [](const OnePageIter&, const std::vector<PartitionID>&, std::size_t) {});
+}
+
+std::unique_ptr<ParallelScanIter> StorageClient::lookupIndex(std::string spaceName,
+                                                             std::string indexName,
+                                                             std::vector<IndexHint> hints,
+                                                             std::vector<std::string> returnCols,
+                                                             int64_t limit,
+                                                             std::string filter) {
+  return std::make_unique<ParallelScanIter>(
+      [this,
+       spaceName = std::move(spaceName),
+       indexName = std::move(indexName),
+       hints = std::move(hints),
+       returnCols = std::move(returnCols),
+       limit,
+       filter = std::move(filter)](const ScanCallback& cb) {
+        return lookupIndex(spaceName, indexName, hints, returnCols, cb, limit, filter);
+      },
+      2 * std::max(sConfig_.scanConcurrency_, 1));
+}
+
+storage::cpp2::ScanEdgeRequest* StorageClient::makeScanEdgeRequest(
+    const std::string& spaceName,
+    const std::string& edgeName,
+    const std::vector<std::string>& propNames,
+    int64_t limit,
+    int64_t startTime,
+    int64_t endTime,
+    const std::string& filter,
+    bool onlyLatestVersion,
+    bool enableReadFromFollower) {
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    return nullptr;
+  }
   int32_t spaceId = spaceIdResult.second;
   auto edgeTypeResult = mClient_->getEdgeTypeByNameFromCache(spaceId, edgeName);
   if (!edgeTypeResult.first) {
-    return {nullptr, nullptr, false};
+    return nullptr;
   }
   int32_t edgeType = edgeTypeResult.second;
 
@@ -68,12 +1177,6 @@ ScanEdgeIter StorageClient::scanEdgeWithPart(std::string spaceName,
 
   auto* req = new storage::cpp2::ScanEdgeRequest;
   req->set_space_id(spaceId);
-  // old interface
-  // req->set_part_id(partId);
-  // req->set_cursor("");
-  // new interface
-  storage::cpp2::ScanCursor scanCursor;
-  req->set_parts(std::unordered_map<PartitionID, storage::cpp2::ScanCursor>{{partId, scanCursor}});
   req->set_return_columns({returnCols});
   req->set_limit(limit);
   req->set_start_time(startTime);
@@ -81,61 +1184,664 @@ ScanEdgeIter StorageClient::scanEdgeWithPart(std::string spaceName,
   req->set_filter(filter);
   req->set_only_latest_version(onlyLatestVersion);
   req->set_enable_read_from_follower(enableReadFromFollower);
+  return req;
+}
 
-  return {this, req};
+storage::cpp2::ScanVertexRequest* StorageClient::makeScanVertexRequest(
+    const std::string& spaceName,
+    const TagProps& tagProps,
+    int64_t limit,
+    int64_t startTime,
+    int64_t endTime,
+    const std::string& filter,
+    bool onlyLatestVersion,
+    bool enableReadFromFollower) {
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    return nullptr;
+  }
+  int32_t spaceId = spaceIdResult.second;
+
+  std::vector<storage::cpp2::VertexProp> returnCols;
+  returnCols.reserve(tagProps.size());
+  for (const auto& tagProp : tagProps) {
+    auto tagIdResult = mClient_->getTagIdByNameFromCache(spaceId, tagProp.first);
+    if (!tagIdResult.first) {
+      return nullptr;
+    }
+    storage::cpp2::VertexProp vertexProp;
+    vertexProp.set_tag(tagIdResult.second);
+    vertexProp.set_props(tagProp.second);
+    returnCols.emplace_back(std::move(vertexProp));
+  }
+
+  auto* req = new storage::cpp2::ScanVertexRequest;
+  req->set_space_id(spaceId);
+  req->set_return_columns(std::move(returnCols));
+  req->set_limit(limit);
+  req->set_start_time(startTime);
+  req->set_end_time(endTime);
+  req->set_filter(filter);
+  req->set_only_latest_version(onlyLatestVersion);
+  req->set_enable_read_from_follower(enableReadFromFollower);
+  return req;
+}
+
+storage::cpp2::LookupIndexRequest* StorageClient::makeLookupIndexRequest(
+    const std::string& spaceName,
+    const std::string& indexName,
+    const std::vector<IndexHint>& hints,
+    const std::vector<std::string>& returnCols,
+    int64_t limit,
+    const std::string& filter) {
+  auto spaceIdResult = mClient_->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    return nullptr;
+  }
+  int32_t spaceId = spaceIdResult.second;
+  auto indexResult = mClient_->getIndexFromCache(spaceId, indexName);
+  if (!indexResult.first) {
+    return nullptr;
+  }
+  const auto& index = indexResult.second;
+
+  std::vector<storage::cpp2::IndexColumnHint> columnHints;
+  columnHints.reserve(hints.size());
+  for (const auto& hint : hints) {
+    storage::cpp2::IndexColumnHint columnHint;
+    columnHint.set_column_name(hint.column_);
+    columnHint.set_scan_type(hint.prefix_ ? storage::cpp2::ScanType::PREFIX
+                                          : storage::cpp2::ScanType::RANGE);
+    columnHint.set_begin_value(hint.begin_);
+    columnHint.set_end_value(hint.end_);
+    columnHint.set_include_begin(hint.includeBegin_);
+    columnHint.set_include_end(hint.includeEnd_);
+    columnHints.emplace_back(std::move(columnHint));
+  }
+  storage::cpp2::IndexQueryContext context;
+  context.set_index_id(index.id_);
+  context.set_filter(filter);
+  context.set_column_hints(std::move(columnHints));
+
+  nebula::cpp2::SchemaID schemaId;
+  if (index.isEdge_) {
+    schemaId.set_edge_type(index.schemaId_);
+  } else {
+    schemaId.set_tag_id(index.schemaId_);
+  }
+  storage::cpp2::IndexSpec indices;
+  indices.set_contexts({std::move(context)});
+  indices.set_schema_id(std::move(schemaId));
+
+  auto cols = returnCols;
+  if (cols.empty()) {
+    if (index.isEdge_) {
+      cols = {"_src", "_type", "_rank", "_dst"};
+    } else {
+      cols = {"_vid"};
+    }
+  }
+
+  auto* req = new storage::cpp2::LookupIndexRequest;
+  req->set_space_id(spaceId);
+  req->set_indices(std::move(indices));
+  req->set_return_columns(std::move(cols));
+  req->set_limit(limit);
+  return req;
+}
+
+template <typename IterFactory, typename Progress>
+bool StorageClient::scanParts(GraphSpaceID spaceId,
+                              const std::vector<PartitionID>& parts,
+                              const IterFactory& factory,
+                              const ScanCallback& cb,
+                              const Progress& progress) {
+  std::atomic<bool> succeeded{true};
+  std::atomic<bool> stopped{false};
+
+  // Parts with the same leader are scanned by one request, at most
+  // scanPartsPerRequest_ of them
+  std::unordered_map<HostAddr, std::vector<PartitionID>> partsByLeader;
+  for (auto partId : parts) {
+    auto leader = mClient_->getPartLeaderFromCache(spaceId, partId);
+    if (!leader.first) {
+      LOG(ERROR) << "Get leader of part " << partId << " in space " << spaceId << " failed";
+      succeeded = false;
+      continue;
+    }
+    partsByLeader[leader.second].emplace_back(partId);
+  }
+  struct PendingParts {
+    std::vector<PartitionID> partIds;
+    HostAddr leader;
+  };
+  std::deque<PendingParts> pending;
+  auto partsPerRequest = static_cast<std::size_t>(std::max(sConfig_.scanPartsPerRequest_, 1));
+  for (auto& entry : partsByLeader) {
+    auto& partIds = entry.second;
+    for (std::size_t i = 0; i < partIds.size(); i += partsPerRequest) {
+      auto end = std::min(i + partsPerRequest, partIds.size());
+      pending.push_back({{partIds.begin() + i, partIds.begin() + end}, entry.first});
+    }
+  }
+
+  std::mutex lock;
+  std::condition_variable cv;
+  std::unordered_map<HostAddr, int32_t> inflight;
+  auto perHost = std::max(sConfig_.scanConcurrencyPerHost_, 1);
+
+  // Take the first pending parts whose leader is below the per host limit
+  auto take = [&](PendingParts* item) {
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+      auto& count = inflight[it->leader];
+      if (count < perHost) {
+        ++count;
+        *item = std::move(*it);
+        pending.erase(it);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  auto worker = [&]() {
+    while (true) {
+      PendingParts item;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        bool taken = false;
+        cv.wait(guard, [&] { return stopped || pending.empty() || (taken = take(&item)); });
+        if (!taken) {
+          return;
+        }
+      }
+      auto partId = item.partIds.size() == 1 ? item.partIds.front() : kMixedParts;
+      auto iter = factory(item.partIds);
+      while (!stopped && iter->hasNext()) {
+        auto page = iter->next();
+        if (iter->failed_) {
+          // The other parts of the request go on
+          succeeded = false;
+          if (page.rows.empty()) {
+            continue;
+          }
+        }
+        auto rows = page.rowSize();
+        auto goOn = cb(partId, std::move(page));
+        progress(*iter, item.partIds, rows);
+        if (!goOn) {
+          stopped = true;
+          break;
+        }
+      }
+      if (iter->failed_) {
+        LOG(ERROR) << "Scan parts " << folly::join(",", item.partIds) << " on " << item.leader
+                   << " failed";
+      }
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        --inflight[item.leader];
+      }
+      cv.notify_all();
+    }
+  };
+
+  auto concurrency = std::min<std::size_t>(std::max(sConfig_.scanConcurrency_, 1), pending.size());
+  runtime_->runWorkers(concurrency, worker);
+  return succeeded;
+}
+
+std::pair<bool, DataSet> StorageClient::lookupParts(const storage::cpp2::LookupIndexRequest& req,
+                                                    std::vector<PartitionID> partIds) {
+  using Result = std::pair<bool, storage::cpp2::LookupIndexResp>;
+  auto spaceId = req.get_space_id();
+  DataSet page;
+  bool succeeded = true;
+  for (int32_t retries = 0; !partIds.empty(); ++retries) {
+    if (retries > 0) {
+      if (retries > sConfig_.scanRetryTimes_) {
+        LOG(ERROR) << "Look up parts " << folly::join(",", partIds) << " failed after "
+                   << sConfig_.scanRetryTimes_ << " retries";
+        return {false, std::move(page)};
+      }
+      ++scanRetries_;
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(sConfig_.scanRetryIntervalMs_ << (retries - 1)));
+    }
+    // The leaders may have changed since the last try
+    std::unordered_map<HostAddr, std::vector<PartitionID>> partsByLeader;
+    std::vector<PartitionID> failed;
+    for (auto partId : partIds) {
+      auto leader = mClient_->getPartLeaderFromCache(spaceId, partId);
+      if (!leader.first) {
+        failed.emplace_back(partId);
+        continue;
+      }
+      partsByLeader[leader.second].emplace_back(partId);
+    }
+
+    std::vector<folly::Future<Result>> futures;
+    std::vector<std::vector<PartitionID>> partsOfRequests;
+    for (auto& entry : partsByLeader) {
+      std::pair<HostAddr, storage::cpp2::LookupIndexRequest> request(entry.first, req);
+      request.second.set_parts(entry.second);
+      folly::Promise<Result> promise;
+      futures.emplace_back(promise.getFuture());
+      partsOfRequests.emplace_back(std::move(entry.second));
+      getResponse(std::move(request),
+                  [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                     const storage::cpp2::LookupIndexRequest& r) {
+                    return client->future_lookupIndex(r);
+                  },
+                  std::move(promise));
+    }
+
+    bool refresh = !failed.empty();
+    auto tries = folly::collectAll(std::move(futures)).get();
+    for (std::size_t i = 0; i < tries.size(); ++i) {
+      auto& r = tries[i].value();
+      if (!r.first) {
+        failed.insert(failed.end(), partsOfRequests[i].begin(), partsOfRequests[i].end());
+        refresh = true;
+        continue;
+      }
+      for (const auto& failedPart : r.second.get_result().get_failed_parts()) {
+        auto code = failedPart.get_code();
+        // Only a part whose leader moved or is unreachable may succeed again
+        if (code != nebula::cpp2::ErrorCode::E_LEADER_CHANGED &&
+            code != nebula::cpp2::ErrorCode::E_PART_NOT_FOUND &&
+            code != nebula::cpp2::ErrorCode::E_RPC_FAILURE) {
+          LOG(ERROR) << "Look up part " << failedPart.get_part_id()
+                     << " failed, errorcode: " << static_cast<int32_t>(code);
+          succeeded = false;
+          continue;
+        }
+        failed.emplace_back(failedPart.get_part_id());
+        auto leader = failedPart.leader_ref();
+        if (code == nebula::cpp2::ErrorCode::E_LEADER_CHANGED && leader.has_value() &&
+            !leader.value().host.empty()) {
+          mClient_->updateLeader(spaceId, failedPart.get_part_id(), leader.value());
+        } else {
+          refresh = true;
+        }
+      }
+      auto data = r.second.data_ref();
+      if (data.has_value() && !data.value().rows.empty()) {
+        page.append(std::move(data.value()));
+      }
+    }
+    if (refresh) {
+      mClient_->refreshLeaders();
+    }
+    partIds = std::move(failed);
+  }
+  return {succeeded, std::move(page)};
+}
+
+folly::Future<std::pair<bool, storage::cpp2::ExecResponse>> StorageClient::doAddEdgesAsync(
+    const HostAddr& leader, const storage::cpp2::AddEdgesRequest& req) {
+  folly::Promise<std::pair<bool, storage::cpp2::ExecResponse>> promise;
+  auto future = promise.getFuture();
+  getResponse(std::make_pair(leader, req),
+              [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                 const storage::cpp2::AddEdgesRequest& r) { return client->future_addEdges(r); },
+              std::move(promise));
+  return future;
+}
+
+folly::Future<std::pair<bool, storage::cpp2::ExecResponse>> StorageClient::doAddVerticesAsync(
+    const HostAddr& leader, const storage::cpp2::AddVerticesRequest& req) {
+  folly::Promise<std::pair<bool, storage::cpp2::ExecResponse>> promise;
+  auto future = promise.getFuture();
+  getResponse(std::make_pair(leader, req),
+              [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                 const storage::cpp2::AddVerticesRequest& r) {
+                return client->future_addVertices(r);
+              },
+              std::move(promise));
+  return future;
 }
 
 std::pair<bool, storage::cpp2::ScanResponse> StorageClient::doScanEdge(
     const storage::cpp2::ScanEdgeRequest& req) {
-  std::pair<HostAddr, storage::cpp2::ScanEdgeRequest> request;
-  auto partCursorMap = req.get_parts();
-  DCHECK_EQ(partCursorMap.size(), 1);
-  PartitionID partId = partCursorMap.begin()->first;
-  auto host = mClient_->getPartLeaderFromCache(req.get_space_id(), partId);
-  if (!host.first) {
-    return {false, storage::cpp2::ScanResponse()};
-  }
-  request.first = host.second;
-  request.second = req;
-
-  folly::Promise<std::pair<bool, storage::cpp2::ScanResponse>> promise;
-  auto future = promise.getFuture();
-  getResponse(
-      std::move(request),
-      [](storage::cpp2::GraphStorageServiceAsyncClient* client,
-         const storage::cpp2::ScanEdgeRequest& r) { return client->future_scanEdge(r); },
-      std::move(promise));
-  return std::move(future).get();
+  return doScanEdgeAsync(req).get();
 }
 
+folly::Future<std::pair<bool, storage::cpp2::ScanResponse>> StorageClient::doScanEdgeAsync(
+    const storage::cpp2::ScanEdgeRequest& req) {
+  return doScanAsync(req,
+                     [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                        const storage::cpp2::ScanEdgeRequest& r) {
+                       return client->future_scanEdge(r);
+                     });
+}
+
+void StorageClient::recordScanPage(int64_t pageSize, int64_t rows, int64_t bytes) {
+  std::lock_guard<std::mutex> guard(statsLock_);
+  auto& stats = scanPageStats_;
+  stats.minPageSize_ = stats.pages_ == 0 ? pageSize : std::min(stats.minPageSize_, pageSize);
+  stats.maxPageSize_ = std::max(stats.maxPageSize_, pageSize);
+  stats.lastPageSize_ = pageSize;
+  stats.totalPageSize_ += pageSize;
+  stats.rows_ += rows;
+  stats.bytes_ += bytes;
+  ++stats.pages_;
+}
+
+std::pair<bool, storage::cpp2::ScanResponse> StorageClient::doScanVertex(
+    const storage::cpp2::ScanVertexRequest& req) {
+  return doScanVertexAsync(req).get();
+}
+
+folly::Future<std::pair<bool, storage::cpp2::ScanResponse>> StorageClient::doScanVertexAsync(
+    const storage::cpp2::ScanVertexRequest& req) {
+  return doScanAsync(req,
+                     [](storage::cpp2::GraphStorageServiceAsyncClient* client,
+                        const storage::cpp2::ScanVertexRequest& r) {
+                       return client->future_scanVertex(r);
+                     });
+}
+
+template <typename Request, typename RemoteFunc>
+folly::Future<std::pair<bool, storage::cpp2::ScanResponse>> StorageClient::doScanAsync(
+    const Request& req, RemoteFunc&& remoteFunc) {
+  using Result = std::pair<bool, storage::cpp2::ScanResponse>;
+  // Split the parts by their current leaders, one request for each leader
+  std::vector<storage::cpp2::PartitionResult> failedParts;
+  std::unordered_map<HostAddr, std::unordered_map<PartitionID, storage::cpp2::ScanCursor>>
+      partsByLeader;
+  for (const auto& part : req.get_parts()) {
+    auto host = mClient_->getPartLeaderFromCache(req.get_space_id(), part.first);
+    if (!host.first) {
+      storage::cpp2::PartitionResult result;
+      result.set_code(nebula::cpp2::ErrorCode::E_PART_NOT_FOUND);
+      result.set_part_id(part.first);
+      failedParts.emplace_back(std::move(result));
+      continue;
+    }
+    partsByLeader[host.second].emplace(part.first, part.second);
+  }
+  if (partsByLeader.empty()) {
+    return folly::makeFuture(Result(false, storage::cpp2::ScanResponse()));
+  }
+
+  std::vector<folly::Future<Result>> futures;
+  std::vector<std::vector<PartitionID>> partsOfFutures;
+  futures.reserve(partsByLeader.size());
+  for (auto& entry : partsByLeader) {
+    std::pair<HostAddr, Request> request(entry.first, req);
+    std::vector<PartitionID> partIds;
+    for (const auto& part : entry.second) {
+      partIds.emplace_back(part.first);
+    }
+    request.second.set_parts(std::move(entry.second));
+
+    folly::Promise<Result> promise;
+    futures.emplace_back(promise.getFuture());
+    partsOfFutures.emplace_back(std::move(partIds));
+    getResponse(std::move(request), std::decay_t<RemoteFunc>(remoteFunc), std::move(promise));
+  }
+  if (futures.size() == 1 && failedParts.empty()) {
+    return std::move(futures.front());
+  }
+
+  // Merge the responses, the parts of a failed request are failed
+  return folly::collectAll(std::move(futures))
+      .thenValue([failedParts = std::move(failedParts),
+                  partsOfFutures = std::move(partsOfFutures)](
+                     std::vector<folly::Try<Result>>&& tries) mutable {
+        DataSet props;
+        std::unordered_map<PartitionID, storage::cpp2::ScanCursor> cursors;
+        int64_t latency = 0;
+        for (std::size_t i = 0; i < tries.size(); ++i) {
+          auto& r = tries[i].value();
+          if (!r.first) {
+            for (auto partId : partsOfFutures[i]) {
+              storage::cpp2::PartitionResult result;
+              result.set_code(nebula::cpp2::ErrorCode::E_RPC_FAILURE);
+              result.set_part_id(partId);
+              failedParts.emplace_back(std::move(result));
+            }
+            continue;
+          }
+          auto& resp = r.second;
+          const auto& common = resp.get_result();
+          const auto& partResults = common.get_failed_parts();
+          failedParts.insert(failedParts.end(), partResults.begin(), partResults.end());
+          latency = std::max(latency, common.get_latency_in_us());
+          for (auto& cursor : resp.get_cursors()) {
+            cursors.emplace(cursor.first, cursor.second);
+          }
+          if (resp.get_props() != nullptr) {
+            props.append(std::move(resp.props_ref().value()));
+          }
+        }
+        storage::cpp2::ResponseCommon common;
+        common.set_failed_parts(std::move(failedParts));
+        common.set_latency_in_us(latency);
+        storage::cpp2::ScanResponse merged;
+        merged.set_result(std::move(common));
+        merged.set_props(std::move(props));
+        merged.set_cursors(std::move(cursors));
+        return Result(true, std::move(merged));
+      });
+}
+
+template <typename Request, typename RemoteFunc, typename T, typename Response>
+std::vector<Response> StorageClient::fanOut(Request req,
+                                            RemoteFunc&& remoteFunc,
+                                            StorageResult<T>* result,
+                                            std::size_t maxRows) {
+  using Result = std::pair<bool, Response>;
+  auto spaceId = req.get_space_id();
+  auto parts = std::move(req.parts_ref().value());
+  req.parts_ref().value().clear();
+  std::unordered_map<HostAddr, std::decay_t<decltype(parts)>> partsByLeader;
+  bool refresh = false;
+  for (auto& part : parts) {
+    auto leader = mClient_->getPartLeaderFromCache(spaceId, part.first);
+    if (!leader.first) {
+      result->failedParts_.emplace(part.first,
+                                   static_cast<int32_t>(nebula::cpp2::ErrorCode::E_PART_NOT_FOUND));
+      refresh = true;
+      continue;
+    }
+    partsByLeader[leader.second].emplace(part.first, std::move(part.second));
+  }
+
+  std::vector<folly::Future<Result>> futures;
+  std::vector<HostAddr> hosts;
+  std::vector<std::vector<PartitionID>> partsOfHosts;
+  // Set by the requests, a deque keeps them in place as it grows
+  std::deque<RpcLatency> latencies;
+  futures.reserve(partsByLeader.size());
+  for (auto& entry : partsByLeader) {
+    for (auto& partsOfRequest : splitParts(std::move(entry.second), maxRows)) {
+      std::pair<HostAddr, Request> request(entry.first, req);
+      std::vector<PartitionID> partIds;
+      for (const auto& part : partsOfRequest) {
+        partIds.emplace_back(part.first);
+      }
+      request.second.set_parts(std::move(partsOfRequest));
+
+      folly::Promise<Result> promise;
+      futures.emplace_back(promise.getFuture());
+      hosts.emplace_back(entry.first);
+      partsOfHosts.emplace_back(std::move(partIds));
+      latencies.emplace_back();
+      getResponse(std::move(request),
+                  std::decay_t<RemoteFunc>(remoteFunc),
+                  std::move(promise),
+                  &latencies.back());
+    }
+  }
+
+  std::vector<Response> responses;
+  auto tries = folly::collectAll(std::move(futures)).get();
+  for (std::size_t i = 0; i < tries.size(); ++i) {
+    auto& slowest = result->rpcLatency_[hosts[i]];
+    if (latencies[i].totalUs_ >= slowest.totalUs_) {
+      slowest = std::move(latencies[i]);
+    }
+    auto& r = tries[i].value();
+    if (!r.first) {
+      for (auto partId : partsOfHosts[i]) {
+        result->failedParts_.emplace(partId,
+                                     static_cast<int32_t>(nebula::cpp2::ErrorCode::E_RPC_FAILURE));
+      }
+      refresh = true;
+      continue;
+    }
+    const auto& common = r.second.get_result();
+    // The slowest of the requests to the host
+    auto& latency = result->latencyUs_[hosts[i]];
+    latency = std::max<int64_t>(latency, common.get_latency_in_us());
+    for (const auto& failedPart : common.get_failed_parts()) {
+      auto code = failedPart.get_code();
+      result->failedParts_.emplace(failedPart.get_part_id(), static_cast<int32_t>(code));
+      auto leader = failedPart.leader_ref();
+      if (code == nebula::cpp2::ErrorCode::E_LEADER_CHANGED && leader.has_value() &&
+          !leader.value().host.empty()) {
+        mClient_->updateLeader(spaceId, failedPart.get_part_id(), leader.value());
+      } else if (code == nebula::cpp2::ErrorCode::E_LEADER_CHANGED ||
+                 code == nebula::cpp2::ErrorCode::E_PART_NOT_FOUND) {
+        refresh = true;
+      }
+    }
+    responses.emplace_back(std::move(r.second));
+  }
+  if (refresh) {
+    mClient_->refreshLeaders();
+  }
+  return responses;
+}
+
+// A request waiting in limiter_ for a slot of its host, and the callers of
+// the requests merged into it
+template <typename Request, typename RemoteFunc, typename Response>
+class StorageClient::PendingRpc : public HostLimiter::Pending {
+ public:
+  using Result = std::pair<bool, Response>;
+
+  PendingRpc(StorageClient* client,
+             std::pair<HostAddr, Request>&& request,
+             RemoteFunc remoteFunc,
+             folly::Promise<Result> pro,
+             RpcLatency* latency)
+      : client_(client),
+        host_(request.first),
+        req_(std::move(request.second)),
+        remoteFunc_(std::move(remoteFunc)),
+        call_(std::make_shared<RpcCall>()) {
+    callers_.emplace_back(Caller{std::move(pro), latency});
+  }
+
+  bool merge(HostLimiter::Pending* other) override {
+    auto* from = dynamic_cast<PendingRpc*>(other);
+    if (from == nullptr ||
+        !mergeable(&req_, &from->req_, client_->sConfig_.coalesceMaxRows_)) {
+      return false;
+    }
+    // The requests of the callers, each takes its part of the response
+    if (owns_.empty()) {
+      owns_.emplace_back(req_);
+    }
+    mergeInto(&req_, from->req_);
+    for (std::size_t i = 0; i < from->callers_.size(); ++i) {
+      callers_.emplace_back(std::move(from->callers_[i]));
+      owns_.emplace_back(from->owns_.empty() ? std::move(from->req_) : std::move(from->owns_[i]));
+    }
+    return true;
+  }
+
+  void send() override {
+    auto* evb = DCHECK_NOTNULL(client_->ioExecutor_)->getEventBase();
+    folly::via(
+        evb,
+        [evb,
+         client = client_,
+         host = host_,
+         req = std::move(req_),
+         remoteFunc = std::move(remoteFunc_),
+         call = call_,
+         callers = std::move(callers_),
+         owns = std::move(owns_)]() mutable {
+          auto rpc = rpcName(req);
+          auto thriftClient =
+              client->clientsMan_->client(host, evb, false, client->sConfig_.clientTimeoutInMs_);
+          VLOG(2) << "Send " << rpc << " to storage " << host;
+          call->send([&] { return remoteFunc(thriftClient.get(), req); })
+              .via(evb)
+              .then([client,
+                     host,
+                     rpc,
+                     call,
+                     callers = std::move(callers),
+                     owns = std::move(owns)](folly::Try<Response>&& t) mutable {
+                bool ok = !t.hasException();
+                // exception occurred during RPC
+                if (!ok) {
+                  LOG(ERROR) << "Send request to " << host << " failed";
+                  LOG(ERROR) << "RpcResponse exception: " << t.exception().what().c_str();
+                }
+                call->finish(ok ? &t.value().get_result() : nullptr);
+                const auto& latency = call->latency();
+                client->recordRpc(rpc, host, latency, ok);
+                client->limiter_.release(host, latency.totalUs_ - latency.queueUs_, ok);
+                for (std::size_t i = 0; i < callers.size(); ++i) {
+                  auto& caller = callers[i];
+                  if (caller.latency_ != nullptr) {
+                    *caller.latency_ = latency;
+                  }
+                  if (!ok) {
+                    caller.promise_.setValue(Result(false, Response()));
+                  } else if (owns.empty()) {
+                    caller.promise_.setValue(Result(true, std::move(t.value())));
+                  } else {
+                    caller.promise_.setValue(Result(true, responseOf(owns[i], t.value())));
+                  }
+                }
+              });
+        });  // via
+  }
+
+ private:
+  struct Caller {
+    folly::Promise<Result> promise_;
+    RpcLatency* latency_;
+  };
+
+  StorageClient* client_;
+  HostAddr host_;
+  Request req_;
+  RemoteFunc remoteFunc_;
+  std::shared_ptr<RpcCall> call_;
+  std::vector<Caller> callers_;
+  // The request of each caller, empty if nothing was merged
+  std::vector<Request> owns_;
+};
+
 template <typename Request, typename RemoteFunc, typename Response>
 void StorageClient::getResponse(std::pair<HostAddr, Request>&& request,
                                 RemoteFunc&& remoteFunc,
-                                folly::Promise<std::pair<bool, Response>> pro) {
-  auto* evb = DCHECK_NOTNULL(ioExecutor_)->getEventBase();
-  folly::via(evb,
-             [evb,
-              request = std::move(request),
-              remoteFunc = std::move(remoteFunc),
-              pro = std::move(pro),
-              this]() mutable {
-               auto host = request.first;
-               auto client = clientsMan_->client(host, evb, false, sConfig_.clientTimeoutInMs_);
-               LOG(INFO) << "Send request to storage " << host;
-               remoteFunc(client.get(), request.second)
-                   .via(evb)
-                   .then([pro = std::move(pro), host](folly::Try<Response>&& t) mutable {
-                     // exception occurred during RPC
-                     if (t.hasException()) {
-                       LOG(ERROR) << "Send request to " << host << " failed";
-                       LOG(ERROR) << "RpcResponse exception: " << t.exception().what().c_str();
-                       pro.setValue(std::make_pair(false, Response()));
-                       return;
-                     }
-                     auto&& resp = t.value();
-                     pro.setValue(std::make_pair(true, std::move(resp)));
-                   });
-             });  // via
+                                folly::Promise<std::pair<bool, Response>> pro,
+                                RpcLatency* latency) {
+  auto host = request.first;
+  limiter_.submit(host,
+                  std::make_unique<PendingRpc<Request, std::decay_t<RemoteFunc>, Response>>(
+                      this,
+                      std::move(request),
+                      std::forward<RemoteFunc>(remoteFunc),
+                      std::move(pro),
+                      latency));
+}
+
+void StorageClient::recordRpc(const std::string& rpc,
+                              const HostAddr& host,
+                              const RpcLatency& latency,
+                              bool succeeded) {
+  std::lock_guard<std::mutex> guard(statsLock_);
+  rpcStats_[std::make_pair(rpc, host)].add(latency, succeeded);
 }
 
 }  // namespace nebula
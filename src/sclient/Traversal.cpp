@@ -0,0 +1,252 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "nebula/sclient/Traversal.h"
+
+#include <folly/container/F14Map.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "nebula/sclient/PartitionRouter.h"
+
+namespace nebula {
+
+namespace {
+
+// The key of a vid in the set of the vids reached, the 8 bytes of an int vid
+// or a string vid itself. The keys of the usual vids fit in the inline buffer
+// of std::string, and the set keeps them inline too.
+std::string vidKey(const Value& vid) {
+  if (vid.isInt()) {
+    auto id = vid.getInt();
+    return std::string(reinterpret_cast<const char*>(&id), sizeof(id));
+  }
+  return vid.getStr();
+}
+
+Value vidOf(const std::string& key, bool intVid) {
+  if (intVid) {
+    int64_t id = 0;
+    std::memcpy(&id, key.data(), sizeof(id));
+    return Value(id);
+  }
+  return Value(key);
+}
+
+}  // namespace
+
+Traversal::Traversal(StorageClient* client, const TraversalConfig& config)
+    : client_(client), config_(config) {}
+
+StorageResult<std::vector<std::vector<Value>>> Traversal::expand(
+    const std::string& spaceName,
+    const std::vector<Value>& startVids,
+    const std::vector<std::string>& edges,
+    EdgeDirection direction,
+    const std::string& filter) {
+  StorageResult<std::vector<std::vector<Value>>> result;
+  auto* mClient = client_->getMetaClient();
+  auto spaceIdResult = mClient->getSpaceIdByNameFromCache(spaceName);
+  if (!spaceIdResult.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto spaceId = spaceIdResult.second;
+  auto router = PartitionRouter::make(mClient, spaceId);
+  if (!router.first) {
+    result.ok_ = false;
+    return result;
+  }
+  auto intVid = router.second.intVid();
+
+  // Only the other end of each edge is asked for
+  EdgeProps edgeProps;
+  if (edges.empty()) {
+    auto schemas = mClient->getEdgeSchemasFromCache(spaceId);
+    if (!schemas.first) {
+      result.ok_ = false;
+      return result;
+    }
+    for (const auto& schema : schemas.second) {
+      edgeProps.emplace_back(schema.name_, std::vector<std::string>{"_dst"});
+    }
+  } else {
+    for (const auto& edge : edges) {
+      if (!mClient->getEdgeTypeByNameFromCache(spaceId, edge).first) {
+        result.ok_ = false;
+        return result;
+      }
+      edgeProps.emplace_back(edge, std::vector<std::string>{"_dst"});
+    }
+  }
+  for (const auto& vid : startVids) {
+    if (router.second.partFor(vid) == 0) {
+      LOG(ERROR) << "Vid " << vid << " is not of the vid type of space " << spaceName;
+      result.ok_ = false;
+      return result;
+    }
+  }
+
+  auto maxHops = std::max(config_.maxHops_, 0);
+  auto batchSize = static_cast<std::size_t>(std::max(config_.batchSize_, 1));
+  auto limit = config_.maxDegree_ > 0 ? config_.maxDegree_ : DEFAULT_LIMIT;
+  auto maxVertices = config_.maxVertices_ > 0 ? static_cast<std::size_t>(config_.maxVertices_)
+                                              : std::numeric_limits<std::size_t>::max();
+  result.data_.resize(maxHops + 1);
+
+  std::mutex lock;
+  std::condition_variable cv;
+  // The hop of each vid reached, the least if it's reached by several paths
+  folly::F14FastMap<std::string, int32_t> visited;
+  // The vids of each hop to expand which are not batched yet, by the leaders
+  // of their parts
+  std::map<int32_t, std::unordered_map<HostAddr, std::vector<Value>>> frontier;
+  // The full batches of each hop, the lower hops are sent first
+  std::map<int32_t, std::deque<std::vector<Value>>> ready;
+  int32_t inflight = 0;
+  bool stopped = false;
+
+  auto add = [&](int32_t hop, Value vid) {
+    auto leader = mClient->getPartLeaderFromCache(spaceId, router.second.partFor(vid));
+    auto& hosts = frontier[hop];
+    auto& vids = hosts[leader.second];
+    vids.emplace_back(std::move(vid));
+    if (vids.size() >= batchSize) {
+      ready[hop].emplace_back(std::move(vids));
+      hosts.erase(leader.second);
+      if (hosts.empty()) {
+        frontier.erase(hop);
+      }
+    }
+  };
+
+  // A vid is expanded again if it's reached by a shorter path later, which
+  // happens when the batches of several hops are in flight
+  auto visit = [&](int32_t hop, Value vid) {
+    auto key = vidKey(vid);
+    auto it = visited.find(key);
+    if (it == visited.end()) {
+      if (visited.size() >= maxVertices) {
+        stopped = true;
+        return;
+      }
+      visited.emplace(std::move(key), hop);
+    } else if (it->second > hop) {
+      it->second = hop;
+    } else {
+      return;
+    }
+    if (hop < maxHops) {
+      add(hop, std::move(vid));
+    }
+  };
+
+  // Take a full batch of the lowest hop, or the largest unfinished one of the
+  // lowest hop rather than wait
+  auto take = [&](int32_t* hop, std::vector<Value>* vids) {
+    if (!ready.empty()) {
+      auto it = ready.begin();
+      *hop = it->first;
+      *vids = std::move(it->second.front());
+      it->second.pop_front();
+      if (it->second.empty()) {
+        ready.erase(it);
+      }
+      return true;
+    }
+    if (frontier.empty()) {
+      return false;
+    }
+    auto it = frontier.begin();
+    auto largest = std::max_element(it->second.begin(),
+                                    it->second.end(),
+                                    [](const auto& a, const auto& b) {
+                                      return a.second.size() < b.second.size();
+                                    });
+    *hop = it->first;
+    *vids = std::move(largest->second);
+    it->second.erase(largest);
+    if (it->second.empty()) {
+      frontier.erase(it);
+    }
+    return true;
+  };
+
+  auto worker = [&]() {
+    while (true) {
+      int32_t hop = 0;
+      std::vector<Value> vids;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        bool taken = false;
+        cv.wait(guard, [&] { return stopped || (taken = take(&hop, &vids)) || inflight == 0; });
+        if (!taken) {
+          return;
+        }
+        ++inflight;
+      }
+      auto neighbors =
+          client_->getNeighbors(spaceName, vids, edgeProps, direction, {}, filter, limit);
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!neighbors.ok_) {
+          result.ok_ = false;
+        }
+        result.failedParts_.insert(neighbors.failedParts_.begin(), neighbors.failedParts_.end());
+        for (const auto& latency : neighbors.latencyUs_) {
+          auto& slowest = result.latencyUs_[latency.first];
+          slowest = std::max(slowest, latency.second);
+        }
+        const auto& ds = neighbors.data_;
+        std::vector<std::size_t> edgeCols;
+        for (std::size_t i = 0; i < ds.colNames.size(); ++i) {
+          if (ds.colNames[i].find("_edge:") == 0) {
+            edgeCols.emplace_back(i);
+          }
+        }
+        // Each edge column is a list of the edges of the vertex, each a list
+        // of _dst
+        for (const auto& row : ds.rows) {
+          int64_t degree = 0;
+          for (auto col : edgeCols) {
+            const auto& edgesOfVid = row.values[col];
+            if (!edgesOfVid.isList()) {
+              continue;
+            }
+            for (const auto& edge : edgesOfVid.getList().values) {
+              if (degree++ >= limit || stopped) {
+                break;
+              }
+              if (edge.isList() && !edge.getList().values.empty()) {
+                visit(hop + 1, edge.getList().values[0]);
+              }
+            }
+          }
+        }
+        --inflight;
+      }
+      cv.notify_all();
+    }
+  };
+
+  for (const auto& vid : startVids) {
+    visit(0, vid);
+  }
+  client_->runtime()->runWorkers(std::max(config_.concurrency_, 1), worker);
+
+  for (const auto& entry : visited) {
+    result.data_[entry.second].emplace_back(vidOf(entry.first, intVid));
+  }
+  return result;
+}
+
+}  // namespace nebula
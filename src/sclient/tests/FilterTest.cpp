@@ -0,0 +1,109 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <nebula/sclient/Filter.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include "common/datatypes/ValueOps-inl.h"
+
+namespace nebula {
+
+class Encoder {
+ public:
+  Encoder& operator<<(Filter::Kind kind) {
+    buf_.push_back(static_cast<char>(kind));
+    return *this;
+  }
+
+  Encoder& operator<<(std::size_t size) {
+    buf_.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    return *this;
+  }
+
+  Encoder& operator<<(const std::string& str) {
+    *this << str.size();
+    buf_.append(str);
+    return *this;
+  }
+
+  Encoder& operator<<(const Value& value) {
+    apache::thrift::CompactSerializer::serialize(value, &buf_);
+    return *this;
+  }
+
+  const std::string& str() const {
+    return buf_;
+  }
+
+ private:
+  std::string buf_;
+};
+
+TEST(FilterTest, Encode) {
+  using Kind = Filter::Kind;
+  {
+    auto filter = Filter::edgeProp("like", "likeness") > 90;
+    Encoder expected;
+    expected << Kind::kRelGT << Kind::kEdgeProperty << std::string() << std::string("like")
+             << std::string("likeness") << Kind::kConstant << Value(90);
+    EXPECT_EQ(filter.encode(), expected.str());
+  }
+  {
+    auto filter = Filter::tagProp("player", "age") >= 30 && Filter::tagProp("player", "age") < 40 &&
+                  !Filter::tagProp("player", "name").isNull();
+    Encoder expected;
+    expected << Kind::kLogicalAnd << std::size_t(3);
+    expected << Kind::kRelGE << Kind::kTagProperty << std::string() << std::string("player")
+             << std::string("age") << Kind::kConstant << Value(30);
+    expected << Kind::kRelLT << Kind::kTagProperty << std::string() << std::string("player")
+             << std::string("age") << Kind::kConstant << Value(40);
+    expected << Kind::kUnaryNot << Kind::kIsNull << Kind::kTagProperty << std::string()
+             << std::string("player") << std::string("name");
+    EXPECT_EQ(filter.encode(), expected.str());
+  }
+  {
+    auto filter = Filter::edgeDst("like") == "Tony" || Filter::edgeRank("like") != 0;
+    Encoder expected;
+    expected << Kind::kLogicalOr << std::size_t(2);
+    expected << Kind::kRelEQ << Kind::kEdgeDst << std::string() << std::string("like")
+             << std::string("_dst") << Kind::kConstant << Value("Tony");
+    expected << Kind::kRelNE << Kind::kEdgeRank << std::string() << std::string("like")
+             << std::string("_rank") << Kind::kConstant << Value(0);
+    EXPECT_EQ(filter.encode(), expected.str());
+  }
+}
+
+TEST(FilterTest, Kinds) {
+  // The kinds are the values of nebula::Expression::Kind
+  EXPECT_EQ(static_cast<int>(Filter::Kind::kRelEQ), 11);
+  EXPECT_EQ(static_cast<int>(Filter::Kind::kLogicalAnd), 30);
+  EXPECT_EQ(static_cast<int>(Filter::Kind::kTagProperty), 36);
+  EXPECT_EQ(static_cast<int>(Filter::Kind::kEdgeProperty), 38);
+  EXPECT_EQ(static_cast<int>(Filter::Kind::kIsNull), 65);
+}
+
+TEST(FilterTest, ToString) {
+  auto filter = (Filter::edgeProp("like", "likeness") + 1 > 90 ||
+                 Filter::edgeSrc("like").in(List({Value("Tim"), Value("Tony")}))) &&
+                Filter::srcProp("player", "name").startsWith("T");
+  EXPECT_EQ(filter.toString(),
+            "((((like.likeness+1)>90) OR (like._src IN [\"Tim\",\"Tony\"])) AND "
+            "($^.player.name STARTS WITH \"T\"))");
+  EXPECT_EQ((-Filter::tagProp("player", "age")).toString(), "-player.age");
+  EXPECT_EQ(Filter::dstProp("team", "name").isNotEmpty().toString(), "$$.team.name IS NOT EMPTY");
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
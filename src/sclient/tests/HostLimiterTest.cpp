@@ -0,0 +1,169 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <nebula/sclient/HostLimiter.h>
+
+#include <string>
+#include <vector>
+
+namespace nebula {
+
+namespace {
+
+// Record the names of the requests sent, a request merges those of the same
+// kind and its name becomes "a+b"
+class FakeRequest : public HostLimiter::Pending {
+ public:
+  FakeRequest(std::vector<std::string>* sent, std::string name, int kind = 0)
+      : sent_(sent), name_(std::move(name)), kind_(kind) {}
+
+  void send() override {
+    sent_->emplace_back(name_);
+  }
+
+  bool merge(HostLimiter::Pending* other) override {
+    auto* from = static_cast<FakeRequest*>(other);
+    if (from->kind_ != kind_ || kind_ == 0) {
+      return false;
+    }
+    name_ += "+" + from->name_;
+    return true;
+  }
+
+ private:
+  std::vector<std::string>* sent_;
+  std::string name_;
+  int kind_;
+};
+
+}  // namespace
+
+TEST(HostLimiterTest, NoLimit) {
+  SConfig sConfig;
+  HostLimiter limiter(sConfig);
+  HostAddr host("127.0.0.1", 9779);
+  std::vector<std::string> sent;
+  for (int i = 0; i < 10; ++i) {
+    limiter.submit(host, std::make_unique<FakeRequest>(&sent, std::to_string(i)));
+  }
+  EXPECT_EQ(sent.size(), 10);
+  EXPECT_EQ(limiter.limitOf(host), 0);
+  EXPECT_EQ(limiter.stats().queued_, 0);
+}
+
+TEST(HostLimiterTest, Queue) {
+  SConfig sConfig;
+  sConfig.maxInflightPerHost_ = 2;
+  HostLimiter limiter(sConfig);
+  HostAddr host1("127.0.0.1", 9779);
+  HostAddr host2("127.0.0.2", 9779);
+  std::vector<std::string> sent;
+  limiter.submit(host1, std::make_unique<FakeRequest>(&sent, "a"));
+  limiter.submit(host1, std::make_unique<FakeRequest>(&sent, "b"));
+  limiter.submit(host1, std::make_unique<FakeRequest>(&sent, "c"));
+  limiter.submit(host1, std::make_unique<FakeRequest>(&sent, "d"));
+  // Another host has its own slots
+  limiter.submit(host2, std::make_unique<FakeRequest>(&sent, "e"));
+  EXPECT_EQ(sent, (std::vector<std::string>{"a", "b", "e"}));
+  EXPECT_EQ(limiter.stats().queued_, 2);
+
+  // Sent in order as the slots are freed
+  limiter.release(host1, 100, true);
+  EXPECT_EQ(sent, (std::vector<std::string>{"a", "b", "e", "c"}));
+  limiter.release(host1, 100, false);
+  EXPECT_EQ(sent, (std::vector<std::string>{"a", "b", "e", "c", "d"}));
+  limiter.release(host1, 100, true);
+  limiter.release(host1, 100, true);
+  // Not adaptive, the limit is kept after a failure
+  EXPECT_EQ(limiter.limitOf(host1), 2);
+
+  limiter.submit(host1, std::make_unique<FakeRequest>(&sent, "f"));
+  EXPECT_EQ(sent.back(), "f");
+}
+
+TEST(HostLimiterTest, Coalesce) {
+  SConfig sConfig;
+  sConfig.maxInflightPerHost_ = 1;
+  HostLimiter limiter(sConfig);
+  HostAddr host("127.0.0.1", 9779);
+  std::vector<std::string> sent;
+  limiter.submit(host, std::make_unique<FakeRequest>(&sent, "a", 1));
+  // Only the waiting requests are merged
+  limiter.submit(host, std::make_unique<FakeRequest>(&sent, "b", 1));
+  limiter.submit(host, std::make_unique<FakeRequest>(&sent, "c", 2));
+  limiter.submit(host, std::make_unique<FakeRequest>(&sent, "d", 1));
+  limiter.submit(host, std::make_unique<FakeRequest>(&sent, "e", 2));
+  limiter.submit(host, std::make_unique<FakeRequest>(&sent, "f", 0));
+  EXPECT_EQ(limiter.stats().queued_, 3);
+  EXPECT_EQ(limiter.stats().merged_, 2);
+
+  for (int i = 0; i < 3; ++i) {
+    limiter.release(host, 100, true);
+  }
+  EXPECT_EQ(sent, (std::vector<std::string>{"a", "b+d", "c+e", "f"}));
+
+  sConfig.coalesceRequests_ = false;
+  HostLimiter separate(sConfig);
+  sent.clear();
+  separate.submit(host, std::make_unique<FakeRequest>(&sent, "a", 1));
+  separate.submit(host, std::make_unique<FakeRequest>(&sent, "b", 1));
+  separate.submit(host, std::make_unique<FakeRequest>(&sent, "c", 1));
+  separate.release(host, 100, true);
+  separate.release(host, 100, true);
+  EXPECT_EQ(sent, (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(separate.stats().merged_, 0);
+}
+
+TEST(HostLimiterTest, Adaptive) {
+  SConfig sConfig;
+  sConfig.maxInflightPerHost_ = 8;
+  sConfig.targetLatencyMs_ = 10;
+  HostLimiter limiter(sConfig);
+  HostAddr host("127.0.0.1", 9779);
+  std::vector<std::string> sent;
+  for (int i = 0; i < 8; ++i) {
+    limiter.submit(host, std::make_unique<FakeRequest>(&sent, std::to_string(i)));
+  }
+  EXPECT_EQ(limiter.limitOf(host), 8);
+
+  // A slow round of 8 halves the limit once
+  for (int i = 0; i < 8; ++i) {
+    limiter.release(host, 20 * 1000, true);
+  }
+  EXPECT_EQ(limiter.limitOf(host), 4);
+  EXPECT_EQ(limiter.stats().decreases_, 1);
+
+  // A failure halves it again
+  limiter.submit(host, std::make_unique<FakeRequest>(&sent, "x"));
+  limiter.release(host, 0, false);
+  EXPECT_EQ(limiter.limitOf(host), 2);
+
+  // Only 2 are sent now
+  for (int i = 0; i < 4; ++i) {
+    limiter.submit(host, std::make_unique<FakeRequest>(&sent, "y"));
+  }
+  EXPECT_EQ(sent.size(), 11);
+
+  // Fast responses add about 1 to the limit in each round, up to the max
+  for (int i = 0; i < 200; ++i) {
+    limiter.release(host, 1000, true);
+    limiter.submit(host, std::make_unique<FakeRequest>(&sent, "z"));
+  }
+  EXPECT_EQ(limiter.limitOf(host), 8);
+  EXPECT_EQ(limiter.stats().decreases_, 2);
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
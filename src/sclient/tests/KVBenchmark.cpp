@@ -0,0 +1,254 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../interface/gen-cpp2/GraphStorageService.h"
+#include "../../interface/gen-cpp2/MetaService.h"
+#include "nebula/sclient/StorageClient.h"
+
+DEFINE_int32(kv_parts, 16, "Number of parts of the space of the stand-in storaged");
+DEFINE_int32(kv_keys, 100000, "Number of keys put before the gets");
+
+// Throughput of the KV API against stand-in metad and storaged in this
+// process, which keep the key values in a map. The time of an iteration is
+// that of a key, so iters/s is keys/s.
+
+namespace nebula {
+
+static constexpr char kSpace[] = "kv_bm";
+static constexpr GraphSpaceID kSpaceId = 1;
+
+// Serve the KV API of a space from a map
+class StandInStorage : public storage::cpp2::GraphStorageServiceSvIf {
+ public:
+  folly::Future<storage::cpp2::KVGetResponse> future_get(
+      const storage::cpp2::KVGetRequest& req) override {
+    std::unordered_map<std::string, std::string> kvs;
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      for (const auto& part : req.get_parts()) {
+        for (const auto& key : part.second) {
+          auto it = kvs_.find(key);
+          if (it != kvs_.end()) {
+            kvs.emplace(key, it->second);
+          }
+        }
+      }
+    }
+    storage::cpp2::KVGetResponse resp;
+    resp.set_result(storage::cpp2::ResponseCommon());
+    resp.set_key_values(std::move(kvs));
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<storage::cpp2::ExecResponse> future_put(
+      const storage::cpp2::KVPutRequest& req) override {
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      for (const auto& part : req.get_parts()) {
+        for (const auto& kv : part.second) {
+          kvs_[kv.key] = kv.value;
+        }
+      }
+    }
+    storage::cpp2::ExecResponse resp;
+    resp.set_result(storage::cpp2::ResponseCommon());
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<storage::cpp2::ExecResponse> future_remove(
+      const storage::cpp2::KVRemoveRequest& req) override {
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      for (const auto& part : req.get_parts()) {
+        for (const auto& key : part.second) {
+          kvs_.erase(key);
+        }
+      }
+    }
+    storage::cpp2::ExecResponse resp;
+    resp.set_result(storage::cpp2::ResponseCommon());
+    return folly::makeFuture(std::move(resp));
+  }
+
+ private:
+  std::mutex lock_;
+  std::unordered_map<std::string, std::string> kvs_;
+};
+
+// Describe the space whose parts are all led by the stand-in storaged, with
+// what MetaClient loads
+class StandInMeta : public meta::cpp2::MetaServiceSvIf {
+ public:
+  explicit StandInMeta(HostAddr storage) : storage_(std::move(storage)) {}
+
+  folly::Future<meta::cpp2::ListSpacesResp> future_listSpaces(
+      const meta::cpp2::ListSpacesReq&) override {
+    meta::cpp2::ID id;
+    id.set_space_id(kSpaceId);
+    meta::cpp2::IdName idName;
+    idName.set_id(std::move(id));
+    idName.set_name(kSpace);
+    meta::cpp2::ListSpacesResp resp;
+    resp.set_code(nebula::cpp2::ErrorCode::SUCCEEDED);
+    resp.set_spaces({std::move(idName)});
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<meta::cpp2::GetSpaceResp> future_getSpace(
+      const meta::cpp2::GetSpaceReq&) override {
+    meta::cpp2::ColumnTypeDef vidType;
+    vidType.set_type(nebula::cpp2::PropertyType::FIXED_STRING);
+    vidType.set_type_length(32);
+    meta::cpp2::SpaceDesc desc;
+    desc.set_space_name(kSpace);
+    desc.set_partition_num(FLAGS_kv_parts);
+    desc.set_vid_type(std::move(vidType));
+    meta::cpp2::SpaceItem item;
+    item.set_space_id(kSpaceId);
+    item.set_properties(std::move(desc));
+    meta::cpp2::GetSpaceResp resp;
+    resp.set_code(nebula::cpp2::ErrorCode::SUCCEEDED);
+    resp.set_item(std::move(item));
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<meta::cpp2::ListEdgesResp> future_listEdges(
+      const meta::cpp2::ListEdgesReq&) override {
+    meta::cpp2::ListEdgesResp resp;
+    resp.set_code(nebula::cpp2::ErrorCode::SUCCEEDED);
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<meta::cpp2::ListTagsResp> future_listTags(
+      const meta::cpp2::ListTagsReq&) override {
+    meta::cpp2::ListTagsResp resp;
+    resp.set_code(nebula::cpp2::ErrorCode::SUCCEEDED);
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<meta::cpp2::ListTagIndexesResp> future_listTagIndexes(
+      const meta::cpp2::ListTagIndexesReq&) override {
+    meta::cpp2::ListTagIndexesResp resp;
+    resp.set_code(nebula::cpp2::ErrorCode::SUCCEEDED);
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<meta::cpp2::ListEdgeIndexesResp> future_listEdgeIndexes(
+      const meta::cpp2::ListEdgeIndexesReq&) override {
+    meta::cpp2::ListEdgeIndexesResp resp;
+    resp.set_code(nebula::cpp2::ErrorCode::SUCCEEDED);
+    return folly::makeFuture(std::move(resp));
+  }
+
+  folly::Future<meta::cpp2::ListHostsResp> future_listHosts(
+      const meta::cpp2::ListHostsReq&) override {
+    std::vector<PartitionID> parts;
+    for (PartitionID partId = 1; partId <= FLAGS_kv_parts; ++partId) {
+      parts.emplace_back(partId);
+    }
+    meta::cpp2::HostItem host;
+    host.set_hostAddr(storage_);
+    host.set_leader_parts({{kSpace, parts}});
+    host.set_all_parts({{kSpace, parts}});
+    meta::cpp2::ListHostsResp resp;
+    resp.set_code(nebula::cpp2::ErrorCode::SUCCEEDED);
+    resp.set_hosts({std::move(host)});
+    return folly::makeFuture(std::move(resp));
+  }
+
+ private:
+  HostAddr storage_;
+};
+
+// A request to each leader, and requests of SConfig::kvBatchSize_ keys
+static StorageClient* gOneRequestClient = nullptr;
+static StorageClient* gClient = nullptr;
+
+static std::string keyOf(std::size_t i) {
+  return "key_" + std::to_string(i % FLAGS_kv_keys);
+}
+
+// Put iters keys, batch keys by each call
+static void putKeys(std::size_t iters, std::size_t batch, bool split) {
+  auto* client = split ? gClient : gOneRequestClient;
+  for (std::size_t done = 0; done < iters; done += batch) {
+    std::vector<KeyValue> kvs;
+    BENCHMARK_SUSPEND {
+      auto n = std::min(batch, iters - done);
+      kvs.reserve(n);
+      for (std::size_t i = done; i < done + n; ++i) {
+        kvs.emplace_back(std::make_pair(keyOf(i), std::string(64, 'v')));
+      }
+    }
+    auto result = client->kvPut(kSpace, std::move(kvs));
+    folly::doNotOptimizeAway(result.data_);
+  }
+}
+
+// Get iters keys, batch keys by each call
+static void getKeys(std::size_t iters, std::size_t batch, bool split) {
+  auto* client = split ? gClient : gOneRequestClient;
+  for (std::size_t done = 0; done < iters; done += batch) {
+    std::vector<std::string> keys;
+    BENCHMARK_SUSPEND {
+      auto n = std::min(batch, iters - done);
+      keys.reserve(n);
+      for (std::size_t i = done; i < done + n; ++i) {
+        keys.emplace_back(keyOf(i));
+      }
+    }
+    auto result = client->kvGet(kSpace, keys);
+    folly::doNotOptimizeAway(result.data_.size());
+  }
+}
+
+BENCHMARK_NAMED_PARAM(putKeys, 1_key, 1, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(putKeys, 100_keys, 100, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(putKeys, 10000_keys, 10000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(putKeys, 10000_keys_split, 10000, true)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(getKeys, 1_key, 1, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(getKeys, 100_keys, 100, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(getKeys, 10000_keys, 10000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(getKeys, 10000_keys_split, 10000, true)
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+
+  apache::thrift::ScopedServerInterfaceThread storaged(
+      std::make_shared<nebula::StandInStorage>(), "127.0.0.1", 0);
+  apache::thrift::ScopedServerInterfaceThread metad(
+      std::make_shared<nebula::StandInMeta>(nebula::HostAddr("127.0.0.1", storaged.getPort())),
+      "127.0.0.1",
+      0);
+  auto metaAddr = "127.0.0.1:" + std::to_string(metad.getPort());
+
+  nebula::SConfig oneRequest;
+  oneRequest.kvBatchSize_ = 0;
+  nebula::StorageClient oneRequestClient({metaAddr}, nebula::MConfig{}, oneRequest);
+  nebula::StorageClient client({metaAddr});
+  nebula::gOneRequestClient = &oneRequestClient;
+  nebula::gClient = &client;
+
+  nebula::putKeys(FLAGS_kv_keys, 10000, true);
+  folly::runBenchmarks();
+  return 0;
+}
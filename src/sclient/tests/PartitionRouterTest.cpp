@@ -0,0 +1,83 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <nebula/sclient/PartitionRouter.h>
+
+#include <vector>
+
+namespace nebula {
+
+TEST(PartitionRouterTest, Hash) {
+  // MurmurHash64A with the seed of nebula
+  EXPECT_EQ(PartitionRouter::hash(""), 6142509188972423790ULL);
+  EXPECT_EQ(PartitionRouter::hash("a"), 4993892634952068459ULL);
+  EXPECT_EQ(PartitionRouter::hash("abcdefghi"), 13036955925923793583ULL);
+  // Hashed as a C string
+  EXPECT_EQ(PartitionRouter::hash(folly::StringPiece("a\0b", 3)), PartitionRouter::hash("a"));
+}
+
+TEST(PartitionRouterTest, IntVid) {
+  PartitionRouter router(100, true);
+  EXPECT_EQ(router.partFor(Value(0)), 1);
+  EXPECT_EQ(router.partFor(Value(101)), 2);
+  // Taken as an uint64
+  EXPECT_EQ(router.partFor(Value(-1)), static_cast<PartitionID>(UINT64_MAX % 100 + 1));
+  EXPECT_EQ(router.partFor(Value("101")), 0);
+
+  for (int32_t numParts : {1, 7, 64, 100, 1024}) {
+    PartitionRouter r(numParts, true);
+    std::vector<int64_t> ids;
+    std::vector<Value> vids;
+    for (int64_t i = -1000; i < 1000; i += 7) {
+      ids.emplace_back(i * 1000003);
+      vids.emplace_back(i * 1000003);
+    }
+    std::vector<PartitionID> parts(ids.size());
+    std::vector<PartitionID> partsOfValues(ids.size());
+    r.partsForInts(folly::range(ids), parts.data());
+    EXPECT_TRUE(r.partsFor(folly::range(vids), partsOfValues.data()));
+    EXPECT_EQ(parts, partsOfValues);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+      EXPECT_EQ(parts[i], static_cast<PartitionID>(static_cast<uint64_t>(ids[i]) % numParts + 1));
+    }
+  }
+}
+
+TEST(PartitionRouterTest, StringVid) {
+  PartitionRouter router(100, false);
+  EXPECT_EQ(router.partFor(Value("abcdefghi")), 13036955925923793583ULL % 100 + 1);
+  // 8 bytes are taken as an uint64
+  EXPECT_EQ(router.partFor(Value("aaaaaaaa")), 0x6161616161616161ULL % 100 + 1);
+  EXPECT_EQ(router.partFor(Value(101)), 0);
+
+  std::vector<Value> vids{Value("Tim"), Value(1), Value("Tony")};
+  std::vector<PartitionID> parts(vids.size());
+  EXPECT_FALSE(router.partsFor(folly::range(vids), parts.data()));
+  EXPECT_EQ(parts[0], router.partFor(Value("Tim")));
+  EXPECT_EQ(parts[1], 0);
+  EXPECT_EQ(parts[2], router.partFor(Value("Tony")));
+}
+
+TEST(PartitionRouterTest, Key) {
+  // Routed as string vids whatever the vid type
+  for (bool intVid : {false, true}) {
+    PartitionRouter router(100, intVid);
+    EXPECT_EQ(router.partForKey("abcdefghi"), 13036955925923793583ULL % 100 + 1);
+    EXPECT_EQ(router.partForKey("aaaaaaaa"), 0x6161616161616161ULL % 100 + 1);
+  }
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <nebula/sclient/RpcStats.h>
+
+namespace nebula {
+
+TEST(RpcStatsTest, Histogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.percentileUs(50), 0);
+  EXPECT_EQ(histogram.meanUs(), 0);
+
+  // 1..100us
+  for (int64_t us = 1; us <= 100; ++us) {
+    histogram.add(us);
+  }
+  EXPECT_EQ(histogram.count(), 100);
+  EXPECT_EQ(histogram.sumUs(), 5050);
+  EXPECT_EQ(histogram.maxUs(), 100);
+  EXPECT_DOUBLE_EQ(histogram.meanUs(), 50.5);
+  // 50 is in [32, 64), 90 and 100 in [64, 128) which is capped by the max
+  EXPECT_EQ(histogram.percentileUs(50), 63);
+  EXPECT_EQ(histogram.percentileUs(90), 100);
+  EXPECT_EQ(histogram.percentileUs(100), 100);
+  EXPECT_EQ(histogram.percentileUs(0), 1);
+
+  LatencyHistogram other;
+  other.add(0);
+  other.add(-5);
+  other.add(1 << 20);
+  histogram.merge(other);
+  EXPECT_EQ(histogram.count(), 103);
+  EXPECT_EQ(histogram.maxUs(), 1 << 20);
+  EXPECT_EQ(histogram.percentileUs(1), 0);
+  EXPECT_EQ(histogram.percentileUs(100), 1 << 20);
+}
+
+TEST(RpcStatsTest, Breakdown) {
+  RpcLatency latency;
+  latency.totalUs_ = 1000;
+  latency.queueUs_ = 100;
+  latency.serializeUs_ = 50;
+  latency.serverUs_ = 600;
+  latency.bytesOut_ = 10;
+  latency.bytesIn_ = 20;
+  EXPECT_EQ(latency.networkUs(), 250);
+
+  RpcStats stats;
+  stats.add(latency, true);
+  RpcLatency failed;
+  failed.totalUs_ = 5000;
+  stats.add(failed, false);
+  EXPECT_EQ(stats.calls_, 2);
+  EXPECT_EQ(stats.failures_, 1);
+  EXPECT_EQ(stats.bytesOut_, 10);
+  EXPECT_EQ(stats.bytesIn_, 20);
+  EXPECT_EQ(stats.totalUs_.count(), 2);
+  EXPECT_EQ(stats.totalUs_.maxUs(), 5000);
+  // Only the calls with a response are broken down
+  EXPECT_EQ(stats.serverUs_.count(), 1);
+  EXPECT_EQ(stats.networkUs_.sumUs(), 250);
+
+  // Clocks of the client and of storage don't add up exactly
+  latency.serverUs_ = 2000;
+  EXPECT_EQ(latency.networkUs(), 0);
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,94 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <nebula/sclient/ScanCheckpoint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace nebula {
+
+static void expectEqual(const ScanCheckpoint& a, const ScanCheckpoint& b) {
+  EXPECT_EQ(a.spaceName_, b.spaceName_);
+  EXPECT_EQ(a.edgeName_, b.edgeName_);
+  EXPECT_EQ(a.propNames_, b.propNames_);
+  EXPECT_EQ(a.tagProps_, b.tagProps_);
+  EXPECT_EQ(a.limit_, b.limit_);
+  EXPECT_EQ(a.startTime_, b.startTime_);
+  EXPECT_EQ(a.endTime_, b.endTime_);
+  EXPECT_EQ(a.filter_, b.filter_);
+  EXPECT_EQ(a.onlyLatestVersion_, b.onlyLatestVersion_);
+  EXPECT_EQ(a.enableReadFromFollower_, b.enableReadFromFollower_);
+  EXPECT_EQ(a.cursors_, b.cursors_);
+  EXPECT_EQ(a.finished_, b.finished_);
+  EXPECT_EQ(a.rows_, b.rows_);
+}
+
+TEST(ScanCheckpointTest, Json) {
+  ScanCheckpoint checkpoint;
+  checkpoint.spaceName_ = "nba";
+  checkpoint.edgeName_ = "like";
+  checkpoint.propNames_ = {"likeness"};
+  checkpoint.limit_ = 100;
+  checkpoint.filter_ = std::string("\x00\x01\xff", 3);
+  checkpoint.onlyLatestVersion_ = true;
+  // Cursors are binary
+  checkpoint.cursors_ = {{1, std::string("\x00\x7f\x80", 3)}, {3, ""}};
+  checkpoint.finished_ = {2, 4};
+  checkpoint.rows_ = 12345;
+  {
+    auto result = ScanCheckpoint::fromJson(checkpoint.toJson());
+    ASSERT_TRUE(result.first);
+    expectEqual(result.second, checkpoint);
+  }
+  checkpoint.edgeName_ = "";
+  checkpoint.propNames_.clear();
+  checkpoint.tagProps_ = {{"player", {"name", "age"}}, {"team", {}}};
+  {
+    auto result = ScanCheckpoint::fromJson(checkpoint.toJson());
+    ASSERT_TRUE(result.first);
+    expectEqual(result.second, checkpoint);
+  }
+  EXPECT_FALSE(ScanCheckpoint::fromJson("{}").first);
+  EXPECT_FALSE(ScanCheckpoint::fromJson("not json").first);
+}
+
+TEST(ScanCheckpointTest, File) {
+  std::string dir = "/tmp/scan_checkpoint_test.XXXXXX";
+  ASSERT_NE(::mkdtemp(&dir[0]), nullptr);
+  auto path = dir + "/checkpoint.json";
+  EXPECT_FALSE(ScanCheckpoint::load(path).first);
+
+  ScanCheckpoint checkpoint;
+  checkpoint.spaceName_ = "nba";
+  checkpoint.edgeName_ = "like";
+  checkpoint.cursors_ = {{1, "cursor"}};
+  ASSERT_TRUE(checkpoint.save(path));
+  checkpoint.finished_ = {1};
+  checkpoint.cursors_.clear();
+  checkpoint.rows_ = 10;
+  // Overwrite the old one
+  ASSERT_TRUE(checkpoint.save(path));
+  auto result = ScanCheckpoint::load(path);
+  ASSERT_TRUE(result.first);
+  expectEqual(result.second, checkpoint);
+
+  EXPECT_FALSE(checkpoint.save(dir + "/not_exist/checkpoint.json"));
+
+  ::unlink(path.c_str());
+  ::rmdir(dir.c_str());
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <nebula/sclient/ScanPageSizer.h>
+
+namespace nebula {
+
+TEST(ScanPageSizerTest, Disabled) {
+  SConfig sConfig;
+  ScanPageSizer sizer(sConfig, 100);
+  EXPECT_FALSE(sizer.enabled());
+  EXPECT_FALSE(ScanPageSizer().enabled());
+}
+
+TEST(ScanPageSizerTest, Latency) {
+  SConfig sConfig;
+  sConfig.scanTargetPageLatencyMs_ = 10;
+  sConfig.scanInitialPageSize_ = 100;
+  ScanPageSizer sizer(sConfig, 100000);
+  ASSERT_TRUE(sizer.enabled());
+  EXPECT_EQ(sizer.limit(), 100);
+
+  // 1us a row, grows twice a page up to 10000 rows
+  EXPECT_EQ(sizer.update(100, 1000, 100), 200);
+  EXPECT_EQ(sizer.update(200, 2000, 200), 400);
+  int64_t limit = 400;
+  for (int i = 0; i < 10; ++i) {
+    limit = sizer.update(limit, limit * 10, limit);
+  }
+  EXPECT_EQ(limit, 10000);
+
+  // A short page doesn't grow it
+  EXPECT_EQ(sizer.update(10, 100, 10), 10000);
+
+  // Slower rows shrink it
+  for (int i = 0; i < 20; ++i) {
+    limit = sizer.update(limit, limit * 10, limit * 10);
+  }
+  EXPECT_EQ(limit, 1000);
+}
+
+TEST(ScanPageSizerTest, Bytes) {
+  SConfig sConfig;
+  sConfig.scanTargetPageBytes_ = 1 << 20;
+  sConfig.scanInitialPageSize_ = 1 << 20;
+  ScanPageSizer sizer(sConfig, 1 << 30);
+  EXPECT_EQ(sizer.limit(), 1 << 20);
+  // 1KB a row
+  EXPECT_EQ(sizer.update(1 << 20, 1 << 30, 1000), 1024);
+
+  // Bounded by the limit of the scan and the min page size
+  ScanPageSizer small(sConfig, 10);
+  EXPECT_EQ(small.limit(), 10);
+  EXPECT_EQ(small.update(10, 10 << 20, 1000), 10);
+  EXPECT_EQ(ScanPageSizer(sConfig, 1000).update(1000, 1000 << 20, 1000), 16);
+}
+
+TEST(ScanPageSizerTest, MemoryBudget) {
+  SConfig sConfig;
+  sConfig.scanTargetPageBytes_ = 1 << 20;
+  sConfig.scanInitialPageSize_ = 1 << 20;
+  sConfig.scanConcurrency_ = 4;
+  sConfig.scanPrefetchDepth_ = 1;
+  // 64KB for each of the 8 pages in flight
+  sConfig.scanMemoryBudgetBytes_ = 8 << 16;
+  ScanPageSizer sizer(sConfig, 1 << 30);
+  EXPECT_EQ(sizer.update(1 << 20, 1 << 30, 1000), 64);
+}
+
+TEST(ScanPageSizerTest, EstimateBytes) {
+  DataSet page({"a", "b", "c"});
+  page.emplace_back(List({Value("abcd"), Value(1), Value::kNullValue}));
+  page.emplace_back(List({Value(""), Value(1.5), Value(true)}));
+  EXPECT_EQ(estimateScanBytes(page), 8 + 8 + 1 + 4 + 8 + 8);
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,164 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+#include "../../interface/gen-cpp2/storage_types.h"
+#include "nebula/sclient/ScanSink.h"
+
+// Count the allocations to report them per row
+static std::atomic<int64_t> gAllocs{0};
+
+void* operator new(std::size_t size) {
+  ++gAllocs;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace nebula {
+
+static constexpr std::size_t kRows = 1024;
+static constexpr std::size_t kPages = 64;
+
+static storage::cpp2::ScanResponse makeResponse() {
+  DataSet ds({"like._src", "like._type", "like._rank", "like._dst", "like.likeness"});
+  for (std::size_t r = 0; r < kRows; ++r) {
+    ds.emplace_back(Row({"source_vertex_" + std::to_string(r),
+                         1,
+                         0,
+                         "destination_vertex_" + std::to_string(r),
+                         static_cast<int64_t>(r)}));
+  }
+  storage::cpp2::ScanResponse resp;
+  resp.set_props(std::move(ds));
+  return resp;
+}
+
+static const storage::cpp2::ScanResponse kResponse = makeResponse();
+
+// How ScanEdgeIter::next() used to take the page: copy the response, then
+// the data set out of it
+static DataSet copyPage(std::pair<bool, storage::cpp2::ScanResponse>&& r) {
+  auto scanResponse = r.second;
+  return *scanResponse.get_props();
+}
+
+static DataSet movePage(std::pair<bool, storage::cpp2::ScanResponse>&& r) {
+  return std::move(r.second.props_ref().value());
+}
+
+template <typename Take>
+static void takePages(std::size_t iters, Take take) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    std::pair<bool, storage::cpp2::ScanResponse> r;
+    BENCHMARK_SUSPEND {
+      r = {true, kResponse};
+    }
+    auto page = take(std::move(r));
+    folly::doNotOptimizeAway(page.rowSize());
+    BENCHMARK_SUSPEND {
+      page = DataSet();
+    }
+  }
+}
+
+BENCHMARK(copyPageOfResponse, iters) {
+  takePages(iters, copyPage);
+}
+
+BENCHMARK_RELATIVE(movePageOfResponse, iters) {
+  takePages(iters, movePage);
+}
+
+BENCHMARK_DRAW_LINE();
+
+// Pages of kRows rows consumed by 1 or 4 threads through the sink
+static void sinkPages(std::size_t iters, std::size_t threads) {
+  for (std::size_t i = 0; i < iters; ++i) {
+    std::vector<DataSet> pages;
+    BENCHMARK_SUSPEND {
+      pages.assign(kPages, *kResponse.get_props());
+    }
+    std::atomic<std::size_t> rows{0};
+    ScanSink sink(
+        [&rows](PartitionID, DataSet&& page) {
+          rows += page.rowSize();
+          return true;
+        },
+        threads,
+        threads * 2);
+    auto cb = sink.callback();
+    for (auto& page : pages) {
+      cb(1, std::move(page));
+    }
+    sink.finish();
+    folly::doNotOptimizeAway(rows.load());
+  }
+}
+
+BENCHMARK(sinkOneConsumer, iters) {
+  sinkPages(iters, 1);
+}
+
+BENCHMARK_RELATIVE(sinkFourConsumers, iters) {
+  sinkPages(iters, 4);
+}
+
+// Allocations per row of taking a page out of the response
+template <typename Take>
+static double allocsPerRow(Take take) {
+  std::pair<bool, storage::cpp2::ScanResponse> r{true, kResponse};
+  auto before = gAllocs.load();
+  auto page = take(std::move(r));
+  auto allocs = gAllocs.load() - before;
+  folly::doNotOptimizeAway(page.rowSize());
+  return static_cast<double>(allocs) / kRows;
+}
+
+// Allocations per row of a data set copy, to turn the above into copies
+static double allocsPerCopy() {
+  auto before = gAllocs.load();
+  DataSet copy = *kResponse.get_props();
+  auto allocs = gAllocs.load() - before;
+  folly::doNotOptimizeAway(copy.rowSize());
+  return static_cast<double>(allocs) / kRows;
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  auto perCopy = nebula::allocsPerCopy();
+  for (auto& path : {std::make_pair("copyPageOfResponse", &nebula::copyPage),
+                     std::make_pair("movePageOfResponse", &nebula::movePage)}) {
+    auto allocs = nebula::allocsPerRow(path.second);
+    std::cout << path.first << ": " << allocs << " allocations/row, " << allocs / perCopy
+              << " copies/row" << std::endl;
+  }
+  return 0;
+}
+
@@ -0,0 +1,104 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <nebula/sclient/ScanSink.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace nebula {
+
+static DataSet makePage(int64_t first, std::size_t rows) {
+  DataSet page({"like.likeness"});
+  for (std::size_t i = 0; i < rows; ++i) {
+    page.emplace_back(Row({first + static_cast<int64_t>(i)}));
+  }
+  return page;
+}
+
+TEST(ScanSinkTest, Consume) {
+  constexpr std::size_t kProducers = 4;
+  constexpr std::size_t kPages = 100;
+  constexpr std::size_t kMaxInflight = 3;
+
+  std::atomic<int64_t> sum{0};
+  std::atomic<std::size_t> consuming{0};
+  std::atomic<std::size_t> maxConsuming{0};
+  ScanSink sink(
+      [&](PartitionID partId, DataSet&& page) {
+        auto n = ++consuming;
+        auto max = maxConsuming.load();
+        while (n > max && !maxConsuming.compare_exchange_weak(max, n)) {
+        }
+        EXPECT_GT(partId, 0);
+        for (const auto& row : page.rows) {
+          sum += row.values[0].getInt();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        --consuming;
+        return true;
+      },
+      4,
+      kMaxInflight);
+
+  std::vector<std::thread> producers;
+  for (std::size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&sink, p] {
+      auto cb = sink.callback();
+      for (std::size_t i = 0; i < kPages; ++i) {
+        EXPECT_TRUE(cb(p + 1, makePage(1, 10)));
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  EXPECT_TRUE(sink.finish());
+  // Each page sums 1 + 2 + ... + 10
+  EXPECT_EQ(sum, static_cast<int64_t>(kProducers * kPages * 55));
+  EXPECT_LE(maxConsuming, kMaxInflight);
+}
+
+TEST(ScanSinkTest, Stop) {
+  std::atomic<std::size_t> consumed{0};
+  ScanSink sink(
+      [&](PartitionID, DataSet&&) {
+        ++consumed;
+        return false;
+      },
+      2,
+      4);
+  auto cb = sink.callback();
+  std::size_t pushed = 0;
+  // The producer is told to stop after the consumer stopped
+  while (cb(1, makePage(0, 1))) {
+    ++pushed;
+    ASSERT_LT(pushed, 10000U);
+  }
+  EXPECT_FALSE(sink.finish());
+  EXPECT_GE(consumed, 1U);
+  EXPECT_LE(consumed, pushed);
+}
+
+TEST(ScanSinkTest, Empty) {
+  ScanSink sink([](PartitionID, DataSet&&) { return true; }, 2, 2);
+  EXPECT_TRUE(sink.finish());
+  // Finishing twice is harmless
+  EXPECT_TRUE(sink.finish());
+}
+
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}
@@ -12,9 +12,18 @@
 #include <nebula/client/ConnectionPool.h>
 #include <nebula/client/Session.h>
 #include <nebula/mclient/MetaClient.h>
+#include <nebula/sclient/BulkWriter.h>
+#include <nebula/sclient/Filter.h>
 #include <nebula/sclient/ScanEdgeIter.h>
 #include <nebula/sclient/StorageClient.h>
+#include <nebula/sclient/Traversal.h>
 
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "../../interface/gen-cpp2/common_types.h"
 #include "./SClientTest.h"
 
 // Require a nebula server could access
@@ -37,6 +46,20 @@ class StorageClientTest : public SClientTest {
     auto result2 = session.execute("CREATE EDGE IF NOT EXISTS like(likeness int)");
     ASSERT_EQ(result2.errorCode, nebula::ErrorCode::SUCCEEDED);
 
+    auto result4 = session.execute("CREATE TAG IF NOT EXISTS player(name string, age int)");
+    ASSERT_EQ(result4.errorCode, nebula::ErrorCode::SUCCEEDED);
+
+    // Written by the bulk writer
+    auto result6 = session.execute(
+        "CREATE TAG IF NOT EXISTS team(name string);"
+        "CREATE EDGE IF NOT EXISTS serve(start_year int)");
+    ASSERT_EQ(result6.errorCode, nebula::ErrorCode::SUCCEEDED);
+
+    // Maintained as the players are inserted
+    auto result7 =
+        session.execute("CREATE TAG INDEX IF NOT EXISTS player_name_index ON player(name(10))");
+    ASSERT_EQ(result7.errorCode, nebula::ErrorCode::SUCCEEDED);
+
     ::sleep(30);
 
     auto result3 = session.execute(
@@ -45,6 +68,12 @@ class StorageClientTest : public SClientTest {
         "'301'->'302':(457)");
     ASSERT_EQ(result3.errorCode, nebula::ErrorCode::SUCCEEDED)
         << (result3.errorMsg ? *result3.errorMsg : "");
+
+    auto result5 = session.execute(
+        "INSERT VERTEX player(name, age) VALUES '101':('Tim', 42), '102':('Tony', 36), "
+        "'103':('Manu', 41)");
+    ASSERT_EQ(result5.errorCode, nebula::ErrorCode::SUCCEEDED)
+        << (result5.errorMsg ? *result5.errorMsg : "");
   }
 
   static void runOnce(nebula::MetaClient &c) {
@@ -60,6 +89,10 @@ class StorageClientTest : public SClientTest {
     LOG(INFO) << "edgeType of like: " << edgeType;
     EXPECT_GT(edgeType, 0);
 
+    auto retTag = c.getTagIdByNameFromCache(spaceId, "player");
+    ASSERT_TRUE(retTag.first);
+    EXPECT_GT(retTag.second, 0);
+
     auto ret3 = c.getPartsFromCache(spaceId);
     ASSERT_TRUE(ret3.first);
     auto parts = ret3.second;
@@ -128,6 +161,715 @@ class StorageClientTest : public SClientTest {
       }
     }
   }
+
+  static void runScanEdgeWithPrefetch(nebula::StorageClient &c) {
+    nebula::DataSet expected({"like.likeness"});
+    expected.emplace_back(nebula::List({78}));
+    expected.emplace_back(nebula::List({99}));
+    expected.emplace_back(nebula::List({43}));
+    expected.emplace_back(nebula::List({56}));
+    expected.emplace_back(nebula::List({-13}));
+    expected.emplace_back(nebula::List({431}));
+    expected.emplace_back(nebula::List({457}));
+
+    LOG(INFO) << "run to the end";
+    {
+      auto scanIter = c.scanEdgeWithPart(
+          "storage_client_test", 1, "like", std::vector<std::string>{"likeness"}, 2);
+      nebula::DataSet got;
+      int scanNum = 0;
+      while (scanIter.hasNext()) {
+        nebula::DataSet ds = scanIter.next();
+        got.append(std::move(ds));
+        ++scanNum;
+      }
+      EXPECT_FALSE(scanIter.failed_);
+      EXPECT_EQ(scanNum, 4);
+      EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    }
+    LOG(INFO) << "run with early destruction";
+    {
+      auto scanIter = c.scanEdgeWithPart(
+          "storage_client_test", 1, "like", std::vector<std::string>{"likeness"}, 1);
+      ASSERT_TRUE(scanIter.hasNext());
+      EXPECT_EQ(scanIter.next().size(), 1U);
+    }
+    LOG(INFO) << "run with bad part";
+    {
+      auto scanIter = c.scanEdgeWithPart(
+          "storage_client_test", 999, "like", std::vector<std::string>{"likeness"}, 2);
+      ASSERT_TRUE(scanIter.hasNext());
+      EXPECT_EQ(scanIter.next(), nebula::DataSet());
+      EXPECT_TRUE(scanIter.failed_);
+      EXPECT_FALSE(scanIter.hasNext());
+    }
+  }
+
+  static void runScanEdgeWithAdaptivePageSize(nebula::StorageClient &c) {
+    nebula::DataSet expected({"like.likeness"});
+    expected.emplace_back(nebula::List({78}));
+    expected.emplace_back(nebula::List({99}));
+    expected.emplace_back(nebula::List({43}));
+    expected.emplace_back(nebula::List({56}));
+    expected.emplace_back(nebula::List({-13}));
+    expected.emplace_back(nebula::List({431}));
+    expected.emplace_back(nebula::List({457}));
+
+    // The target of 8 bytes shrinks the pages to one row
+    auto scanIter = c.scanEdgeWithPart(
+        "storage_client_test", 1, "like", std::vector<std::string>{"likeness"});
+    nebula::DataSet got;
+    while (scanIter.hasNext()) {
+      got.append(scanIter.next());
+    }
+    EXPECT_FALSE(scanIter.failed_);
+    EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    auto stats = c.scanPageStats();
+    EXPECT_GT(stats.pages_, 1);
+    EXPECT_EQ(stats.rows_, 7);
+    EXPECT_EQ(stats.maxPageSize_, 2);
+    EXPECT_EQ(stats.minPageSize_, 1);
+    EXPECT_EQ(stats.lastPageSize_, 1);
+  }
+
+  static void runScanWithFilter(nebula::StorageClient &c) {
+    LOG(INFO) << "scan edge";
+    {
+      nebula::DataSet expected({"like.likeness"});
+      expected.emplace_back(nebula::List({99}));
+      expected.emplace_back(nebula::List({431}));
+      expected.emplace_back(nebula::List({457}));
+      auto filter = nebula::Filter::edgeProp("like", "likeness") > 90;
+      auto scanIter = c.scanEdgeWithPart("storage_client_test",
+                                         1,
+                                         "like",
+                                         std::vector<std::string>{"likeness"},
+                                         DEFAULT_LIMIT,
+                                         DEFAULT_START_TIME,
+                                         DEFAULT_END_TIME,
+                                         filter.encode());
+      nebula::DataSet got;
+      while (scanIter.hasNext()) {
+        got.append(scanIter.next());
+      }
+      EXPECT_FALSE(scanIter.failed_);
+      EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    }
+    LOG(INFO) << "scan vertex";
+    {
+      auto filter = nebula::Filter::tagProp("player", "age") < 40 &&
+                    nebula::Filter::tagProp("player", "name").startsWith("T");
+      auto scanIter = c.scanVertexWithPart("storage_client_test",
+                                           1,
+                                           nebula::TagProps{{"player", {"name", "age"}}},
+                                           DEFAULT_LIMIT,
+                                           DEFAULT_START_TIME,
+                                           DEFAULT_END_TIME,
+                                           filter.encode());
+      nebula::DataSet got;
+      while (scanIter.hasNext()) {
+        got.append(scanIter.next());
+      }
+      EXPECT_FALSE(scanIter.failed_);
+      ASSERT_EQ(got.rowSize(), 1U);
+      EXPECT_EQ(got.rows[0].values.back(), nebula::Value(36));
+    }
+  }
+
+  static void runGetNeighbors(nebula::StorageClient &c) {
+    LOG(INFO) << "out edges";
+    {
+      auto result = c.getNeighbors("storage_client_test",
+                                   {nebula::Value("101"), nebula::Value("102")},
+                                   nebula::EdgeProps{{"like", {"likeness"}}},
+                                   nebula::EdgeDirection::kOut,
+                                   nebula::TagProps{{"player", {"name"}}});
+      ASSERT_TRUE(result.succeeded());
+      EXPECT_EQ(result.latencyUs_.size(), 1U);
+      const auto &ds = result.data_;
+      ASSERT_EQ(ds.rowSize(), 2U);
+      auto edgeCol = std::find_if(ds.colNames.begin(), ds.colNames.end(), [](const auto &name) {
+        return name.find("_edge:+like") == 0;
+      });
+      ASSERT_NE(edgeCol, ds.colNames.end());
+      auto tagCol = std::find_if(ds.colNames.begin(), ds.colNames.end(), [](const auto &name) {
+        return name.find("_tag:player") == 0;
+      });
+      ASSERT_NE(tagCol, ds.colNames.end());
+      for (const auto &row : ds.rows) {
+        const auto &edgesOfVid = row.values[edgeCol - ds.colNames.begin()];
+        const auto &tagOfVid = row.values[tagCol - ds.colNames.begin()];
+        if (row.values[0] == nebula::Value("101")) {
+          EXPECT_EQ(edgesOfVid, nebula::Value(nebula::List({nebula::List({78})})));
+          EXPECT_EQ(tagOfVid, nebula::Value(nebula::List({"Tim"})));
+        } else {
+          EXPECT_EQ(row.values[0], nebula::Value("102"));
+          EXPECT_EQ(edgesOfVid, nebula::Value(nebula::List({nebula::List({99})})));
+          EXPECT_EQ(tagOfVid, nebula::Value(nebula::List({"Tony"})));
+        }
+      }
+    }
+    LOG(INFO) << "in edges with filter";
+    {
+      auto filter = nebula::Filter::edgeProp("like", "likeness") > 80;
+      auto result = c.getNeighbors("storage_client_test",
+                                   {nebula::Value("102"), nebula::Value("103")},
+                                   nebula::EdgeProps{{"like", {"likeness"}}},
+                                   nebula::EdgeDirection::kIn,
+                                   {},
+                                   filter.encode());
+      ASSERT_TRUE(result.succeeded());
+      const auto &ds = result.data_;
+      auto edgeCol = std::find_if(ds.colNames.begin(), ds.colNames.end(), [](const auto &name) {
+        return name.find("_edge:-like") == 0;
+      });
+      ASSERT_NE(edgeCol, ds.colNames.end());
+      std::vector<nebula::Value> got;
+      for (const auto &row : ds.rows) {
+        const auto &edgesOfVid = row.values[edgeCol - ds.colNames.begin()];
+        if (edgesOfVid.isList()) {
+          for (const auto &edge : edgesOfVid.getList().values) {
+            got.emplace_back(edge.getList().values[0]);
+          }
+        }
+      }
+      // 101->102 of 78 is filtered out
+      EXPECT_EQ(got, std::vector<nebula::Value>{nebula::Value(99)});
+    }
+    LOG(INFO) << "bad request";
+    {
+      EXPECT_FALSE(c.getNeighbors("not_exist", {nebula::Value("101")}, {}).ok_);
+      nebula::EdgeProps notExist{{"not_exist", {}}};
+      EXPECT_FALSE(c.getNeighbors("storage_client_test", {nebula::Value("101")}, notExist).ok_);
+      EXPECT_FALSE(c.getNeighbors("storage_client_test", {nebula::Value(1.5)}, {}).ok_);
+    }
+  }
+
+  static void runGetProps(nebula::StorageClient &c) {
+    LOG(INFO) << "vertices in input order";
+    {
+      auto result = c.getVertexProps(
+          "storage_client_test",
+          {nebula::Value("103"), nebula::Value("999"), nebula::Value("101"), nebula::Value("103")},
+          nebula::TagProps{{"player", {"name", "age"}}});
+      ASSERT_TRUE(result.succeeded());
+      const auto &ds = result.data_;
+      EXPECT_EQ(ds.colNames, (std::vector<std::string>{"_vid", "player.name", "player.age"}));
+      ASSERT_EQ(ds.rowSize(), 4U);
+      EXPECT_EQ(ds.rows[0], nebula::List({"103", "Manu", 41}));
+      EXPECT_EQ(ds.rows[1], nebula::List(std::vector<nebula::Value>(3)));
+      EXPECT_EQ(ds.rows[2], nebula::List({"101", "Tim", 42}));
+      EXPECT_EQ(ds.rows[3], ds.rows[0]);
+    }
+    LOG(INFO) << "edges in input order";
+    {
+      auto result = c.getEdgeProps("storage_client_test",
+                                   "like",
+                                   {nebula::EdgeKey{"202", 0, "203"},
+                                    nebula::EdgeKey{"101", 0, "103"},
+                                    nebula::EdgeKey{"101", 0, "102"}},
+                                   {"likeness"});
+      ASSERT_TRUE(result.succeeded());
+      const auto &ds = result.data_;
+      EXPECT_EQ(ds.colNames,
+                (std::vector<std::string>{
+                    "like._src", "like._type", "like._rank", "like._dst", "like.likeness"}));
+      ASSERT_EQ(ds.rowSize(), 3U);
+      EXPECT_EQ(ds.rows[0].values[4], nebula::Value(-13));
+      EXPECT_TRUE(ds.rows[1].values[0].empty());
+      EXPECT_EQ(ds.rows[2].values[0], nebula::Value("101"));
+      EXPECT_EQ(ds.rows[2].values[4], nebula::Value(78));
+    }
+    LOG(INFO) << "all properties of edges";
+    {
+      auto result =
+          c.getEdgeProps("storage_client_test", "like", {nebula::EdgeKey{"102", 0, "103"}});
+      ASSERT_TRUE(result.succeeded());
+      ASSERT_EQ(result.data_.rowSize(), 1U);
+      EXPECT_EQ(result.data_.colNames.back(), "like.likeness");
+      EXPECT_EQ(result.data_.rows[0].values.back(), nebula::Value(99));
+    }
+    LOG(INFO) << "bad request";
+    {
+      EXPECT_FALSE(c.getVertexProps("not_exist", {nebula::Value("101")}, {}).ok_);
+      nebula::TagProps notExist{{"not_exist", {}}};
+      EXPECT_FALSE(c.getVertexProps("storage_client_test", {nebula::Value("101")}, notExist).ok_);
+      EXPECT_FALSE(
+          c.getEdgeProps("storage_client_test", "not_exist", {nebula::EdgeKey{"101", 0, "102"}})
+              .ok_);
+      EXPECT_FALSE(c.getVertexProps("storage_client_test", {nebula::Value(1.5)}, {}).ok_);
+    }
+  }
+
+  static void runBulkWriter(nebula::StorageClient &c) {
+    nebula::BulkWriterConfig config;
+    config.batchRows_ = 16;
+    config.maxInflightPerHost_ = 2;
+    config.maxPendingRows_ = 64;
+    auto writer = nebula::BulkWriter::make(&c,
+                                           "storage_client_test",
+                                           nebula::TagProps{{"team", {"name"}}},
+                                           nebula::EdgeProps{{"serve", {"start_year"}}},
+                                           config);
+    ASSERT_NE(writer, nullptr);
+    std::vector<nebula::Value> teams;
+    for (int i = 0; i < 100; ++i) {
+      auto vid = "t" + std::to_string(i);
+      teams.emplace_back(vid);
+      ASSERT_TRUE(writer->addVertex("team", vid, {"team" + std::to_string(i)}));
+      ASSERT_TRUE(writer->addEdge("serve", "101", vid, {2000 + i}));
+    }
+    EXPECT_FALSE(writer->addVertex("player", "101", {"Tim"}));
+    EXPECT_FALSE(writer->addVertex("team", 1, {"int vid"}));
+    EXPECT_TRUE(writer->flush());
+    auto stats = writer->stats();
+    // A vertex and the out-edge and the in-edge of an edge for each team
+    EXPECT_EQ(stats.rows_, 300);
+    EXPECT_EQ(stats.failedRows_, 0);
+    EXPECT_GE(stats.requests_, 300 / config.batchRows_);
+    EXPECT_GT(stats.rowsPerSecond_, 0);
+
+    auto vertices = c.getVertexProps("storage_client_test", teams, {{"team", {"name"}}});
+    ASSERT_TRUE(vertices.succeeded());
+    ASSERT_EQ(vertices.data_.rowSize(), 100U);
+    EXPECT_EQ(vertices.data_.rows[42], nebula::List({"t42", "team42"}));
+    auto in = c.getNeighbors("storage_client_test",
+                             {nebula::Value("t7")},
+                             nebula::EdgeProps{{"serve", {"start_year"}}},
+                             nebula::EdgeDirection::kIn);
+    ASSERT_TRUE(in.succeeded());
+    ASSERT_EQ(in.data_.rowSize(), 1U);
+    auto edgeCol = std::find_if(in.data_.colNames.begin(),
+                                in.data_.colNames.end(),
+                                [](const auto &name) { return name.find("_edge:-serve") == 0; });
+    ASSERT_NE(edgeCol, in.data_.colNames.end());
+    EXPECT_EQ(in.data_.rows[0].values[edgeCol - in.data_.colNames.begin()],
+              nebula::Value(nebula::List({nebula::List({2007})})));
+
+    EXPECT_TRUE(writer->finish());
+    EXPECT_FALSE(writer->addVertex("team", "t0", {"team0"}));
+    // No half of an edge is added after finishing
+    EXPECT_FALSE(writer->addEdge("serve", "101", "t0", {2000}));
+    EXPECT_EQ(writer->stats().rows_, 300);
+    EXPECT_EQ(writer->stats().failedRows_, 0);
+    EXPECT_EQ(nebula::BulkWriter::make(&c, "storage_client_test", {{"not_exist", {}}}, {}),
+              nullptr);
+  }
+
+  static void runKV(nebula::StorageClient &c) {
+    std::vector<nebula::KeyValue> kvs;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; ++i) {
+      keys.emplace_back("kv_key_" + std::to_string(i));
+      kvs.emplace_back(std::make_pair(keys.back(), "kv_value_" + std::to_string(i)));
+    }
+    auto put = c.kvPut("storage_client_test", kvs);
+    ASSERT_TRUE(put.succeeded());
+    EXPECT_EQ(put.data_, 100);
+
+    auto got = c.kvGet("storage_client_test", keys);
+    ASSERT_TRUE(got.succeeded());
+    ASSERT_EQ(got.data_.size(), 100U);
+    EXPECT_EQ(got.data_["kv_key_42"], "kv_value_42");
+
+    LOG(INFO) << "get with missing keys";
+    {
+      std::vector<std::string> someKeys{"kv_key_1", "kv_not_exist", "kv_key_2"};
+      auto partly = c.kvGet("storage_client_test", someKeys, true);
+      ASSERT_TRUE(partly.succeeded());
+      EXPECT_EQ(partly.data_.size(), 2U);
+      EXPECT_EQ(partly.data_.count("kv_not_exist"), 0U);
+      auto all = c.kvGet("storage_client_test", someKeys);
+      EXPECT_FALSE(all.succeeded());
+      for (const auto &failedPart : all.failedParts_) {
+        EXPECT_EQ(failedPart.second,
+                  static_cast<int32_t>(nebula::cpp2::ErrorCode::E_PARTIAL_RESULT));
+      }
+    }
+
+    auto removed = c.kvRemove("storage_client_test", keys);
+    ASSERT_TRUE(removed.succeeded());
+    EXPECT_EQ(removed.data_, 100);
+    auto gone = c.kvGet("storage_client_test", keys, true);
+    ASSERT_TRUE(gone.succeeded());
+    EXPECT_TRUE(gone.data_.empty());
+
+    EXPECT_FALSE(c.kvGet("not_exist", keys).ok_);
+    EXPECT_FALSE(c.kvPut("not_exist", kvs).ok_);
+  }
+
+  static void runLookupIndex(nebula::StorageClient &c) {
+    auto lookup = [&c](std::vector<nebula::IndexHint> hints, int64_t limit) {
+      std::mutex lock;
+      nebula::DataSet got;
+      EXPECT_TRUE(c.lookupIndex("storage_client_test",
+                                "player_name_index",
+                                std::move(hints),
+                                {"_vid", "name"},
+                                [&](nebula::PartitionID, nebula::DataSet &&page) {
+                                  std::lock_guard<std::mutex> guard(lock);
+                                  got.append(std::move(page));
+                                  return true;
+                                },
+                                limit));
+      return got;
+    };
+    LOG(INFO) << "lookup by prefix";
+    {
+      auto got = lookup({nebula::IndexHint{"name", true, "Tim"}}, DEFAULT_LIMIT);
+      ASSERT_EQ(got.rowSize(), 1U);
+      EXPECT_EQ(got.rows[0], nebula::List({"101", "Tim"}));
+    }
+    LOG(INFO) << "lookup by range";
+    {
+      // Manu, Tim and Tony
+      nebula::IndexHint hint{"name", false, "M", "U"};
+      auto got = lookup({hint}, DEFAULT_LIMIT);
+      ASSERT_EQ(got.rowSize(), 3U);
+      std::set<std::string> vids;
+      for (const auto &row : got.rows) {
+        vids.emplace(row.values[0].getStr());
+      }
+      EXPECT_EQ(vids, (std::set<std::string>{"101", "102", "103"}));
+      EXPECT_EQ(lookup({hint}, 2).rowSize(), 2U);
+    }
+    LOG(INFO) << "lookup through the iterator";
+    {
+      auto iter = c.lookupIndex("storage_client_test",
+                                "player_name_index",
+                                {nebula::IndexHint{"name", true, "Tony"}},
+                                {});
+      nebula::DataSet page;
+      std::size_t rows = 0;
+      while (iter->next(&page)) {
+        rows += page.rowSize();
+      }
+      EXPECT_TRUE(iter->succeeded());
+      EXPECT_EQ(rows, 1U);
+    }
+    LOG(INFO) << "bad request";
+    {
+      auto cb = [](nebula::PartitionID, nebula::DataSet &&) { return true; };
+      EXPECT_FALSE(c.lookupIndex("storage_client_test", "not_exist", {}, {}, cb));
+      EXPECT_FALSE(c.lookupIndex("not_exist", "player_name_index", {}, {}, cb));
+    }
+  }
+
+  static void runRpcStats(nebula::StorageClient &c) {
+    auto result = c.getNeighbors(
+        "storage_client_test", {nebula::Value("101")}, nebula::EdgeProps{{"like", {}}});
+    ASSERT_TRUE(result.succeeded());
+    nebula::HostAddr storaged(kServerHost, 9779);
+    ASSERT_EQ(result.rpcLatency_.count(storaged), 1U);
+    const auto &latency = result.rpcLatency_[storaged];
+    EXPECT_GT(latency.totalUs_, 0);
+    EXPECT_EQ(latency.serverUs_, result.latencyUs_[storaged]);
+    EXPECT_GT(latency.bytesOut_, 0);
+    EXPECT_GT(latency.bytesIn_, 0);
+    EXPECT_LE(latency.queueUs_ + latency.serializeUs_ + latency.networkUs(), latency.totalUs_);
+
+    auto stats = c.rpcStats();
+    auto it = stats.find({"getNeighbors", storaged});
+    ASSERT_NE(it, stats.end());
+    EXPECT_GT(it->second.calls_, 0);
+    EXPECT_EQ(it->second.totalUs_.count(), it->second.calls_);
+    EXPECT_GT(it->second.bytesIn_, 0);
+    // The writes of the bulk writer
+    EXPECT_NE(stats.find({"addVertices", storaged}), stats.end());
+  }
+
+  static void runConcurrentKV(nebula::StorageClient &c) {
+    std::vector<nebula::KeyValue> kvs;
+    for (int i = 0; i < 64; ++i) {
+      kvs.emplace_back(std::make_pair("ckv_key_" + std::to_string(i), std::to_string(i)));
+    }
+    ASSERT_TRUE(c.kvPut("storage_client_test", kvs).succeeded());
+
+    // The gets wait for the one slot of the host and may be merged, each
+    // still gets only its own keys
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([&c, t] {
+        std::vector<std::string> keys;
+        for (int i = t * 8; i < t * 8 + 8; ++i) {
+          keys.emplace_back("ckv_key_" + std::to_string(i));
+        }
+        if (t % 2 == 1) {
+          keys.emplace_back("ckv_not_exist");
+        }
+        auto got = c.kvGet("storage_client_test", keys);
+        EXPECT_EQ(got.succeeded(), t % 2 == 0);
+        for (const auto &failedPart : got.failedParts_) {
+          EXPECT_EQ(failedPart.second,
+                    static_cast<int32_t>(nebula::cpp2::ErrorCode::E_PARTIAL_RESULT));
+        }
+        for (const auto &kv : got.data_) {
+          auto i = std::stoi(kv.second);
+          EXPECT_GE(i, t * 8);
+          EXPECT_LT(i, t * 8 + 8);
+        }
+        if (t % 2 == 0) {
+          EXPECT_EQ(got.data_.size(), 8U);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto stats = c.hostLimiterStats();
+    LOG(INFO) << "queued " << stats.queued_ << ", merged " << stats.merged_;
+
+    std::vector<std::string> keys;
+    for (const auto &kv : kvs) {
+      keys.emplace_back(kv.first);
+    }
+    EXPECT_TRUE(c.kvRemove("storage_client_test", keys).succeeded());
+  }
+
+  static void runTraversal(nebula::StorageClient &c) {
+    using Hops = std::vector<std::vector<nebula::Value>>;
+    LOG(INFO) << "out edges hop by hop";
+    {
+      nebula::TraversalConfig config;
+      config.maxHops_ = 3;
+      // One vid a batch, so the hops overlap
+      config.batchSize_ = 1;
+      config.concurrency_ = 4;
+      nebula::Traversal traversal(&c, config);
+      auto result = traversal.expand("storage_client_test", {"101"}, {"like"});
+      ASSERT_TRUE(result.succeeded());
+      EXPECT_EQ(result.data_, (Hops{{"101"}, {"102"}, {"103"}, {"201"}}));
+    }
+    LOG(INFO) << "in edges";
+    {
+      nebula::TraversalConfig config;
+      config.maxHops_ = 2;
+      nebula::Traversal traversal(&c, config);
+      auto result = traversal.expand(
+          "storage_client_test", {"103"}, {"like"}, nebula::EdgeDirection::kIn);
+      ASSERT_TRUE(result.succeeded());
+      EXPECT_EQ(result.data_, (Hops{{"103"}, {"102"}, {"101"}}));
+    }
+    LOG(INFO) << "all edges with limits";
+    {
+      nebula::Traversal traversal(&c);
+      // The player liked and the teams served by the bulk writer
+      auto all = traversal.expand("storage_client_test", {"101"}, {});
+      ASSERT_TRUE(all.succeeded());
+      ASSERT_EQ(all.data_.size(), 2U);
+      EXPECT_EQ(all.data_[1].size(), 101U);
+
+      nebula::TraversalConfig config;
+      config.maxDegree_ = 10;
+      auto degree = nebula::Traversal(&c, config).expand("storage_client_test", {"101"}, {});
+      ASSERT_TRUE(degree.succeeded());
+      EXPECT_EQ(degree.data_[1].size(), 10U);
+
+      config.maxDegree_ = 0;
+      config.maxHops_ = 7;
+      config.maxVertices_ = 3;
+      auto vertices =
+          nebula::Traversal(&c, config).expand("storage_client_test", {"101"}, {"like"});
+      EXPECT_EQ(vertices.data_, (Hops{{"101"}, {"102"}, {"103"}, {}, {}, {}, {}, {}}));
+    }
+    LOG(INFO) << "bad request";
+    {
+      nebula::Traversal traversal(&c);
+      EXPECT_FALSE(traversal.expand("not_exist", {"101"}, {"like"}).ok_);
+      EXPECT_FALSE(traversal.expand("storage_client_test", {"101"}, {"not_exist"}).ok_);
+      EXPECT_FALSE(traversal.expand("storage_client_test", {1}, {"like"}).ok_);
+    }
+  }
+
+  static void runScanEdgeWithRetry(nebula::StorageClient &c) {
+    nebula::DataSet expected({"like.likeness"});
+    expected.emplace_back(nebula::List({78}));
+    expected.emplace_back(nebula::List({99}));
+    expected.emplace_back(nebula::List({43}));
+    expected.emplace_back(nebula::List({56}));
+    expected.emplace_back(nebula::List({-13}));
+    expected.emplace_back(nebula::List({431}));
+    expected.emplace_back(nebula::List({457}));
+
+    auto *m = c.getMetaClient();
+    auto spaceId = m->getSpaceIdByNameFromCache("storage_client_test");
+    ASSERT_TRUE(spaceId.first);
+    // The stale leader fails the request, the right one is loaded from meta
+    m->updateLeader(spaceId.second, 1, nebula::HostAddr(kServerHost, 9999));
+    auto retries = c.scanRetries();
+
+    auto scanIter = c.scanEdgeWithPart(
+        "storage_client_test", 1, "like", std::vector<std::string>{"likeness"}, 3);
+    nebula::DataSet got;
+    while (scanIter.hasNext()) {
+      nebula::DataSet ds = scanIter.next();
+      got.append(std::move(ds));
+    }
+    EXPECT_FALSE(scanIter.failed_);
+    EXPECT_EQ(scanIter.retries_, 1);
+    EXPECT_EQ(c.scanRetries(), retries + 1);
+    EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+
+    auto leader = m->getPartLeaderFromCache(spaceId.second, 1);
+    ASSERT_TRUE(leader.first);
+    EXPECT_EQ(leader.second, nebula::HostAddr(kServerHost, 9779));
+  }
+
+  static void runScanWithCheckpoint(nebula::StorageClient &c) {
+    nebula::DataSet expected({"like.likeness"});
+    expected.emplace_back(nebula::List({78}));
+    expected.emplace_back(nebula::List({99}));
+    expected.emplace_back(nebula::List({43}));
+    expected.emplace_back(nebula::List({56}));
+    expected.emplace_back(nebula::List({-13}));
+    expected.emplace_back(nebula::List({431}));
+    expected.emplace_back(nebula::List({457}));
+
+    std::string path = "/tmp/storage_client_test_checkpoint.json";
+    nebula::ScanCheckpoint checkpoint;
+    checkpoint.spaceName_ = "storage_client_test";
+    checkpoint.edgeName_ = "like";
+    checkpoint.propNames_ = {"likeness"};
+    checkpoint.limit_ = 3;
+
+    nebula::DataSet got;
+    LOG(INFO) << "run to the first page";
+    {
+      auto ok = c.scanWithCheckpoint(
+          &checkpoint, path, [&](nebula::PartitionID, nebula::DataSet &&ds) {
+            got.append(std::move(ds));
+            return false;
+          });
+      EXPECT_TRUE(ok);
+      EXPECT_EQ(checkpoint.rows_, 3);
+      EXPECT_EQ(checkpoint.cursors_.size(), 1U);
+      EXPECT_TRUE(checkpoint.finished_.empty());
+    }
+    LOG(INFO) << "resume from the saved checkpoint";
+    {
+      auto loaded = nebula::ScanCheckpoint::load(path);
+      ASSERT_TRUE(loaded.first);
+      EXPECT_EQ(loaded.second.cursors_, checkpoint.cursors_);
+      auto ok = c.scanWithCheckpoint(
+          &loaded.second, path, [&](nebula::PartitionID, nebula::DataSet &&ds) {
+            got.append(std::move(ds));
+            return true;
+          });
+      EXPECT_TRUE(ok);
+      EXPECT_EQ(loaded.second.rows_, 7);
+      EXPECT_TRUE(loaded.second.cursors_.empty());
+      EXPECT_EQ(loaded.second.finished_, (std::set<nebula::PartitionID>{1}));
+      EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    }
+    ::unlink(path.c_str());
+  }
+
+  static void runScanEdge(nebula::StorageClient &c) {
+    nebula::DataSet expected({"like.likeness"});
+    expected.emplace_back(nebula::List({78}));
+    expected.emplace_back(nebula::List({99}));
+    expected.emplace_back(nebula::List({43}));
+    expected.emplace_back(nebula::List({56}));
+    expected.emplace_back(nebula::List({-13}));
+    expected.emplace_back(nebula::List({431}));
+    expected.emplace_back(nebula::List({457}));
+
+    LOG(INFO) << "run with callback";
+    {
+      std::mutex lock;
+      nebula::DataSet got;
+      int scanNum = 0;
+      auto ok = c.scanEdge("storage_client_test",
+                           "like",
+                           std::vector<std::string>{"likeness"},
+                           [&](nebula::PartitionID partId, nebula::DataSet &&ds) {
+                             EXPECT_EQ(partId, 1);
+                             std::lock_guard<std::mutex> guard(lock);
+                             got.append(std::move(ds));
+                             ++scanNum;
+                             return true;
+                           },
+                           3);
+      EXPECT_TRUE(ok);
+      EXPECT_EQ(scanNum, 3);
+      EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    }
+    LOG(INFO) << "run with stopped callback";
+    {
+      int scanNum = 0;
+      auto ok = c.scanEdge("storage_client_test",
+                           "like",
+                           std::vector<std::string>{"likeness"},
+                           [&](nebula::PartitionID, nebula::DataSet &&) {
+                             ++scanNum;
+                             return false;
+                           },
+                           3);
+      EXPECT_TRUE(ok);
+      EXPECT_EQ(scanNum, 1);
+    }
+    LOG(INFO) << "run with iterator";
+    {
+      auto iter = c.scanEdge("storage_client_test", "like", std::vector<std::string>{"likeness"}, 3);
+      nebula::DataSet got;
+      nebula::DataSet ds;
+      nebula::PartitionID partId = 0;
+      while (iter->next(&ds, &partId)) {
+        EXPECT_EQ(partId, 1);
+        got.append(std::move(ds));
+      }
+      EXPECT_TRUE(iter->succeeded());
+      EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    }
+    LOG(INFO) << "run with non-existent edge";
+    {
+      auto ok = c.scanEdge("storage_client_test",
+                           "not_exist",
+                           std::vector<std::string>{"likeness"},
+                           [](nebula::PartitionID, nebula::DataSet &&) { return true; });
+      EXPECT_FALSE(ok);
+    }
+  }
+
+  static void runScanVertex(nebula::StorageClient &c) {
+    nebula::DataSet expected({"player.name", "player.age"});
+    expected.emplace_back(nebula::List({"Tim", 42}));
+    expected.emplace_back(nebula::List({"Tony", 36}));
+    expected.emplace_back(nebula::List({"Manu", 41}));
+
+    LOG(INFO) << "run with part";
+    {
+      auto scanIter = c.scanVertexWithPart(
+          "storage_client_test", 1, nebula::TagProps{{"player", {"name", "age"}}}, 2);
+      nebula::DataSet got;
+      int scanNum = 0;
+      while (scanIter.hasNext()) {
+        nebula::DataSet ds = scanIter.next();
+        got.append(std::move(ds));
+        ++scanNum;
+      }
+      EXPECT_FALSE(scanIter.failed_);
+      EXPECT_EQ(scanNum, 2);
+      EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    }
+    LOG(INFO) << "run with iterator";
+    {
+      auto iter = c.scanVertex("storage_client_test", nebula::TagProps{{"player", {"name", "age"}}});
+      nebula::DataSet got;
+      nebula::DataSet ds;
+      while (iter->next(&ds)) {
+        got.append(std::move(ds));
+      }
+      EXPECT_TRUE(iter->succeeded());
+      EXPECT_TRUE(verifyResultWithoutOrder(got, expected));
+    }
+    LOG(INFO) << "run with non-existent tag";
+    {
+      auto scanIter =
+          c.scanVertexWithPart("storage_client_test", 1, nebula::TagProps{{"not_exist", {}}});
+      EXPECT_FALSE(scanIter.hasNext());
+    }
+  }
 };
 
 TEST_F(StorageClientTest, Basic) {
@@ -141,6 +883,76 @@ TEST_F(StorageClientTest, Basic) {
   runGetParts(c);
   LOG(INFO) << "Testing run scan edge with part.";
   runScanEdgeWithPart(c);
+  LOG(INFO) << "Testing run scan edge of the whole space.";
+  runScanEdge(c);
+  LOG(INFO) << "Testing run scan vertex.";
+  runScanVertex(c);
+  LOG(INFO) << "Testing run scan with filter.";
+  runScanWithFilter(c);
+  LOG(INFO) << "Testing run get neighbors.";
+  runGetNeighbors(c);
+  LOG(INFO) << "Testing run get props.";
+  runGetProps(c);
+  LOG(INFO) << "Testing run bulk writer.";
+  runBulkWriter(c);
+  LOG(INFO) << "Testing run KV.";
+  runKV(c);
+  LOG(INFO) << "Testing run lookup index.";
+  runLookupIndex(c);
+  LOG(INFO) << "Testing run RPC stats.";
+  runRpcStats(c);
+  LOG(INFO) << "Testing run traversal.";
+  runTraversal(c);
+  LOG(INFO) << "Testing run scan edge with a stale leader.";
+  runScanEdgeWithRetry(c);
+  LOG(INFO) << "Testing run scan with checkpoint.";
+  runScanWithCheckpoint(c);
+
+  nebula::SConfig sConfig;
+  sConfig.scanPrefetchDepth_ = 2;
+  sConfig.scanPartsPerRequest_ = 8;
+  sConfig.kvBatchSize_ = 16;
+  nebula::StorageClient batchClient({kServerHost ":9559"}, nebula::MConfig{}, sConfig);
+  LOG(INFO) << "Testing run scan edge with prefetch.";
+  runScanEdgeWithPrefetch(batchClient);
+  LOG(INFO) << "Testing run scan edge of the whole space with multi-part requests.";
+  runScanEdge(batchClient);
+  LOG(INFO) << "Testing run KV in batches.";
+  runKV(batchClient);
+
+  nebula::SConfig adaptiveConfig;
+  adaptiveConfig.scanTargetPageBytes_ = 8;
+  adaptiveConfig.scanInitialPageSize_ = 2;
+  adaptiveConfig.scanMinPageSize_ = 1;
+  nebula::StorageClient adaptiveClient({kServerHost ":9559"}, nebula::MConfig{}, adaptiveConfig);
+  LOG(INFO) << "Testing run scan edge with adaptive page size.";
+  runScanEdgeWithAdaptivePageSize(adaptiveClient);
+
+  nebula::SConfig limitConfig;
+  limitConfig.maxInflightPerHost_ = 1;
+  limitConfig.targetLatencyMs_ = 1000;
+  nebula::StorageClient limitClient({kServerHost ":9559"}, nebula::MConfig{}, limitConfig);
+  LOG(INFO) << "Testing run get props with a limit of each host.";
+  runGetProps(limitClient);
+  LOG(INFO) << "Testing run KV with a limit of each host.";
+  runKV(limitClient);
+  LOG(INFO) << "Testing run concurrent KV with a limit of each host.";
+  runConcurrentKV(limitClient);
+
+  nebula::RuntimeConfig runtimeConfig;
+  runtimeConfig.ioThreads_ = 2;
+  runtimeConfig.cpuThreads_ = 4;
+  auto runtime = std::make_shared<nebula::ClientRuntime>(runtimeConfig);
+  nebula::SConfig sharedConfig;
+  sharedConfig.runtime_ = runtime;
+  nebula::StorageClient sharedClient({kServerHost ":9559"}, nebula::MConfig{}, sharedConfig);
+  nebula::StorageClient otherClient({kServerHost ":9559"}, nebula::MConfig{}, sharedConfig);
+  EXPECT_EQ(sharedClient.runtime(), runtime);
+  EXPECT_EQ(otherClient.runtime(), runtime);
+  LOG(INFO) << "Testing run scan edge of the whole space on a shared runtime.";
+  runScanEdge(sharedClient);
+  LOG(INFO) << "Testing run traversal on a shared runtime.";
+  runTraversal(otherClient);
 }
 
 int main(int argc, char **argv) {
@@ -90,6 +90,9 @@ std::shared_ptr<ClientType> ThriftClientManager<ClientType>::client(const HostAd
   std::shared_ptr<ClientType> client(
       new ClientType(std::move(headerClientChannel)),
       [evb](auto* p) { evb->runImmediatelyOrRunInEventBaseThreadAndWait([p] { delete p; }); });
+  if (eventHandler_ != nullptr) {
+    client->addEventHandler(eventHandler_);
+  }
   clientMap_->emplace(std::make_pair(host, evb), client);
   return client;
 }
@@ -7,6 +7,7 @@
 
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/EventBaseManager.h>
+#include <thrift/lib/cpp/TProcessorEventHandler.h>
 
 #include "common/datatypes/HostAddr.h"
 
@@ -25,8 +26,16 @@ class ThriftClientManager final {
     VLOG(3) << "~ThriftClientManager";
   }
 
-  explicit ThriftClientManager(int32_t connTimeoutInMs, bool enableSSL, const std::string& CAPath)
-      : connTimeoutInMs_(connTimeoutInMs), enableSSL_(enableSSL), CAPath_(CAPath) {
+  // eventHandler is added to each client made, if not nullptr
+  explicit ThriftClientManager(
+      int32_t connTimeoutInMs,
+      bool enableSSL,
+      const std::string& CAPath,
+      std::shared_ptr<apache::thrift::TProcessorEventHandler> eventHandler = nullptr)
+      : connTimeoutInMs_(connTimeoutInMs),
+        enableSSL_(enableSSL),
+        CAPath_(CAPath),
+        eventHandler_(std::move(eventHandler)) {
     VLOG(3) << "ThriftClientManager";
   }
 
@@ -39,6 +48,7 @@ class ThriftClientManager final {
   // whether enable ssl
   bool enableSSL_;
   std::string CAPath_;
+  std::shared_ptr<apache::thrift::TProcessorEventHandler> eventHandler_;
 };
 
 }  // namespace thrift
@@ -0,0 +1,256 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "Exporter.h"
+
+#include <folly/String.h>
+#include <glog/logging.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "nebula/sclient/ScanSink.h"
+
+namespace nebula {
+namespace tools {
+
+namespace {
+
+int64_t nowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool makeDirs(const std::string& path) {
+  for (auto pos = path.find('/', 1);; pos = path.find('/', pos + 1)) {
+    auto dir = path.substr(0, pos);
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+      LOG(ERROR) << "Create directory " << dir << " failed: " << std::strerror(errno);
+      return false;
+    }
+    if (pos == std::string::npos) {
+      return true;
+    }
+  }
+}
+
+bool selected(const std::vector<std::string>& names, const std::string& name) {
+  return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+}  // namespace
+
+Exporter::Exporter(StorageClient* client, ExportOptions options)
+    : client_(client), options_(std::move(options)), formatter_(options_.format_) {}
+
+bool Exporter::run() {
+  auto spaceRet = client_->getMetaClient()->getSpaceIdByNameFromCache(options_.spaceName_);
+  if (!spaceRet.first) {
+    return false;
+  }
+  TagProps edges;
+  TagProps tags;
+  if (!loadSchemas(spaceRet.second, &edges, &tags)) {
+    return false;
+  }
+
+  startMs_ = lastReportMs_ = nowMs();
+  std::mutex lock;
+  std::condition_variable cv;
+  std::string current;
+  bool done = false;
+  std::thread reporter([&]() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (!cv.wait_for(guard, std::chrono::milliseconds(options_.progressIntervalMs_), [&] {
+      return done;
+    })) {
+      reportProgress(current, false);
+    }
+  });
+  auto setCurrent = [&](std::string what) {
+    std::lock_guard<std::mutex> guard(lock);
+    current = std::move(what);
+  };
+
+  bool ok = true;
+  for (const auto& edge : edges) {
+    setCurrent("edge " + edge.first);
+    ok = exportOne("edge", edge.first, edge.second) && ok;
+  }
+  for (const auto& tag : tags) {
+    setCurrent("tag " + tag.first);
+    ok = exportOne("tag", tag.first, tag.second) && ok;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    done = true;
+  }
+  cv.notify_all();
+  reporter.join();
+  reportProgress(options_.spaceName_, true);
+  return ok;
+}
+
+bool Exporter::loadSchemas(GraphSpaceID spaceId, TagProps* edges, TagProps* tags) {
+  auto* mClient = client_->getMetaClient();
+  bool all = options_.edges_.empty() && options_.tags_.empty();
+
+  auto edgesRet = mClient->getEdgeSchemasFromCache(spaceId);
+  if (!edgesRet.first) {
+    LOG(ERROR) << "List edge schemas of " << options_.spaceName_ << " failed";
+    return false;
+  }
+  for (const auto& schema : edgesRet.second) {
+    if (!all && !selected(options_.edges_, schema.name_)) {
+      continue;
+    }
+    std::vector<std::string> props{"_src", "_type", "_rank", "_dst"};
+    props.insert(props.end(), schema.props_.begin(), schema.props_.end());
+    edges->emplace_back(schema.name_, std::move(props));
+  }
+
+  auto tagsRet = mClient->getTagSchemasFromCache(spaceId);
+  if (!tagsRet.first) {
+    LOG(ERROR) << "List tag schemas of " << options_.spaceName_ << " failed";
+    return false;
+  }
+  for (const auto& schema : tagsRet.second) {
+    if (!all && !selected(options_.tags_, schema.name_)) {
+      continue;
+    }
+    std::vector<std::string> props{"_vid"};
+    props.insert(props.end(), schema.props_.begin(), schema.props_.end());
+    tags->emplace_back(schema.name_, std::move(props));
+  }
+
+  if (!all && (edges->size() != options_.edges_.size() || tags->size() != options_.tags_.size())) {
+    LOG(ERROR) << "Some edges or tags are not found in " << options_.spaceName_;
+    return false;
+  }
+  return true;
+}
+
+bool Exporter::exportOne(const std::string& kind,
+                         const std::string& name,
+                         const std::vector<std::string>& props) {
+  auto dir = folly::stringPrintf(
+      "%s/%s/%s", options_.outputDir_.c_str(), kind.c_str(), name.c_str());
+  if (!makeDirs(dir)) {
+    return false;
+  }
+  files_.clear();
+  failed_ = false;
+  auto rows = rows_.load();
+  auto bytes = bytes_.load();
+
+  ScanSink sink(
+      [this, &dir](PartitionID partId, DataSet&& page) {
+        return writePage(dir, partId, std::move(page));
+      },
+      options_.formatThreads_,
+      options_.maxInflightPages_);
+  bool ok = false;
+  if (kind == "edge") {
+    ok = client_->scanEdge(options_.spaceName_, name, props, sink.callback(), options_.pageSize_);
+  } else {
+    ok = client_->scanVertex(
+        options_.spaceName_, TagProps{{name, props}}, sink.callback(), options_.pageSize_);
+  }
+  ok = sink.finish() && ok;
+
+  for (auto& file : files_) {
+    if (file.second->writer != nullptr) {
+      ok = file.second->writer->close() && ok;
+    }
+  }
+  ok = ok && !failed_;
+  if (!ok) {
+    LOG(ERROR) << "Export " << kind << " " << name << " failed";
+  }
+  std::cout << folly::stringPrintf("Exported %s %s: %ld rows, %ld bytes, %zu files in %s\n",
+                                   kind.c_str(),
+                                   name.c_str(),
+                                   rows_.load() - rows,
+                                   bytes_.load() - bytes,
+                                   files_.size(),
+                                   dir.c_str())
+            << std::flush;
+  files_.clear();
+  return ok;
+}
+
+bool Exporter::writePage(const std::string& dir, PartitionID partId, DataSet&& page) {
+  if (partId == kMixedParts) {
+    LOG(ERROR) << "The page mixes several partitions, set scanPartsPerRequest_ to 1";
+    failed_ = true;
+    return false;
+  }
+  std::string text;
+  formatter_.format(page, &text);
+
+  PartFile* file = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(filesLock_);
+    auto& slot = files_[partId];
+    if (slot == nullptr) {
+      slot = std::make_unique<PartFile>();
+    }
+    file = slot.get();
+  }
+
+  std::lock_guard<std::mutex> guard(file->lock);
+  if (file->writer == nullptr) {
+    auto path = folly::stringPrintf(
+        "%s/part-%d.%s", dir.c_str(), partId, exportFormatExtension(options_.format_));
+    auto writer = std::make_unique<FileWriter>(path, options_.bufferSize_, options_.directIO_);
+    auto header = formatter_.header(page.colNames);
+    if (!writer->open() || !writer->append(header)) {
+      failed_ = true;
+      return false;
+    }
+    bytes_ += header.size();
+    file->writer = std::move(writer);
+  }
+  if (!file->writer->append(text)) {
+    failed_ = true;
+    return false;
+  }
+  rows_ += page.rowSize();
+  bytes_ += text.size();
+  return true;
+}
+
+void Exporter::reportProgress(const std::string& what, bool final) {
+  auto now = nowMs();
+  int64_t rows = rows_;
+  int64_t bytes = bytes_;
+  auto sinceMs = final ? startMs_ : lastReportMs_;
+  auto seconds = std::max<int64_t>(now - sinceMs, 1) / 1000.0;
+  auto deltaRows = final ? rows : rows - lastReportRows_;
+  auto deltaBytes = final ? bytes : bytes - lastReportBytes_;
+  std::cout << folly::stringPrintf("[%s] %s%ld rows, %.1f MB, %.0f rows/s, %.1f MB/s, %.1fs\n",
+                                   what.c_str(),
+                                   final ? "total " : "",
+                                   rows,
+                                   bytes / 1048576.0,
+                                   deltaRows / seconds,
+                                   deltaBytes / 1048576.0 / seconds,
+                                   (now - startMs_) / 1000.0)
+            << std::flush;
+  lastReportMs_ = now;
+  lastReportRows_ = rows;
+  lastReportBytes_ = bytes;
+}
+
+}  // namespace tools
+}  // namespace nebula
@@ -0,0 +1,102 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FileWriter.h"
+#include "RowFormatter.h"
+#include "common/thrift/ThriftTypes.h"
+#include "nebula/sclient/StorageClient.h"
+
+namespace nebula {
+namespace tools {
+
+struct ExportOptions {
+  std::string spaceName_;
+  // Export all edges and tags of the space if both are empty
+  std::vector<std::string> edges_;
+  std::vector<std::string> tags_;
+  std::string outputDir_{"./export"};
+  ExportFormat format_{ExportFormat::CSV};
+  // Rows of a scan page
+  int64_t pageSize_{10000};
+  std::size_t formatThreads_{4};
+  // Pages queued or being formatted
+  std::size_t maxInflightPages_{64};
+  std::size_t bufferSize_{4 << 20};
+  bool directIO_{false};
+  int32_t progressIntervalMs_{1000};
+};
+
+// Dump the edges and vertices of a space to one file per partition,
+// <outputDir>/<edge|tag>/<name>/part-<id>.<csv|json>. The partitions are
+// scanned in parallel by StorageClient, the pages are formatted on a pool of
+// threads and appended to the files. The progress is printed every
+// progressIntervalMs_.
+class Exporter {
+ public:
+  // scanPartsPerRequest_ of the client's SConfig must be 1, so that every
+  // page belongs to one partition
+  Exporter(StorageClient* client, ExportOptions options);
+
+  // false if any edge or tag failed
+  bool run();
+
+  int64_t rows() const {
+    return rows_;
+  }
+
+  int64_t bytes() const {
+    return bytes_;
+  }
+
+ private:
+  struct PartFile {
+    std::mutex lock;
+    std::unique_ptr<FileWriter> writer;
+  };
+
+  // Resolve the names and the properties to export, false on failure
+  bool loadSchemas(GraphSpaceID spaceId, TagProps* edges, TagProps* tags);
+
+  bool exportOne(const std::string& kind,
+                 const std::string& name,
+                 const std::vector<std::string>& props);
+
+  // Format page and append it to the file of partId, which is created on the
+  // first page
+  bool writePage(const std::string& dir, PartitionID partId, DataSet&& page);
+
+  // Print the rows and bytes written and the throughput since the last
+  // report, or since the start if final
+  void reportProgress(const std::string& what, bool final);
+
+  StorageClient* client_;
+  ExportOptions options_;
+  RowFormatter formatter_;
+
+  std::mutex filesLock_;
+  std::unordered_map<PartitionID, std::unique_ptr<PartFile>> files_;
+  std::atomic<bool> failed_{false};
+
+  std::atomic<int64_t> rows_{0};
+  std::atomic<int64_t> bytes_{0};
+  int64_t startMs_{0};
+  int64_t lastReportMs_{0};
+  int64_t lastReportRows_{0};
+  int64_t lastReportBytes_{0};
+};
+
+}  // namespace tools
+}  // namespace nebula
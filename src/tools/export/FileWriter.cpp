@@ -0,0 +1,135 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "FileWriter.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace nebula {
+namespace tools {
+
+FileWriter::FileWriter(std::string path, std::size_t bufferSize, bool directIO)
+    : path_(std::move(path)),
+      capacity_(std::max(bufferSize / kAlignment, std::size_t(1)) * kAlignment),
+      directIO_(directIO) {}
+
+FileWriter::~FileWriter() {
+  close();
+}
+
+bool FileWriter::open() {
+  int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  if (directIO_) {
+    fd_ = ::open(path_.c_str(), flags | O_DIRECT, 0644);
+    if (fd_ < 0 && errno == EINVAL) {
+      LOG(WARNING) << "O_DIRECT is not supported for " << path_ << ", use buffered writes";
+      directIO_ = false;
+    }
+  }
+  if (fd_ < 0) {
+    fd_ = ::open(path_.c_str(), flags, 0644);
+  }
+  if (fd_ < 0) {
+    LOG(ERROR) << "Open " << path_ << " failed: " << std::strerror(errno);
+    return false;
+  }
+  void* buffer = nullptr;
+  if (::posix_memalign(&buffer, kAlignment, capacity_) != 0) {
+    LOG(ERROR) << "Allocate " << capacity_ << " bytes for " << path_ << " failed";
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  buffer_ = static_cast<char*>(buffer);
+  size_ = 0;
+  bytes_ = 0;
+  return true;
+}
+
+bool FileWriter::append(folly::StringPiece data) {
+  if (fd_ < 0) {
+    return false;
+  }
+  bytes_ += data.size();
+  while (!data.empty()) {
+    auto n = std::min(data.size(), capacity_ - size_);
+    std::memcpy(buffer_ + size_, data.data(), n);
+    size_ += n;
+    data.advance(n);
+    if (size_ == capacity_ && !flush(false)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FileWriter::close() {
+  if (fd_ < 0) {
+    return true;
+  }
+  auto ok = flush(true);
+  if (::close(fd_) != 0) {
+    LOG(ERROR) << "Close " << path_ << " failed: " << std::strerror(errno);
+    ok = false;
+  }
+  fd_ = -1;
+  std::free(buffer_);
+  buffer_ = nullptr;
+  return ok;
+}
+
+bool FileWriter::flush(bool all) {
+  auto n = size_;
+  if (directIO_) {
+    n = size_ / kAlignment * kAlignment;
+  }
+  if (n > 0 && !writeFully(buffer_, n)) {
+    return false;
+  }
+  if (n < size_) {
+    std::memmove(buffer_, buffer_ + n, size_ - n);
+  }
+  size_ -= n;
+  if (all && size_ > 0) {
+    // The tail is shorter than a block, O_DIRECT can't write it
+    if (::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT) != 0) {
+      LOG(ERROR) << "Clear O_DIRECT of " << path_ << " failed: " << std::strerror(errno);
+      return false;
+    }
+    directIO_ = false;
+    if (!writeFully(buffer_, size_)) {
+      return false;
+    }
+    size_ = 0;
+  }
+  return true;
+}
+
+bool FileWriter::writeFully(const char* data, std::size_t size) {
+  while (size > 0) {
+    auto n = ::write(fd_, data, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "Write " << path_ << " failed: " << std::strerror(errno);
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+}  // namespace tools
+}  // namespace nebula
@@ -0,0 +1,65 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+
+#include <cstddef>
+#include <string>
+
+namespace nebula {
+namespace tools {
+
+// Append to a file through a large buffer. With directIO the file is opened
+// with O_DIRECT and written in whole aligned blocks, which keeps a big export
+// out of the page cache. Falls back to buffered writes if the filesystem
+// refuses O_DIRECT. Not thread safe.
+class FileWriter {
+ public:
+  static constexpr std::size_t kAlignment = 4096;
+
+  FileWriter(std::string path, std::size_t bufferSize, bool directIO);
+
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  // Same as close()
+  ~FileWriter();
+
+  // Create or truncate the file
+  bool open();
+
+  bool append(folly::StringPiece data);
+
+  // Write the rest of the buffer and close the file
+  bool close();
+
+  // Bytes appended so far
+  std::size_t bytes() const {
+    return bytes_;
+  }
+
+  const std::string& path() const {
+    return path_;
+  }
+
+ private:
+  // Write the buffer out, but keep the unaligned tail for O_DIRECT unless all
+  bool flush(bool all);
+
+  bool writeFully(const char* data, std::size_t size);
+
+  std::string path_;
+  std::size_t capacity_;
+  bool directIO_;
+  int fd_{-1};
+  char* buffer_{nullptr};
+  std::size_t size_{0};
+  std::size_t bytes_{0};
+};
+
+}  // namespace tools
+}  // namespace nebula
@@ -0,0 +1,88 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+#include <nebula/sclient/StorageClient.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Exporter.h"
+
+// Dump the edges and vertices of a space to CSV or NDJSON files, one per
+// partition. The throughput is printed as it goes, so it's also a benchmark
+// of the whole space scan.
+//
+//   nebula-export --meta_server_addrs=127.0.0.1:9559 --space=nba --output=/data/nba
+
+DEFINE_string(meta_server_addrs, "127.0.0.1:9559", "Comma separated meta server addresses.");
+DEFINE_string(space, "", "Space to export.");
+DEFINE_string(edges, "", "Comma separated edges to export, all if both edges and tags are empty.");
+DEFINE_string(tags, "", "Comma separated tags to export, all if both edges and tags are empty.");
+DEFINE_string(output, "./export", "Output directory.");
+DEFINE_string(format, "csv", "Output format, csv or ndjson.");
+DEFINE_int64(page_size, 10000, "Rows of a scan page.");
+DEFINE_int32(scan_concurrency, 16, "Partitions scanned at the same time.");
+DEFINE_int32(scan_concurrency_per_host, 4, "Partitions scanned at the same time on one host.");
+DEFINE_int32(format_threads, 4, "Threads formatting the rows.");
+DEFINE_int64(buffer_size, 4 << 20, "Write buffer of each output file in bytes.");
+DEFINE_bool(direct_io, false, "Write the output files with O_DIRECT.");
+DEFINE_int32(progress_interval_ms, 1000, "Print the progress at this interval.");
+DEFINE_bool(enable_ssl, false, "Enable SSL.");
+DEFINE_string(ca_path, "", "CA file of SSL.");
+
+namespace {
+
+std::vector<std::string> splitNames(const std::string& names) {
+  std::vector<std::string> result;
+  folly::split(',', names, result, true);
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_WARNING);
+
+  nebula::tools::ExportOptions options;
+  if (FLAGS_space.empty()) {
+    LOG(ERROR) << "--space is required";
+    return 1;
+  }
+  if (!nebula::tools::parseExportFormat(FLAGS_format, &options.format_)) {
+    LOG(ERROR) << "Unknown format " << FLAGS_format;
+    return 1;
+  }
+  options.spaceName_ = FLAGS_space;
+  options.edges_ = splitNames(FLAGS_edges);
+  options.tags_ = splitNames(FLAGS_tags);
+  options.outputDir_ = FLAGS_output;
+  options.pageSize_ = FLAGS_page_size;
+  options.formatThreads_ = std::max(FLAGS_format_threads, 1);
+  options.maxInflightPages_ = options.formatThreads_ * 4;
+  options.bufferSize_ = FLAGS_buffer_size;
+  options.directIO_ = FLAGS_direct_io;
+  options.progressIntervalMs_ = FLAGS_progress_interval_ms;
+
+  nebula::MConfig mConfig;
+  mConfig.enableSSL_ = FLAGS_enable_ssl;
+  mConfig.CAPath_ = FLAGS_ca_path;
+  nebula::SConfig sConfig;
+  sConfig.enableSSL_ = FLAGS_enable_ssl;
+  sConfig.CAPath_ = FLAGS_ca_path;
+  sConfig.scanConcurrency_ = FLAGS_scan_concurrency;
+  sConfig.scanConcurrencyPerHost_ = FLAGS_scan_concurrency_per_host;
+  // Every page must belong to one partition to be written to its file
+  sConfig.scanPartsPerRequest_ = 1;
+
+  nebula::StorageClient client(splitNames(FLAGS_meta_server_addrs), mConfig, sConfig);
+  nebula::tools::Exporter exporter(&client, std::move(options));
+  return exporter.run() ? 0 : 1;
+}
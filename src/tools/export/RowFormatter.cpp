@@ -0,0 +1,131 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "RowFormatter.h"
+
+#include <folly/Conv.h>
+#include <folly/json.h>
+
+#include <cmath>
+
+namespace nebula {
+namespace tools {
+
+namespace {
+
+void appendCsvField(folly::StringPiece field, std::string* out) {
+  if (field.find_first_of(folly::StringPiece(",\"\r\n")) == folly::StringPiece::npos) {
+    out->append(field.data(), field.size());
+    return;
+  }
+  out->push_back('"');
+  for (auto c : field) {
+    if (c == '"') {
+      out->push_back('"');
+    }
+    out->push_back(c);
+  }
+  out->push_back('"');
+}
+
+void appendJsonString(folly::StringPiece str, std::string* out) {
+  static const folly::json::serialization_opts opts;
+  folly::json::escapeString(str, *out, opts);
+}
+
+}  // namespace
+
+bool parseExportFormat(const std::string& name, ExportFormat* format) {
+  if (name == "csv") {
+    *format = ExportFormat::CSV;
+    return true;
+  }
+  if (name == "ndjson") {
+    *format = ExportFormat::NDJSON;
+    return true;
+  }
+  return false;
+}
+
+const char* exportFormatExtension(ExportFormat format) {
+  return format == ExportFormat::CSV ? "csv" : "json";
+}
+
+std::string RowFormatter::header(const std::vector<std::string>& colNames) const {
+  std::string line;
+  if (format_ != ExportFormat::CSV) {
+    return line;
+  }
+  for (std::size_t i = 0; i < colNames.size(); ++i) {
+    if (i != 0) {
+      line.push_back(',');
+    }
+    appendCsvField(colNames[i], &line);
+  }
+  line.push_back('\n');
+  return line;
+}
+
+void RowFormatter::format(const DataSet& page, std::string* out) const {
+  for (const auto& row : page.rows) {
+    if (format_ == ExportFormat::CSV) {
+      for (std::size_t i = 0; i < row.values.size(); ++i) {
+        if (i != 0) {
+          out->push_back(',');
+        }
+        appendCsv(row.values[i], out);
+      }
+    } else {
+      out->push_back('{');
+      for (std::size_t i = 0; i < row.values.size() && i < page.colNames.size(); ++i) {
+        if (i != 0) {
+          out->push_back(',');
+        }
+        appendJsonString(page.colNames[i], out);
+        out->push_back(':');
+        appendJson(row.values[i], out);
+      }
+      out->push_back('}');
+    }
+    out->push_back('\n');
+  }
+}
+
+void RowFormatter::appendCsv(const Value& value, std::string* out) const {
+  if (value.isNull()) {
+    return;
+  }
+  if (value.isStr()) {
+    appendCsvField(value.getStr(), out);
+  } else if (value.isInt()) {
+    folly::toAppend(value.getInt(), out);
+  } else if (value.isFloat()) {
+    folly::toAppend(value.getFloat(), out);
+  } else if (value.isBool()) {
+    out->append(value.getBool() ? "true" : "false");
+  } else {
+    appendCsvField(value.toString(), out);
+  }
+}
+
+void RowFormatter::appendJson(const Value& value, std::string* out) const {
+  if (value.isNull()) {
+    out->append("null");
+  } else if (value.isStr()) {
+    appendJsonString(value.getStr(), out);
+  } else if (value.isInt()) {
+    folly::toAppend(value.getInt(), out);
+  } else if (value.isFloat() && std::isfinite(value.getFloat())) {
+    folly::toAppend(value.getFloat(), out);
+  } else if (value.isBool()) {
+    out->append(value.getBool() ? "true" : "false");
+  } else {
+    // Dates, lists, NaN and so on have no JSON counterpart, keep their text
+    appendJsonString(value.toString(), out);
+  }
+}
+
+}  // namespace tools
+}  // namespace nebula
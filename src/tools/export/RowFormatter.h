@@ -0,0 +1,50 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+namespace tools {
+
+enum class ExportFormat {
+  CSV,
+  NDJSON,
+};
+
+// Parse "csv" or "ndjson", false if unknown
+bool parseExportFormat(const std::string& name, ExportFormat* format);
+
+// The file extension of format, without the dot
+const char* exportFormatExtension(ExportFormat format);
+
+// Format the rows of the scanned pages to text lines. CSV quotes fields as
+// RFC 4180 and leaves null empty, NDJSON writes one object per row keyed by
+// the column names.
+class RowFormatter {
+ public:
+  explicit RowFormatter(ExportFormat format) : format_(format) {}
+
+  // The first line of a file, empty for NDJSON
+  std::string header(const std::vector<std::string>& colNames) const;
+
+  // Append the rows of page to out, one line each
+  void format(const DataSet& page, std::string* out) const;
+
+ private:
+  void appendCsv(const Value& value, std::string* out) const;
+
+  void appendJson(const Value& value, std::string* out) const;
+
+  ExportFormat format_;
+};
+
+}  // namespace tools
+}  // namespace nebula
@@ -0,0 +1,105 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <common/Init.h>
+#include <common/datatypes/DataSet.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../FileWriter.h"
+#include "../RowFormatter.h"
+
+namespace nebula {
+namespace tools {
+
+static DataSet makePage() {
+  DataSet page({"like._src", "like.likeness", "like.note"});
+  page.emplace_back(List({Value("Tim"), Value(90), Value("a,\"b\"")}));
+  page.emplace_back(List({Value("Tony"), Value(1.5), Value::kNullValue}));
+  page.emplace_back(List({Value("Manu"), Value(true), Value("line\nbreak")}));
+  return page;
+}
+
+static std::string readFile(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+TEST(ExportTest, ParseFormat) {
+  ExportFormat format;
+  EXPECT_TRUE(parseExportFormat("csv", &format));
+  EXPECT_EQ(format, ExportFormat::CSV);
+  EXPECT_TRUE(parseExportFormat("ndjson", &format));
+  EXPECT_EQ(format, ExportFormat::NDJSON);
+  EXPECT_FALSE(parseExportFormat("xml", &format));
+}
+
+TEST(ExportTest, Csv) {
+  RowFormatter formatter(ExportFormat::CSV);
+  auto page = makePage();
+  EXPECT_EQ(formatter.header(page.colNames), "like._src,like.likeness,like.note\n");
+  std::string out;
+  formatter.format(page, &out);
+  EXPECT_EQ(out,
+            "Tim,90,\"a,\"\"b\"\"\"\n"
+            "Tony,1.5,\n"
+            "Manu,true,\"line\nbreak\"\n");
+}
+
+TEST(ExportTest, Ndjson) {
+  RowFormatter formatter(ExportFormat::NDJSON);
+  auto page = makePage();
+  EXPECT_EQ(formatter.header(page.colNames), "");
+  std::string out;
+  formatter.format(page, &out);
+  EXPECT_EQ(out,
+            "{\"like._src\":\"Tim\",\"like.likeness\":90,\"like.note\":\"a,\\\"b\\\"\"}\n"
+            "{\"like._src\":\"Tony\",\"like.likeness\":1.5,\"like.note\":null}\n"
+            "{\"like._src\":\"Manu\",\"like.likeness\":true,\"like.note\":\"line\\nbreak\"}\n");
+}
+
+TEST(ExportTest, FileWriter) {
+  char tmpl[] = "/tmp/export_test.XXXXXX";
+  ASSERT_NE(::mkdtemp(tmpl), nullptr);
+  std::string dir = tmpl;
+
+  // Larger than the buffer and not a multiple of a block
+  std::string expected;
+  for (int i = 0; i < 3000; ++i) {
+    expected += "row " + std::to_string(i) + "\n";
+  }
+  for (bool directIO : {false, true}) {
+    auto path = dir + (directIO ? "/direct" : "/buffered");
+    FileWriter writer(path, FileWriter::kAlignment, directIO);
+    ASSERT_TRUE(writer.open());
+    for (std::size_t pos = 0; pos < expected.size(); pos += 1000) {
+      ASSERT_TRUE(writer.append(folly::StringPiece(expected).subpiece(pos, 1000)));
+    }
+    EXPECT_EQ(writer.bytes(), expected.size());
+    ASSERT_TRUE(writer.close());
+    EXPECT_EQ(readFile(path), expected);
+    ::unlink(path.c_str());
+  }
+  ::rmdir(dir.c_str());
+}
+
+}  // namespace tools
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  nebula::init(&argc, &argv);
+  google::SetStderrLogging(google::GLOG_INFO);
+
+  return RUN_ALL_TESTS();
+}